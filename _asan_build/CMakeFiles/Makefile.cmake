@@ -0,0 +1,124 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "googletest-src/CMakeLists.txt"
+  "googletest-src/googlemock/CMakeLists.txt"
+  "googletest-src/googlemock/cmake/gmock.pc.in"
+  "googletest-src/googlemock/cmake/gmock_main.pc.in"
+  "googletest-src/googletest/CMakeLists.txt"
+  "googletest-src/googletest/cmake/Config.cmake.in"
+  "googletest-src/googletest/cmake/gtest.pc.in"
+  "googletest-src/googletest/cmake/gtest_main.pc.in"
+  "googletest-src/googletest/cmake/internal_utils.cmake"
+  "/root/repo/build_support/gtest_CMakeLists.txt.in"
+  "/root/repo/src/CMakeLists.txt"
+  "/root/repo/test/CMakeLists.txt"
+  "/usr/share/cmake-3.25/Modules/BasicConfigVersion-AnyNewerVersion.cmake.in"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeDependentOption.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakePackageConfigHelpers.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPython.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPython/Support.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/GNUInstallDirs.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  "/usr/share/cmake-3.25/Modules/WriteBasicConfigVersionFile.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "googletest-download/CMakeLists.txt"
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "googletest-build/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "googletest-build/googletest/generated/gmock.pc"
+  "googletest-build/googletest/generated/gmock_main.pc"
+  "googletest-build/googlemock/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "googletest-build/googletest/generated/GTestConfigVersion.cmake"
+  "googletest-build/googletest/generated/GTestConfig.cmake"
+  "googletest-build/googletest/generated/gtest.pc"
+  "googletest-build/googletest/generated/gtest_main.pc"
+  "googletest-build/googletest/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "src/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "test/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/format.dir/DependInfo.cmake"
+  "CMakeFiles/check-format.dir/DependInfo.cmake"
+  "CMakeFiles/check-lint.dir/DependInfo.cmake"
+  "CMakeFiles/check-clang-tidy.dir/DependInfo.cmake"
+  "googletest-build/googlemock/CMakeFiles/gmock.dir/DependInfo.cmake"
+  "googletest-build/googlemock/CMakeFiles/gmock_main.dir/DependInfo.cmake"
+  "googletest-build/googletest/CMakeFiles/gtest.dir/DependInfo.cmake"
+  "googletest-build/googletest/CMakeFiles/gtest_main.dir/DependInfo.cmake"
+  "src/CMakeFiles/bustub_shared.dir/DependInfo.cmake"
+  "src/CMakeFiles/thirdparty_murmur3.dir/DependInfo.cmake"
+  "test/CMakeFiles/build-tests.dir/DependInfo.cmake"
+  "test/CMakeFiles/check-tests.dir/DependInfo.cmake"
+  "test/CMakeFiles/buffer_pool_manager_instance_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/clock_replacer_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/lru_k_replacer_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/lru_replacer_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/parallel_buffer_pool_manager_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/catalog_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/bounded_queue_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/rwlatch_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/lock_manager_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/transaction_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/hash_table_page_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/hash_table_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/aggregation_hash_table_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/bloom_filter_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/executor_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/join_hash_table_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/vectorized_filter_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/starter_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/recovery_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/b_plus_tree_concurrent_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/b_plus_tree_delete_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/b_plus_tree_insert_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/b_plus_tree_print_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/disk_manager_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/tmp_tuple_page_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/table_heap_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/tuple_test.dir/DependInfo.cmake"
+  "test/CMakeFiles/type_test.dir/DependInfo.cmake"
+  )
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../lib/libthirdparty_murmur3.pdb"
+  "../lib/libthirdparty_murmur3.so"
+  "CMakeFiles/thirdparty_murmur3.dir/__/third_party/murmur3/MurmurHash3.cpp.o"
+  "CMakeFiles/thirdparty_murmur3.dir/__/third_party/murmur3/MurmurHash3.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/thirdparty_murmur3.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/aggregation_hash_table_test.dir/execution/aggregation_hash_table_test.cpp.o"
+  "CMakeFiles/aggregation_hash_table_test.dir/execution/aggregation_hash_table_test.cpp.o.d"
+  "CMakeFiles/aggregation_hash_table_test.dir/storage/BucketPageSampleTest.cpp.o"
+  "CMakeFiles/aggregation_hash_table_test.dir/storage/BucketPageSampleTest.cpp.o.d"
+  "aggregation_hash_table_test"
+  "aggregation_hash_table_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/aggregation_hash_table_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,25 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/test/storage/BucketPageSampleTest.cpp" "test/CMakeFiles/b_plus_tree_print_test.dir/storage/BucketPageSampleTest.cpp.o" "gcc" "test/CMakeFiles/b_plus_tree_print_test.dir/storage/BucketPageSampleTest.cpp.o.d"
+  "/root/repo/test/storage/b_plus_tree_print_test.cpp" "test/CMakeFiles/b_plus_tree_print_test.dir/storage/b_plus_tree_print_test.cpp.o" "gcc" "test/CMakeFiles/b_plus_tree_print_test.dir/storage/b_plus_tree_print_test.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_asan_build/src/CMakeFiles/bustub_shared.dir/DependInfo.cmake"
+  "/root/repo/_asan_build/googletest-build/googlemock/CMakeFiles/gmock_main.dir/DependInfo.cmake"
+  "/root/repo/_asan_build/src/CMakeFiles/thirdparty_murmur3.dir/DependInfo.cmake"
+  "/root/repo/_asan_build/googletest-build/googlemock/CMakeFiles/gmock.dir/DependInfo.cmake"
+  "/root/repo/_asan_build/googletest-build/googletest/CMakeFiles/gtest.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
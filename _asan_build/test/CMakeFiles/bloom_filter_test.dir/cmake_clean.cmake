@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bloom_filter_test.dir/execution/bloom_filter_test.cpp.o"
+  "CMakeFiles/bloom_filter_test.dir/execution/bloom_filter_test.cpp.o.d"
+  "CMakeFiles/bloom_filter_test.dir/storage/BucketPageSampleTest.cpp.o"
+  "CMakeFiles/bloom_filter_test.dir/storage/BucketPageSampleTest.cpp.o.d"
+  "bloom_filter_test"
+  "bloom_filter_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bloom_filter_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
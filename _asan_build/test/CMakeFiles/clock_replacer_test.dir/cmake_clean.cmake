@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/clock_replacer_test.dir/buffer/clock_replacer_test.cpp.o"
+  "CMakeFiles/clock_replacer_test.dir/buffer/clock_replacer_test.cpp.o.d"
+  "CMakeFiles/clock_replacer_test.dir/storage/BucketPageSampleTest.cpp.o"
+  "CMakeFiles/clock_replacer_test.dir/storage/BucketPageSampleTest.cpp.o.d"
+  "clock_replacer_test"
+  "clock_replacer_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/clock_replacer_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
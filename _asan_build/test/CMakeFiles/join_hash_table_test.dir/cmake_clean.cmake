@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/join_hash_table_test.dir/execution/join_hash_table_test.cpp.o"
+  "CMakeFiles/join_hash_table_test.dir/execution/join_hash_table_test.cpp.o.d"
+  "CMakeFiles/join_hash_table_test.dir/storage/BucketPageSampleTest.cpp.o"
+  "CMakeFiles/join_hash_table_test.dir/storage/BucketPageSampleTest.cpp.o.d"
+  "join_hash_table_test"
+  "join_hash_table_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/join_hash_table_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
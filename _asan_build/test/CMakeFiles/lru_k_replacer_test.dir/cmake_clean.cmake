@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lru_k_replacer_test.dir/buffer/lru_k_replacer_test.cpp.o"
+  "CMakeFiles/lru_k_replacer_test.dir/buffer/lru_k_replacer_test.cpp.o.d"
+  "CMakeFiles/lru_k_replacer_test.dir/storage/BucketPageSampleTest.cpp.o"
+  "CMakeFiles/lru_k_replacer_test.dir/storage/BucketPageSampleTest.cpp.o.d"
+  "lru_k_replacer_test"
+  "lru_k_replacer_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/lru_k_replacer_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/starter_test.dir/primer/starter_test.cpp.o"
+  "CMakeFiles/starter_test.dir/primer/starter_test.cpp.o.d"
+  "CMakeFiles/starter_test.dir/storage/BucketPageSampleTest.cpp.o"
+  "CMakeFiles/starter_test.dir/storage/BucketPageSampleTest.cpp.o.d"
+  "starter_test"
+  "starter_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/starter_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
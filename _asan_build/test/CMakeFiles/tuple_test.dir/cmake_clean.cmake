@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tuple_test.dir/storage/BucketPageSampleTest.cpp.o"
+  "CMakeFiles/tuple_test.dir/storage/BucketPageSampleTest.cpp.o.d"
+  "CMakeFiles/tuple_test.dir/table/tuple_test.cpp.o"
+  "CMakeFiles/tuple_test.dir/table/tuple_test.cpp.o.d"
+  "tuple_test"
+  "tuple_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tuple_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
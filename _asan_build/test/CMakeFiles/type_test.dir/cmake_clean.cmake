@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/type_test.dir/storage/BucketPageSampleTest.cpp.o"
+  "CMakeFiles/type_test.dir/storage/BucketPageSampleTest.cpp.o.d"
+  "CMakeFiles/type_test.dir/type/type_test.cpp.o"
+  "CMakeFiles/type_test.dir/type/type_test.cpp.o.d"
+  "type_test"
+  "type_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/type_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
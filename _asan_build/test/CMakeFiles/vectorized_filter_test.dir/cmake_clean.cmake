@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/vectorized_filter_test.dir/execution/vectorized_filter_test.cpp.o"
+  "CMakeFiles/vectorized_filter_test.dir/execution/vectorized_filter_test.cpp.o.d"
+  "CMakeFiles/vectorized_filter_test.dir/storage/BucketPageSampleTest.cpp.o"
+  "CMakeFiles/vectorized_filter_test.dir/storage/BucketPageSampleTest.cpp.o.d"
+  "vectorized_filter_test"
+  "vectorized_filter_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/vectorized_filter_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
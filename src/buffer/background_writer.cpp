@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// background_writer.cpp
+//
+// Identification: src/buffer/background_writer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/background_writer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+namespace bustub {
+
+BackgroundWriter::BackgroundWriter(std::vector<BufferPoolManagerInstance *> instances, DiskManager *disk_manager,
+                                   size_t clean_frame_target)
+    : instances_(std::move(instances)), disk_manager_(disk_manager), clean_frame_target_(clean_frame_target) {}
+
+BackgroundWriter::~BackgroundWriter() { Stop(); }
+
+void BackgroundWriter::Run() {
+  if (enable_.exchange(true)) {
+    return;
+  }
+  writer_thread_ = std::thread([this] {
+    while (enable_) {
+      {
+        std::unique_lock<std::mutex> lock(latch_);
+        cv_.wait_for(lock, background_writer_interval, [this] { return !enable_; });
+      }
+      if (enable_) {
+        FlushRound();
+      }
+    }
+  });
+}
+
+void BackgroundWriter::Stop() {
+  if (!enable_.exchange(false)) {
+    return;
+  }
+  {
+    // Taking the latch orders the store to enable_ with the writer's predicate check, so the wakeup is not lost.
+    std::lock_guard<std::mutex> lg(latch_);
+  }
+  cv_.notify_all();
+  writer_thread_.join();
+}
+
+size_t BackgroundWriter::FlushRound() {
+  std::vector<Page *> pages;
+  for (auto *instance : instances_) {
+    size_t clean_frames = instance->GetCleanFrameCount();
+    if (clean_frames < clean_frame_target_) {
+      instance->PinColdDirtyPages(clean_frame_target_ - clean_frames, &pages);
+    }
+  }
+  if (pages.empty()) {
+    return 0;
+  }
+  std::sort(pages.begin(), pages.end(), [](Page *a, Page *b) { return a->GetPageId() < b->GetPageId(); });
+
+  std::vector<char> buffer;
+  size_t begin = 0;
+  while (begin < pages.size()) {
+    size_t end = begin + 1;
+    while (end < pages.size() && end - begin < static_cast<size_t>(BACKGROUND_WRITE_MAX_PAGES) &&
+           pages[end]->GetPageId() == pages[end - 1]->GetPageId() + 1) {
+      ++end;
+    }
+    // Copy each page under its read latch, one at a time, so the write sees consistent page images without the
+    // writer ever holding more than one latch.
+    buffer.resize((end - begin) * PAGE_SIZE);
+    for (size_t i = begin; i < end; ++i) {
+      pages[i]->RLatch();
+      memcpy(buffer.data() + (i - begin) * PAGE_SIZE, pages[i]->GetData(), PAGE_SIZE);
+      pages[i]->RUnlatch();
+    }
+    disk_manager_->WritePages(pages[begin]->GetPageId(), end - begin, buffer.data());
+    ++num_writes_;
+    begin = end;
+  }
+
+  for (Page *page : pages) {
+    page_id_t page_id = page->GetPageId();
+    instances_[page_id % instances_.size()]->ReleaseColdPage(page);
+  }
+  num_pages_written_ += pages.size();
+  return pages.size();
+}
+
+}  // namespace bustub
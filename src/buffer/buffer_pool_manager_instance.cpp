@@ -11,23 +11,35 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <future>  // NOLINT
+#include <memory>
+#include <vector>
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
 #include "common/macros.h"
 
 namespace bustub {
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
-                                                     LogManager *log_manager)
-    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager) {}
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager, replacer_type) {}
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
-                                                     DiskManager *disk_manager, LogManager *log_manager)
+                                                     DiskManager *disk_manager, LogManager *log_manager,
+                                                     ReplacerType replacer_type)
     : pool_size_(pool_size),
       num_instances_(num_instances),
       instance_index_(instance_index),
       next_page_id_(instance_index),
       disk_manager_(disk_manager),
-      log_manager_(log_manager) {
+      log_manager_(log_manager),
+      read_ahead_window_(disk_manager != nullptr && disk_manager->IsAsynchronous()
+                             ? std::min<size_t>(READ_AHEAD_WINDOW, pool_size / 4)
+                             : 0) {
   BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
   BUSTUB_ASSERT(
       instance_index < num_instances,
@@ -35,7 +47,19 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t
   // We allocate a consecutive memory space for the buffer pool.
 
   pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size);
+  io_cvs_ = new std::condition_variable[pool_size_];
+  switch (replacer_type) {
+    case ReplacerType::CLOCK:
+      replacer_ = new ClockReplacer(pool_size);
+      break;
+    case ReplacerType::LRU_K:
+      replacer_ = new LRUKReplacer(pool_size);
+      break;
+    case ReplacerType::LRU:
+    default:
+      replacer_ = new LRUReplacer(pool_size);
+      break;
+  }
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
     free_list_.emplace_back(static_cast<int>(i));
@@ -43,73 +67,292 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  StopBackgroundWriter();
+  {
+    // prefetch completions still reference the frames
+    std::unique_lock<std::mutex> lock(latch_);
+    prefetch_cv_.wait(lock, [this] { return pending_prefetch_io_ == 0; });
+  }
   delete[] pages_;
+  delete[] io_cvs_;
   delete replacer_;
 }
-bool BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) {
-  // Make sure you call DiskManager::WritePage!
+
+Page *BufferPoolManagerInstance::PinResident(page_id_t page_id, frame_id_t *frame_id, bool *first_pin) {
+  PageTableStripe &stripe = GetStripe(page_id);
+  std::lock_guard<std::mutex> lg(stripe.latch_);
+  auto iter = stripe.table_.find(page_id);
+  if (iter == stripe.table_.end()) {
+    return nullptr;
+  }
+  *frame_id = iter->second;
+  Page *p = &pages_[*frame_id];
+  *first_pin = p->pin_count_.fetch_add(1) == 0;
+  return p;
+}
+
+void BufferPoolManagerInstance::WaitForIo(frame_id_t frame_id) {
+  Page *p = &pages_[frame_id];
+  if (!p->io_pending_) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(latch_);
+  io_cvs_[frame_id].wait(lock, [p] { return !p->io_pending_; });
+}
+
+bool BufferPoolManagerInstance::FindFreeFrame(frame_id_t *frame_id) {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    return true;
+  }
+  while (replacer_->Victim(frame_id)) {
+    Page *p = &pages_[*frame_id];
+    if (p->page_id_ == INVALID_PAGE_ID) {
+      // A late Unpin racing with DeletePgImp; the frame already sits in the free list.
+      continue;
+    }
+    PageTableStripe &stripe = GetStripe(p->page_id_);
+    std::lock_guard<std::mutex> lg(stripe.latch_);
+    // Hits raise the pin count under the stripe latch, so a count of zero here cannot change until we let go.
+    // A pinned victim is dropped; its last unpin hands it back to the replacer.
+    if (p->pin_count_ == 0) {
+      stripe.table_.erase(p->page_id_);
+      return true;
+    }
+  }
+  return false;
+}
+
+void BufferPoolManagerInstance::InstallPage(frame_id_t frame_id, page_id_t page_id, page_id_t *victim_page_id) {
+  Page *p = &pages_[frame_id];
+  *victim_page_id = INVALID_PAGE_ID;
+  if (p->page_id_ != INVALID_PAGE_ID && p->is_dirty_) {
+    // Until the write-back lands, fetching the old page must wait instead of reading a stale copy from disk.
+    *victim_page_id = p->page_id_;
+    evicting_pages_[p->page_id_] = frame_id;
+  }
+  p->page_id_ = page_id;
+  p->is_dirty_ = false;
+  p->io_pending_ = true;
+  // The frame holds another page from now on, so whatever the replacer remembers about the old one is dropped.
+  replacer_->Remove(frame_id);
+  PageTableStripe &stripe = GetStripe(page_id);
+  std::lock_guard<std::mutex> lg(stripe.latch_);
+  p->pin_count_ = 1;
+  stripe.table_[page_id] = frame_id;
+}
+
+void BufferPoolManagerInstance::FinishIo(std::unique_lock<std::mutex> *lock, frame_id_t frame_id,
+                                         page_id_t victim_page_id) {
+  lock->lock();
+  if (victim_page_id != INVALID_PAGE_ID) {
+    evicting_pages_.erase(victim_page_id);
+  }
+  pages_[frame_id].io_pending_ = false;
+  lock->unlock();
+  io_cvs_[frame_id].notify_all();
+}
+
+void BufferPoolManagerInstance::PerformIo(std::vector<DiskRequest> *requests) {
+  if (!disk_manager_->IsAsynchronous()) {
+    // the requests are done by the time SubmitRequests returns
+    disk_manager_->SubmitRequests(requests);
+    return;
+  }
+  // A single completion for the whole batch, set by whichever request finishes last.
+  struct Batch {
+    std::atomic<size_t> remaining_;
+    std::promise<void> done_;
+  };
+  auto batch = std::make_shared<Batch>();
+  batch->remaining_ = requests->size();
+  std::future<void> done = batch->done_.get_future();
+  for (auto &request : *requests) {
+    request.callback_ = [batch] {
+      if (--batch->remaining_ == 0) {
+        batch->done_.set_value();
+      }
+    };
+  }
+  disk_manager_->SubmitRequests(requests);
+  done.wait();
+}
+
+void BufferPoolManagerInstance::PrefetchPages(const std::vector<page_id_t> &page_ids) {
+  std::vector<DiskRequest> requests;
+  {
+    std::lock_guard<std::mutex> lg(latch_);
+    for (page_id_t page_id : page_ids) {
+      ValidatePageId(page_id);
+      if (evicting_pages_.count(page_id) != 0) {
+        continue;
+      }
+      {
+        PageTableStripe &stripe = GetStripe(page_id);
+        std::lock_guard<std::mutex> stripe_lg(stripe.latch_);
+        if (stripe.table_.count(page_id) != 0) {
+          continue;
+        }
+      }
+      frame_id_t frame_id;
+      if (!FindFreeFrame(&frame_id)) {
+        break;
+      }
+      // The frame stays pinned by the prefetch until its read completes, exactly like a miss in FetchPgImp; a fetch
+      // of the page meanwhile pins it as well and waits for the read in WaitForIo.
+      page_id_t victim_page_id;
+      InstallPage(frame_id, page_id, &victim_page_id);
+      Page *p = &pages_[frame_id];
+      if (victim_page_id != INVALID_PAGE_ID) {
+        std::shared_ptr<char[]> victim_data(new char[PAGE_SIZE]);
+        memcpy(victim_data.get(), p->data_, PAGE_SIZE);
+        requests.push_back({true, victim_page_id, victim_data.get(), [this, victim_page_id, frame_id, victim_data] {
+                              FinishPrefetchWrite(frame_id, victim_page_id);
+                            }});
+      }
+      requests.push_back({false, page_id, p->data_, [this, frame_id] { FinishPrefetchRead(frame_id); }});
+    }
+    pending_prefetch_io_ += requests.size();
+  }
+  // A single submission for the whole batch.
+  disk_manager_->SubmitRequests(&requests);
+}
+
+void BufferPoolManagerInstance::DetectSequentialAccess(page_id_t page_id) {
+  if (read_ahead_window_ == 0) {
+    return;
+  }
+  // Consecutive pages of this instance are num_instances_ apart.
+  const page_id_t stride = num_instances_;
+  const auto window = static_cast<page_id_t>(read_ahead_window_);
+  for (auto &stream : read_ahead_streams_) {
+    page_id_t expected = page_id;
+    if (!stream.next_expected_.compare_exchange_strong(expected, page_id + stride)) {
+      if (expected == page_id + stride) {
+        // The reader came back to the page it fetched last, e.g. for its next tuple; the pattern goes on.
+        return;
+      }
+      continue;
+    }
+    if (++stream.run_length_ < READ_AHEAD_TRIGGER) {
+      return;
+    }
+    // Top the window up once the reader has consumed half of it, so the reads go out in batches.
+    page_id_t prefetched_until = stream.prefetched_until_;
+    if (prefetched_until - page_id > window / 2 * stride) {
+      return;
+    }
+    const page_id_t first = std::max(prefetched_until, page_id + stride);
+    const page_id_t last = std::min<page_id_t>(page_id + window * stride, next_page_id_ - stride);
+    if (last < first || !stream.prefetched_until_.compare_exchange_strong(prefetched_until, last + stride)) {
+      return;
+    }
+    std::vector<page_id_t> page_ids;
+    for (page_id_t next = first; next <= last; next += stride) {
+      page_ids.push_back(next);
+    }
+    PrefetchPages(page_ids);
+    return;
+  }
+  // Not the continuation of any pattern: start following a new one in place of the oldest.
+  ReadAheadStream &stream = read_ahead_streams_[next_read_ahead_stream_++ % READ_AHEAD_STREAMS];
+  stream.next_expected_ = page_id + stride;
+  stream.run_length_ = 1;
+  stream.prefetched_until_ = page_id + stride;
+}
+
+void BufferPoolManagerInstance::FinishPrefetchWrite(frame_id_t frame_id, page_id_t victim_page_id) {
+  {
+    std::lock_guard<std::mutex> lg(latch_);
+    evicting_pages_.erase(victim_page_id);
+  }
+  io_cvs_[frame_id].notify_all();
+  FinishPrefetchRequest();
+}
+
+void BufferPoolManagerInstance::FinishPrefetchRead(frame_id_t frame_id) {
+  Page *p = &pages_[frame_id];
+  {
+    std::lock_guard<std::mutex> lg(latch_);
+    p->io_pending_ = false;
+  }
+  if (p->pin_count_.fetch_sub(1) == 1) {
+    replacer_->Unpin(frame_id);
+  }
+  io_cvs_[frame_id].notify_all();
+  FinishPrefetchRequest();
+}
+
+void BufferPoolManagerInstance::FinishPrefetchRequest() {
+  // The destructor frees the frames and the replacer as soon as it sees the count drop to zero, so this comes last,
+  // and notifies under the latch so that the destructor cannot wake up before the notification is done.
   std::lock_guard<std::mutex> lg(latch_);
+  --pending_prefetch_io_;
+  prefetch_cv_.notify_all();
+}
 
-  if (page_table_.count(page_id) == 0) {
+bool BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) {
+  // Make sure you call DiskManager::WritePage!
+  frame_id_t frame_id;
+  bool first_pin;
+  // The pin keeps the frame from being evicted during the write. It bypasses the replacer, and is released without
+  // counting as a use, so that flushing does not make a cold page look recently used.
+  Page *p = PinResident(page_id, &frame_id, &first_pin);
+  if (p == nullptr) {
     return false;
   }
-  Page *p = &pages_[page_table_[page_id]];
-  if (p->is_dirty_) {
+  WaitForIo(frame_id);
+  if (p->is_dirty_.exchange(false)) {
     disk_manager_->WritePage(page_id, p->data_);
   }
-  p->is_dirty_ = false;
+  if (p->pin_count_.fetch_sub(1) == 1) {
+    replacer_->Release(frame_id);
+  }
   return true;
 }
 
 void BufferPoolManagerInstance::FlushAllPgsImp() {
   // You can do it!
-  for (const auto &page_pair : page_table_) {
-    FlushPgImp(page_pair.first);
+  std::vector<page_id_t> page_ids;
+  for (auto &stripe : page_table_) {
+    std::lock_guard<std::mutex> lg(stripe.latch_);
+    for (const auto &page_pair : stripe.table_) {
+      page_ids.push_back(page_pair.first);
+    }
+  }
+  for (page_id_t page_id : page_ids) {
+    FlushPgImp(page_id);
   }
 }
+
 Page *BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) {
   // 0.   Make sure you call AllocatePage!
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   // 4.   Set the page ID output parameter. Return a pointer to P.
-  std::lock_guard<std::mutex> lg(latch_);
-  bool flag = false;
-  size_t i;
-  for (i = 0; i < pool_size_; i++) {
-    Page *p = &(pages_[i]);
-    if (p->pin_count_ == 0) {
-      flag = true;
-      break;
-    }
-  }
-  if (!flag) {
-    return nullptr;
-  }
-  frame_id_t frame_id = -1;
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-  }
-  if (frame_id == -1) {
-    replacer_->Victim(&frame_id);
-  }
-  if (frame_id == -1) {
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!FindFreeFrame(&frame_id)) {
     return nullptr;
   }
   *page_id = AllocatePage();
-  Page *p = &(pages_[frame_id]);
-  if (p->is_dirty_) {
-    disk_manager_->WritePage(p->page_id_, p->data_);
+  page_id_t victim_page_id;
+  InstallPage(frame_id, *page_id, &victim_page_id);
+  replacer_->RecordAccess(frame_id);
+  lock.unlock();
+
+  Page *p = &pages_[frame_id];
+  if (victim_page_id != INVALID_PAGE_ID) {
+    disk_manager_->WritePage(victim_page_id, p->data_);
   }
-  page_table_.erase(p->page_id_);
-  p->page_id_ = *page_id;
-  p->pin_count_ = 1;
-  p->is_dirty_ = false;
+  // The new page only exists in memory until it is first written back. It is born dirty so that it will be; until
+  // then, reading it from disk yields zeros, same as the in-memory copy.
   p->ResetMemory();
-  disk_manager_->WritePage(p->page_id_, p->data_);
-  // replacer_->Pin(frame_id);
-  page_table_[p->page_id_] = frame_id;
+  p->is_dirty_ = true;
+
+  FinishIo(&lock, frame_id, victim_page_id);
   return p;
 }
 
@@ -121,40 +364,60 @@ Page *BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) {
   // 2.     If R is dirty, write it back to the disk.
   // 3.     Delete R from the page table and insert P.
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-  std::lock_guard<std::mutex> lg(latch_);
-  if (page_table_.count(page_id) != 0) {
-    Page *p = &pages_[page_table_[page_id]];
-    p->pin_count_++;
-    replacer_->Pin(page_table_[page_id]);
-    return p;
-  }
-  frame_id_t frame_id = -1;
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-  }
-  if (frame_id == -1) {
-    replacer_->Victim(&frame_id);
+  DetectSequentialAccess(page_id);
+  frame_id_t frame_id;
+  bool first_pin;
+  Page *p = PinResident(page_id, &frame_id, &first_pin);
+  if (p == nullptr) {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (true) {
+      // Another miss may have brought the page in while we were waiting for the latch.
+      p = PinResident(page_id, &frame_id, &first_pin);
+      if (p != nullptr) {
+        break;
+      }
+      auto evicting = evicting_pages_.find(page_id);
+      if (evicting == evicting_pages_.end()) {
+        break;
+      }
+      io_cvs_[evicting->second].wait(lock);
+    }
+
+    if (p == nullptr) {
+      if (!FindFreeFrame(&frame_id)) {
+        return nullptr;
+      }
+      page_id_t victim_page_id;
+      InstallPage(frame_id, page_id, &victim_page_id);
+      replacer_->RecordAccess(frame_id);
+      lock.unlock();
+
+      Page *r = &pages_[frame_id];
+      std::vector<DiskRequest> requests;
+      if (victim_page_id != INVALID_PAGE_ID) {
+        // The write-back goes out together with the read, so it works from a copy of the victim: the read may land in
+        // the frame first.
+        alignas(DIRECT_IO_ALIGNMENT) static thread_local char victim_data[PAGE_SIZE];
+        memcpy(victim_data, r->data_, PAGE_SIZE);
+        requests.push_back({true, victim_page_id, victim_data, nullptr});
+      }
+      requests.push_back({false, page_id, r->data_, nullptr});
+      PerformIo(&requests);
+
+      FinishIo(&lock, frame_id, victim_page_id);
+      return r;
+    }
   }
-  if (frame_id == -1) {
-    return nullptr;
+
+  if (first_pin) {
+    replacer_->Pin(frame_id);
+    replacer_->RecordAccess(frame_id);
   }
-  Page *r = &(pages_[frame_id]);
-  if (r->is_dirty_) {
-    disk_manager_->WritePage(r->page_id_, r->data_);
-  }
-  page_table_.erase(r->page_id_);
-  r->ResetMemory();
-  r->is_dirty_ = false;
-  // r->page_id_ = INVALID_PAGE_ID;
-  // r->pin_count_ = 0;
-  r->page_id_ = page_id;
-  r->pin_count_ = 1;
-  replacer_->Pin(frame_id);
-  disk_manager_->ReadPage(r->page_id_, r->data_);
-  page_table_[page_id] = frame_id;
-  return r;
+  // Someone else may still be reading this page in; wait for that frame rather than for the whole pool.
+  WaitForIo(frame_id);
+  return p;
 }
+
 bool BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) {
   // 0.   Make sure you call DeallocatePage!
   // 1.   Search the page table for the requested page (p).
@@ -162,47 +425,112 @@ bool BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) {
   // 2.   If p exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, p can be deleted. Remove p from the page table, reset its metadata and return it to the free list.
   std::lock_guard<std::mutex> lg(latch_);
-  if (page_table_.count(page_id) == 0) {
-    DeallocatePage(page_id);
-    return true;
-  }
-  Page *p = &pages_[page_table_[page_id]];
-  if (p->pin_count_ > 0) {
-    return false;
+  frame_id_t frame_id;
+  {
+    PageTableStripe &stripe = GetStripe(page_id);
+    std::lock_guard<std::mutex> stripe_lg(stripe.latch_);
+    auto iter = stripe.table_.find(page_id);
+    if (iter == stripe.table_.end()) {
+      DeallocatePage(page_id);
+      return true;
+    }
+    frame_id = iter->second;
+    // A frame with I/O in flight is always pinned by the thread doing the I/O.
+    if (pages_[frame_id].pin_count_ > 0) {
+      return false;
+    }
+    stripe.table_.erase(iter);
   }
   DeallocatePage(page_id);
 
-  if (p->is_dirty_) {
-    disk_manager_->WritePage(page_id, p->data_);
-  }
-  free_list_.push_back(page_table_[page_id]);
-  page_table_.erase(page_id);
-  replacer_->Pin(page_table_[page_id]);
+  // The contents of a deleted page are dead, so there is no need to write them back.
+  Page *p = &pages_[frame_id];
+  replacer_->Remove(frame_id);
+  free_list_.push_back(frame_id);
   p->page_id_ = INVALID_PAGE_ID;
-  p->pin_count_ = 0;
   p->is_dirty_ = false;
   p->ResetMemory();
   return true;
 }
 
 bool BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) {
+  frame_id_t frame_id;
+  {
+    PageTableStripe &stripe = GetStripe(page_id);
+    std::lock_guard<std::mutex> lg(stripe.latch_);
+    auto iter = stripe.table_.find(page_id);
+    if (iter == stripe.table_.end()) {
+      return true;
+    }
+    frame_id = iter->second;
+    Page *p = &pages_[frame_id];
+    if (is_dirty) {
+      p->is_dirty_ = is_dirty;
+    }
+    int pin_count = p->pin_count_;
+    do {
+      if (pin_count <= 0) {
+        return false;
+      }
+    } while (!p->pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+    if (pin_count > 1) {
+      return true;
+    }
+  }
+  replacer_->Unpin(frame_id);
+  return true;
+}
+
+size_t BufferPoolManagerInstance::GetCleanFrameCount() {
   std::lock_guard<std::mutex> lg(latch_);
-  // assert(page_table_.count(page_id) != 0);
-  if (page_table_.count(page_id) == 0) {
-    return true;
+  size_t clean_frames = free_list_.size();
+  for (size_t i = 0; i < pool_size_; ++i) {
+    Page *p = &pages_[i];
+    if (p->page_id_ != INVALID_PAGE_ID && p->pin_count_ == 0 && !p->is_dirty_) {
+      ++clean_frames;
+    }
   }
-  Page *p = &pages_[page_table_[page_id]];
-  if (is_dirty) {
-    p->is_dirty_ = is_dirty;
+  return clean_frames;
+}
+
+void BufferPoolManagerInstance::PinColdDirtyPages(size_t max_pages, std::vector<Page *> *pages) {
+  std::lock_guard<std::mutex> lg(latch_);
+  size_t pinned = 0;
+  for (size_t i = 0; i < pool_size_ && pinned < max_pages; ++i) {
+    Page *p = &pages_[writer_hand_];
+    writer_hand_ = (writer_hand_ + 1) % pool_size_;
+    if (p->page_id_ == INVALID_PAGE_ID || p->pin_count_ != 0 || !p->is_dirty_) {
+      continue;
+    }
+    PageTableStripe &stripe = GetStripe(p->page_id_);
+    std::lock_guard<std::mutex> stripe_lg(stripe.latch_);
+    if (p->pin_count_ == 0 && p->is_dirty_) {
+      p->pin_count_ = 1;
+      p->is_dirty_ = false;
+      pages->push_back(p);
+      ++pinned;
+    }
   }
-  if (p->pin_count_ <= 0) {
-    return false;
+}
+
+void BufferPoolManagerInstance::ReleaseColdPage(Page *page) {
+  if (page->pin_count_.fetch_sub(1) == 1) {
+    replacer_->Release(static_cast<frame_id_t>(page - pages_));
   }
-  p->pin_count_ = p->pin_count_ - 1;
-  if (p->pin_count_ == 0) {
-    replacer_->Unpin(page_table_[page_id]);
+}
+
+void BufferPoolManagerInstance::StartBackgroundWriter(size_t clean_frame_target) {
+  StopBackgroundWriter();
+  background_writer_ = std::make_unique<BackgroundWriter>(std::vector<BufferPoolManagerInstance *>{this},
+                                                          disk_manager_, clean_frame_target);
+  background_writer_->Run();
+}
+
+void BufferPoolManagerInstance::StopBackgroundWriter() {
+  if (background_writer_ != nullptr) {
+    background_writer_->Stop();
+    background_writer_.reset();
   }
-  return true;
 }
 
 page_id_t BufferPoolManagerInstance::AllocatePage() {
@@ -14,16 +14,59 @@
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : num_pages_(num_pages), in_clock_(num_pages), ref_bits_(num_pages) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-bool ClockReplacer::Victim(frame_id_t *frame_id) { return false; }
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  while (size_ > 0) {
+    size_t frame = hand_.fetch_add(1) % num_pages_;
+    if (!in_clock_[frame]) {
+      continue;
+    }
+    if (ref_bits_[frame].exchange(false)) {
+      continue;
+    }
+    // Racing with a concurrent Pin or Victim of the same frame: whoever clears the bit owns the removal.
+    if (in_clock_[frame].exchange(false)) {
+      --size_;
+      *frame_id = static_cast<frame_id_t>(frame);
+      return true;
+    }
+  }
+  return false;
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  if (in_clock_[frame_id].exchange(false)) {
+    --size_;
+  }
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  // Count the frame before it becomes visible to Victim, so size_ can only over-count transiently, never wrap.
+  ref_bits_[frame_id] = true;
+  ++size_;
+  if (in_clock_[frame_id].exchange(true)) {
+    --size_;
+  }
+}
 
-size_t ClockReplacer::Size() { return 0; }
+// The reference bit is set when the frame is unpinned.
+void ClockReplacer::Release(frame_id_t frame_id) {
+  // Leave the reference bit of a frame still in the clock alone.
+  if (!in_clock_[frame_id]) {
+    Unpin(frame_id);
+  }
+}
+
+void ClockReplacer::RecordAccess(frame_id_t frame_id) {}
+
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  Pin(frame_id);
+  ref_bits_[frame_id] = false;
+}
+
+size_t ClockReplacer::Size() { return size_; }
 
 }  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k)
+    : k_(k), history_(num_pages), unpinned_at_(num_pages), evictable_(num_pages, false) {}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+LRUKReplacer::EvictionKey LRUKReplacer::GetEvictionKey(frame_id_t frame_id) const {
+  const auto &history = history_[frame_id];
+  return {history.size() >= k_, history.empty() ? unpinned_at_[frame_id] : history.front(), frame_id};
+}
+
+void LRUKReplacer::AppendAccess(frame_id_t frame_id) {
+  auto &history = history_[frame_id];
+  history.push_back(current_timestamp_++);
+  if (history.size() > k_) {
+    history.pop_front();
+  }
+}
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> lg(latch_);
+  if (eviction_order_.empty()) {
+    return false;
+  }
+  *frame_id = std::get<2>(*eviction_order_.begin());
+  eviction_order_.erase(eviction_order_.begin());
+  evictable_[*frame_id] = false;
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lg(latch_);
+  if (evictable_[frame_id]) {
+    eviction_order_.erase(GetEvictionKey(frame_id));
+    evictable_[frame_id] = false;
+  }
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lg(latch_);
+  if (evictable_[frame_id]) {
+    return;
+  }
+  if (history_[frame_id].empty()) {
+    unpinned_at_[frame_id] = current_timestamp_++;
+  }
+  evictable_[frame_id] = true;
+  eviction_order_.insert(GetEvictionKey(frame_id));
+}
+
+void LRUKReplacer::Release(frame_id_t frame_id) {
+  // Unpinning records no access, and leaves an evictable frame where it is.
+  Unpin(frame_id);
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lg(latch_);
+  if (!evictable_[frame_id]) {
+    AppendAccess(frame_id);
+    return;
+  }
+  eviction_order_.erase(GetEvictionKey(frame_id));
+  AppendAccess(frame_id);
+  eviction_order_.insert(GetEvictionKey(frame_id));
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lg(latch_);
+  if (evictable_[frame_id]) {
+    eviction_order_.erase(GetEvictionKey(frame_id));
+    evictable_[frame_id] = false;
+  }
+  history_[frame_id].clear();
+}
+
+size_t LRUKReplacer::Size() {
+  std::lock_guard<std::mutex> lg(latch_);
+  return eviction_order_.size();
+}
+
+}  // namespace bustub
@@ -51,6 +51,16 @@ void LRUReplacer::Unpin(frame_id_t frame_id) {
   latch_.unlock();
 }
 
+// Recency is taken from the order in which frames are unpinned.
+void LRUReplacer::Release(frame_id_t frame_id) {
+  // Unpin already leaves a frame that is in the list where it is.
+  Unpin(frame_id);
+}
+
+void LRUReplacer::RecordAccess(frame_id_t frame_id) {}
+
+void LRUReplacer::Remove(frame_id_t frame_id) { Pin(frame_id); }
+
 size_t LRUReplacer::Size() {
   latch_.lock();
   size_t sz = lru_.size();
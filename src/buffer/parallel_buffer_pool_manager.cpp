@@ -15,18 +15,20 @@
 namespace bustub {
 
 ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
-                                                     LogManager *log_manager)
-    : num_instances_(num_instances), pool_size_(pool_size) {
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : num_instances_(num_instances), pool_size_(pool_size), disk_manager_(disk_manager) {
   // Allocate and create individual BufferPoolManagerInstances
   this->bpm_table_ = new BufferPoolManager *[num_instances];
   start_index_ = 0;
   for (size_t i = 0; i < num_instances; i++) {
-    this->bpm_table_[i] = new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager, log_manager);
+    this->bpm_table_[i] =
+        new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager, log_manager, replacer_type);
   }
 }
 
 // Update constructor to destruct all BufferPoolManagerInstances and deallocate any associated memory
 ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  StopBackgroundWriter();
   for (size_t i = 0; i < num_instances_; i++) {
     delete this->bpm_table_[i];
   }
@@ -39,12 +41,46 @@ size_t ParallelBufferPoolManager::GetPoolSize() {
   return num_instances_ * pool_size_;
 }
 
+void ParallelBufferPoolManager::StartBackgroundWriter(size_t clean_frame_target) {
+  StopBackgroundWriter();
+  std::vector<BufferPoolManagerInstance *> instances;
+  for (size_t i = 0; i < num_instances_; i++) {
+    instances.push_back(static_cast<BufferPoolManagerInstance *>(bpm_table_[i]));
+  }
+  background_writer_ = std::make_unique<BackgroundWriter>(std::move(instances), disk_manager_, clean_frame_target);
+  background_writer_->Run();
+}
+
+void ParallelBufferPoolManager::StopBackgroundWriter() {
+  if (background_writer_ != nullptr) {
+    background_writer_->Stop();
+    background_writer_.reset();
+  }
+}
+
 BufferPoolManager *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
   // Get BufferPoolManager responsible for handling given page id. You can use this method in your other methods.
   size_t index = page_id % num_instances_;
   return this->bpm_table_[index];
 }
 
+void ParallelBufferPoolManager::PrefetchPages(const std::vector<page_id_t> &page_ids) {
+  std::vector<std::vector<page_id_t>> per_instance(num_instances_);
+  for (page_id_t page_id : page_ids) {
+    per_instance[page_id % num_instances_].push_back(page_id);
+  }
+  for (size_t i = 0; i < num_instances_; i++) {
+    if (!per_instance[i].empty()) {
+      bpm_table_[i]->PrefetchPages(per_instance[i]);
+    }
+  }
+}
+
+size_t ParallelBufferPoolManager::GetReadAheadWindow() {
+  // all instances share the disk manager and pool size, so they read ahead alike
+  return bpm_table_[0]->GetReadAheadWindow();
+}
+
 Page *ParallelBufferPoolManager::FetchPgImp(page_id_t page_id) {
   // Fetch page for page_id from responsible BufferPoolManagerInstance
   size_t index = page_id % num_instances_;
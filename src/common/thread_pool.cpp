@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// thread_pool.cpp
+//
+// Identification: src/common/thread_pool.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/thread_pool.h"
+
+#include <utility>
+
+namespace bustub {
+
+ThreadPool::~ThreadPool() {
+  {
+    std::scoped_lock lock(latch_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  std::scoped_lock lock(latch_);
+  BUSTUB_ASSERT(!stopping_, "task submitted after shutdown");
+  tasks_.push_back(std::move(task));
+  if (idle_workers_ < tasks_.size()) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+  } else {
+    cv_.notify_one();
+  }
+}
+
+size_t ThreadPool::Size() {
+  std::scoped_lock lock(latch_);
+  return workers_.size();
+}
+
+void ThreadPool::WorkerLoop() {
+  std::unique_lock lock(latch_);
+  while (true) {
+    idle_workers_++;
+    cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+    idle_workers_--;
+    if (tasks_.empty()) {
+      return;
+    }
+    std::function<void()> task = std::move(tasks_.front());
+    tasks_.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+}  // namespace bustub
@@ -1,63 +1,377 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// aggregation_executor.cpp
-//
-// Identification: src/execution/aggregation_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include <memory>
-#include <vector>
-
-#include "execution/executors/aggregation_executor.h"
-
-namespace bustub {
-
-AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
-                                         std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx),
-      plan_(plan),
-      child_(std::move(child)),
-      aht_(plan->GetAggregates(), plan->GetAggregateTypes()),
-      aht_iterator_(aht_.Begin()) {}
-
-void AggregationExecutor::Init() {
-  child_->Init();
-  Tuple tuple;
-  RID rid;
-  while (child_->Next(&tuple, &rid)) {
-    AggregateKey key = MakeAggregateKey(&tuple);
-    AggregateValue value = MakeAggregateValue(&tuple);
-    aht_.InsertCombine(key, value);
-  }
-  aht_iterator_ = aht_.Begin();
-}
-
-bool AggregationExecutor::Next(Tuple *tuple, RID *rid) {
-  while (true) {
-    if (aht_iterator_ == aht_.End()) {
-      return false;
-    }
-    AggregateKey aggregate_key = aht_iterator_.Key();
-    AggregateValue aggregate_value = aht_iterator_.Val();
-    if (plan_->GetHaving() != nullptr &&
-        !plan_->GetHaving()->EvaluateAggregate(aggregate_key.group_bys_, aggregate_value.aggregates_).GetAs<bool>()) {
-      ++aht_iterator_;
-      continue;
-    }
-    std::vector<Value> values;
-    for (auto &col : GetOutputSchema()->GetColumns()) {
-      values.push_back(col.GetExpr()->EvaluateAggregate(aggregate_key.group_bys_, aggregate_value.aggregates_));
-    }
-    *tuple = Tuple(values, GetOutputSchema());
-    ++aht_iterator_;
-    return true;
-  }
-}
-
-const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/executor_factory.h"
+#include "execution/executors/aggregation_executor.h"
+
+namespace bustub {
+
+class AggregationExecutor::SharedState {
+ public:
+  /** @param exec_ctx the context of a copy, for the memory budget and buffer pool, which the state may outlive */
+  SharedState(const AggregationPlanNode *plan, size_t num_workers, ExecutorContext *exec_ctx)
+      : plan_(plan),
+        num_workers_(num_workers),
+        budget_(exec_ctx->ShareMemoryBudget()),
+        input_schema_(plan->GetChildPlan()->OutputSchema()) {
+    // a few partitions per copy, so that a copy that is done with its partitions early takes on more
+    while ((size_t{1} << partition_bits_) < PARTITIONS_PER_WORKER * num_workers) {
+      partition_bits_++;
+    }
+    partitions_.resize(size_t{1} << partition_bits_);
+    spill_files_.resize(partitions_.size());
+    spill_latches_ = std::vector<std::mutex>(partitions_.size());
+  }
+
+  ~SharedState() {
+    for (const Partial &partial : partials_) {
+      budget_->Release(partial.reserved_);
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(SharedState);
+
+  /**
+   * Run a copy: aggregate the rows of its child into a table of its own, wait for the other copies to do the same, then
+   * merge partitions until there are none left.
+   * @param exec_ctx the context of the copy
+   * @param child the child executor of the copy
+   * @param[out] merged the partitions this copy merged
+   */
+  void Run(ExecutorContext *exec_ctx, AbstractExecutor *child, std::vector<HybridHashAggregation *> *merged) {
+    Partial partial{MakeTable(), std::vector<std::vector<size_t>>(partitions_.size()), 0};
+    try {
+      child->Init();
+      TupleBatch batch(child->GetOutputSchema());
+      std::vector<std::pair<size_t, hash_t>> rejected;
+      while (child->NextBatch(&batch)) {
+        if (!spilling_.load()) {
+          partial.table_->InsertBatch(batch);
+          if (!FitInBudget(&partial)) {
+            spilling_ = true;
+          }
+          continue;
+        }
+        // the budget is spent: the rows update the groups of the copy, and the rows of new keys wait on disk
+        rejected.clear();
+        partial.table_->UpdateBatch(batch, &rejected);
+        for (const auto &[row, hash] : rejected) {
+          size_t partition = PartitionOf(hash);
+          Tuple tuple = batch.GetTuple(row);
+          std::scoped_lock lock(spill_latches_[partition]);
+          std::unique_ptr<TmpTupleFile> &file = spill_files_[partition];
+          if (file == nullptr) {
+            file = std::make_unique<TmpTupleFile>(exec_ctx->GetBufferPoolManager());
+            num_spilled_partitions_++;
+          }
+          file->Append(tuple);
+          spilled_bytes_ += tuple.GetLength();
+        }
+      }
+    } catch (...) {
+      budget_->Release(partial.reserved_);
+      Abandon(std::current_exception());
+      throw;
+    }
+    AddPartial(std::move(partial));
+    for (size_t partition = next_partition_++; partition < partitions_.size(); partition = next_partition_++) {
+      merged->push_back(MergePartition(exec_ctx, partition));
+    }
+  }
+
+  /** @return the number of partitions the copies spilled rows to, before merging */
+  size_t NumSpilledPartitions() const { return num_spilled_partitions_.load(); }
+
+  /** @return the bytes of rows the copies spilled, before merging */
+  size_t GetSpilledBytes() const { return spilled_bytes_.load(); }
+
+  /** @return the merged partitions, once every copy is done */
+  std::vector<HybridHashAggregation *> GetPartitions() const {
+    std::vector<HybridHashAggregation *> partitions;
+    for (const auto &partition : partitions_) {
+      partitions.push_back(partition.get());
+    }
+    return partitions;
+  }
+
+ private:
+  /** The groups one copy aggregated, and the groups of each partition among them */
+  struct Partial {
+    std::unique_ptr<AggregationHashTable> table_;
+    std::vector<std::vector<size_t>> partitions_;
+    /** The bytes reserved from the budget for the table */
+    size_t reserved_;
+  };
+
+  static constexpr size_t PARTITIONS_PER_WORKER = 4;
+
+  std::unique_ptr<AggregationHashTable> MakeTable() const {
+    return std::make_unique<AggregationHashTable>(plan_->GetGroupBys(), plan_->GetAggregates(),
+                                                  plan_->GetAggregateTypes());
+  }
+
+  /** @return the partition of a key hash: its top bits, which the merged table of the partition leaves out */
+  size_t PartitionOf(hash_t hash) const {
+    return partition_bits_ == 0 ? 0 : hash >> (sizeof(hash_t) * 8 - partition_bits_);
+  }
+
+  /** Reserve memory for the table of a copy as it grows; @return false if the budget does not allow it */
+  bool FitInBudget(Partial *partial) {
+    size_t memory = partial->table_->MemoryUsage();
+    if (memory <= partial->reserved_) {
+      return true;
+    }
+    bool fits = budget_->TryReserve(memory - partial->reserved_);
+    if (!fits) {
+      // the table holds the memory already
+      budget_->Reserve(memory - partial->reserved_);
+    }
+    partial->reserved_ = memory;
+    return fits;
+  }
+
+  /** Hand in the table of a copy, and wait for every other copy to hand in theirs; throws if one of them failed. */
+  void AddPartial(Partial partial) {
+    for (size_t group = 0; group < partial.table_->NumGroups(); group++) {
+      partial.partitions_[PartitionOf(partial.table_->GetGroupHash(group))].push_back(group);
+    }
+    std::unique_lock lock(latch_);
+    partials_.push_back(std::move(partial));
+    num_arrived_++;
+    cv_.notify_all();
+    cv_.wait(lock, [&] { return error_ != nullptr || num_arrived_ == num_workers_; });
+    if (error_ != nullptr) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+  /** Give up on the aggregation, so that the copies waiting for this one fail as well. */
+  void Abandon(std::exception_ptr error) {
+    std::scoped_lock lock(latch_);
+    if (error_ == nullptr) {
+      error_ = std::move(error);
+    }
+    cv_.notify_all();
+  }
+
+  /**
+   * @return the aggregation of a partition: its groups in the table of every copy merged, then the rows the copies
+   * spilled for it added, which spill again where they do not fit
+   */
+  HybridHashAggregation *MergePartition(ExecutorContext *exec_ctx, size_t partition) {
+    auto aggregation = std::make_unique<HybridHashAggregation>(
+        exec_ctx, plan_->GetGroupBys(), plan_->GetAggregates(), plan_->GetAggregateTypes(), partition_bits_);
+    for (const Partial &partial : partials_) {
+      aggregation->MergeGroups(*partial.table_, partial.partitions_[partition]);
+    }
+    if (spill_files_[partition] != nullptr) {
+      // one partition at a time, so that the pages the partitions spill to again take few frames at once
+      std::scoped_lock lock(merge_latch_);
+      std::unique_ptr<TmpTupleFile> file = std::move(spill_files_[partition]);
+      file->Rewind();
+      TupleBatch batch(input_schema_);
+      Tuple tuple;
+      while (file->Next(&tuple)) {
+        batch.AppendTuple(tuple, RID());
+        if (batch.IsFull()) {
+          aggregation->InsertBatch(batch);
+          batch.Clear();
+        }
+      }
+      if (!batch.IsEmpty()) {
+        aggregation->InsertBatch(batch);
+      }
+      aggregation->FinishInput();
+    }
+    partitions_[partition] = std::move(aggregation);
+    if (++num_merged_ == partitions_.size()) {
+      // every partition is merged, so nobody reads the tables of the copies anymore
+      for (const Partial &partial : partials_) {
+        budget_->Release(partial.reserved_);
+      }
+      partials_.clear();
+    }
+    return partitions_[partition].get();
+  }
+
+  const AggregationPlanNode *plan_;
+  const size_t num_workers_;
+  std::shared_ptr<MemoryBudget> budget_;
+  size_t partition_bits_{0};
+  /** The schema of the rows of the copies, for reading spilled rows back */
+  const Schema *input_schema_;
+  /** Set once a copy's table outgrows the budget, after which no copy adds groups to its table */
+  std::atomic<bool> spilling_{false};
+  /**
+   * The rows of new keys the copies spilled once the budget was spent, by partition; each file is appended to under its
+   * latch, and read by the copy that merges its partition
+   */
+  std::vector<std::unique_ptr<TmpTupleFile>> spill_files_;
+  std::vector<std::mutex> spill_latches_;
+  /** Held while adding the spilled rows of a partition to its aggregation */
+  std::mutex merge_latch_;
+  std::atomic<size_t> num_spilled_partitions_{0};
+  std::atomic<size_t> spilled_bytes_{0};
+
+  /**
+   * Protects partials_, num_arrived_ and error_ until every copy handed in its table. The copies are counted apart
+   * from their tables, which go away once every partition is merged, possibly before all copies stopped waiting.
+   */
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::vector<Partial> partials_;
+  size_t num_arrived_{0};
+  std::exception_ptr error_;
+
+  /** The aggregation of each partition, the next partition to merge, and the number merged */
+  std::vector<std::unique_ptr<HybridHashAggregation>> partitions_;
+  std::atomic<size_t> next_partition_{0};
+  std::atomic<size_t> num_merged_{0};
+};
+
+AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      aggregation_(exec_ctx, plan->GetGroupBys(), plan->GetAggregates(), plan->GetAggregateTypes()) {}
+
+void AggregationExecutor::Init() {
+  aggregations_.clear();
+  next_aggregation_ = 0;
+  next_group_ = 0;
+  ResetNextFromBatch();
+  size_t num_workers = exec_ctx_->GetNumWorkers();
+  if (num_workers > 1) {
+    // a copy of a plan fragment: the copies share the work through the state of the fragment
+    if (state_ != nullptr) {
+      throw Exception(ExceptionType::NOT_IMPLEMENTED, "A copy of a parallel aggregation cannot be restarted.");
+    }
+    state_ = exec_ctx_->GetOperatorStates()->GetOrCreate<SharedState>(
+        plan_, [&] { return std::make_shared<SharedState>(plan_, num_workers, exec_ctx_); });
+    state_->Run(exec_ctx_, child_.get(), &aggregations_);
+    return;
+  }
+  if (exec_ctx_->GetParallelism() > 1) {
+    InitParallel(exec_ctx_->GetParallelism());
+    return;
+  }
+
+  state_.reset();
+  child_->Init();
+  aggregation_.Clear();
+  TupleBatch batch(child_->GetOutputSchema());
+  while (child_->NextBatch(&batch)) {
+    aggregation_.InsertBatch(batch);
+  }
+  aggregations_.push_back(&aggregation_);
+}
+
+void AggregationExecutor::InitParallel(size_t num_workers) {
+  state_ = std::make_shared<SharedState>(plan_, num_workers, exec_ctx_);
+  auto operator_states = std::make_shared<OperatorStateRegistry>();
+  std::vector<std::unique_ptr<ExecutorContext>> worker_ctxs;
+  std::vector<std::unique_ptr<AbstractExecutor>> workers;
+  for (size_t i = 0; i < num_workers; i++) {
+    worker_ctxs.push_back(std::make_unique<ExecutorContext>(exec_ctx_, i, num_workers, operator_states));
+    workers.push_back(ExecutorFactory::CreateExecutor(worker_ctxs.back().get(), plan_->GetChildPlan()));
+  }
+
+  std::mutex latch;
+  std::condition_variable cv;
+  size_t num_done = 0;
+  std::exception_ptr error;
+  ThreadPool *thread_pool = exec_ctx_->GetThreadPool();
+  for (size_t i = 0; i < num_workers; i++) {
+    thread_pool->Submit([&, i] {
+      std::vector<HybridHashAggregation *> merged;
+      std::exception_ptr worker_error;
+      try {
+        state_->Run(worker_ctxs[i].get(), workers[i].get(), &merged);
+      } catch (...) {
+        worker_error = std::current_exception();
+      }
+      workers[i].reset();
+      std::scoped_lock lock(latch);
+      if (error == nullptr) {
+        error = worker_error;
+      }
+      num_done++;
+      cv.notify_all();
+    });
+  }
+  std::unique_lock lock(latch);
+  cv.wait(lock, [&] { return num_done == num_workers; });
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+  aggregations_ = state_->GetPartitions();
+}
+
+bool AggregationExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+size_t AggregationExecutor::NumSpilledPartitions() const {
+  size_t num_spilled = state_ != nullptr ? state_->NumSpilledPartitions() : 0;
+  for (const HybridHashAggregation *aggregation : aggregations_) {
+    num_spilled += aggregation->NumSpilledPartitions();
+  }
+  return num_spilled;
+}
+
+size_t AggregationExecutor::GetSpilledBytes() const {
+  size_t spilled_bytes = state_ != nullptr ? state_->GetSpilledBytes() : 0;
+  for (const HybridHashAggregation *aggregation : aggregations_) {
+    spilled_bytes += aggregation->GetSpilledBytes();
+  }
+  return spilled_bytes;
+}
+
+bool AggregationExecutor::NextBatch(TupleBatch *batch) {
+  batch->Clear();
+  const std::vector<Column> &columns = GetOutputSchema()->GetColumns();
+  std::vector<Value> values(columns.size());
+  std::vector<Value> group_bys;
+  std::vector<Value> aggregates;
+  while (!batch->IsFull() && next_aggregation_ < aggregations_.size()) {
+    HybridHashAggregation *aggregation = aggregations_[next_aggregation_];
+    const AggregationHashTable &table = aggregation->GetTable();
+    if (next_group_ == table.NumGroups()) {
+      // the table takes the groups of each spilled partition in turn
+      if (!aggregation->NextPartition()) {
+        next_aggregation_++;
+      }
+      next_group_ = 0;
+      continue;
+    }
+    table.GetGroup(next_group_++, &group_bys, &aggregates);
+    if (plan_->GetHaving() != nullptr && !plan_->GetHaving()->EvaluateAggregate(group_bys, aggregates).GetAs<bool>()) {
+      continue;
+    }
+    for (uint32_t i = 0; i < columns.size(); i++) {
+      values[i] = columns[i].GetExpr()->EvaluateAggregate(group_bys, aggregates);
+    }
+    batch->AppendValues(values);
+  }
+  return !batch->IsEmpty();
+}
+
+const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
+
+}  // namespace bustub
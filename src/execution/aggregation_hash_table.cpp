@@ -0,0 +1,438 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table.cpp
+//
+// Identification: src/execution/aggregation_hash_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/aggregation_hash_table.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+int64_t AsInt(uint64_t word) { return static_cast<int64_t>(word); }
+
+uint64_t FromInt(int64_t value) { return static_cast<uint64_t>(value); }
+
+double AsDouble(uint64_t word) {
+  double value;
+  memcpy(&value, &word, sizeof(double));
+  return value;
+}
+
+uint64_t FromDouble(double value) {
+  uint64_t word;
+  memcpy(&word, &value, sizeof(double));
+  return word;
+}
+
+/** Pack the serialized values of a column, as stored in a ColumnVector, skipping the type's NULL sentinel. */
+template <typename T, typename Pack>
+void ReadRaw(const char *data, size_t n, T null_value, Pack pack, uint64_t *words, uint64_t *null_flags,
+             uint64_t null_bit, size_t stride) {
+  for (size_t row = 0; row < n; row++) {
+    T raw;
+    memcpy(&raw, data + row * sizeof(T), sizeof(T));
+    if (raw == null_value) {
+      null_flags[row * stride] |= null_bit;
+    } else {
+      words[row * stride] = pack(raw);
+    }
+  }
+}
+
+/** Call visit with the function that folds an input into the state of a SUM, MIN or MAX that has a value. */
+template <typename Visit>
+void VisitCombine(AggregationType agg_type, bool is_decimal, Visit &&visit) {
+  switch (agg_type) {
+    case AggregationType::SumAggregate:
+      if (is_decimal) {
+        visit([](uint64_t state, uint64_t input) { return FromDouble(AsDouble(state) + AsDouble(input)); });
+      } else {
+        visit([](uint64_t state, uint64_t input) {
+          int64_t sum;
+          if (__builtin_add_overflow(AsInt(state), AsInt(input), &sum)) {
+            throw Exception(ExceptionType::OUT_OF_RANGE, "SUM is out of range.");
+          }
+          return FromInt(sum);
+        });
+      }
+      break;
+    case AggregationType::MinAggregate:
+      if (is_decimal) {
+        visit([](uint64_t state, uint64_t input) { return AsDouble(input) < AsDouble(state) ? input : state; });
+      } else {
+        visit([](uint64_t state, uint64_t input) { return AsInt(input) < AsInt(state) ? input : state; });
+      }
+      break;
+    case AggregationType::MaxAggregate:
+      if (is_decimal) {
+        visit([](uint64_t state, uint64_t input) { return AsDouble(input) > AsDouble(state) ? input : state; });
+      } else {
+        visit([](uint64_t state, uint64_t input) { return AsInt(input) > AsInt(state) ? input : state; });
+      }
+      break;
+    case AggregationType::CountAggregate:
+      break;
+  }
+}
+
+}  // namespace
+
+AggregationHashTable::AggregationHashTable(const std::vector<const AbstractExpression *> &group_bys,
+                                           const std::vector<const AbstractExpression *> &aggregates,
+                                           const std::vector<AggregationType> &agg_types)
+    : agg_types_(agg_types),
+      key_words_(1 + group_bys.size()),
+      agg_offset_(key_words_),
+      group_words_(key_words_ + 1 + aggregates.size()) {
+  BUSTUB_ASSERT(group_bys.size() <= 64 && aggregates.size() <= 64, "a flag word covers at most 64 columns");
+  auto make_input = [](const AbstractExpression *expr) {
+    const auto *column = dynamic_cast<const ColumnValueExpression *>(expr);
+    return Input{expr, column == nullptr ? -1 : static_cast<int64_t>(column->GetColIdx()), expr->GetReturnType()};
+  };
+  for (const AbstractExpression *expr : group_bys) {
+    keys_.push_back(make_input(expr));
+    if (keys_.back().type_ == TypeId::VARCHAR) {
+      varchar_keys_.push_back(keys_.size() - 1);
+    }
+  }
+  for (size_t i = 0; i < aggregates.size(); i++) {
+    aggregates_.push_back(make_input(aggregates[i]));
+    if (agg_types_[i] != AggregationType::CountAggregate && aggregates_[i].type_ == TypeId::VARCHAR) {
+      throw Exception(ExceptionType::MISMATCH_TYPE, "SUM, MIN and MAX need a numeric input.");
+    }
+  }
+  Clear();
+}
+
+void AggregationHashTable::InsertBatch(const TupleBatch &batch, std::vector<size_t> *created) {
+  AddBatch<true>(batch, created, nullptr);
+}
+
+void AggregationHashTable::UpdateBatch(const TupleBatch &batch, std::vector<std::pair<size_t, hash_t>> *rejected) {
+  AddBatch<false>(batch, nullptr, rejected);
+}
+
+template <bool CreateGroups>
+void AggregationHashTable::AddBatch(const TupleBatch &batch, std::vector<size_t> *created,
+                                    std::vector<std::pair<size_t, hash_t>> *rejected) {
+  size_t n = batch.Size();
+  batch_keys_.assign(n * key_words_, 0);
+  for (size_t k = 0; k < keys_.size(); k++) {
+    ReadInput(keys_[k], batch, &batch_keys_[1 + k], batch_keys_.data(), uint64_t{1} << k, key_words_, true);
+  }
+  // hash all keys first, so that the cache misses on the slots overlap
+  batch_hashes_.resize(n);
+  for (size_t row = 0; row < n; row++) {
+    batch_hashes_[row] = HashKey(&batch_keys_[row * key_words_]);
+    __builtin_prefetch(&slots_[batch_hashes_[row] & mask_]);
+  }
+  batch_groups_.resize(n);
+  for (size_t row = 0; row < n; row++) {
+    size_t num_words = groups_.size();
+    batch_groups_[row] = FindGroup<CreateGroups>(&batch_keys_[row * key_words_], batch_hashes_[row]);
+    if (!CreateGroups && batch_groups_[row] == NO_GROUP) {
+      rejected->emplace_back(row, batch_hashes_[row]);
+    } else if (CreateGroups && created != nullptr && groups_.size() != num_words) {
+      created->push_back(row);
+    }
+  }
+
+  for (size_t i = 0; i < aggregates_.size(); i++) {
+    size_t offset = agg_offset_ + 1 + i;
+    if (agg_types_[i] == AggregationType::CountAggregate) {
+      for (size_t row = 0; row < n; row++) {
+        if (CreateGroups || batch_groups_[row] != NO_GROUP) {
+          groups_[batch_groups_[row] * group_words_ + offset]++;
+        }
+      }
+      continue;
+    }
+    batch_values_.assign(n, 0);
+    batch_nulls_.assign(n, 0);
+    ReadInput(aggregates_[i], batch, batch_values_.data(), batch_nulls_.data(), 1, 1, false);
+    uint64_t valid_bit = uint64_t{1} << i;
+    auto update = [&](auto combine) {
+      for (size_t row = 0; row < n; row++) {
+        if (batch_nulls_[row] != 0 || (!CreateGroups && batch_groups_[row] == NO_GROUP)) {
+          continue;
+        }
+        uint64_t *group = &groups_[batch_groups_[row] * group_words_];
+        if ((group[agg_offset_] & valid_bit) == 0) {
+          group[agg_offset_] |= valid_bit;
+          group[offset] = batch_values_[row];
+        } else {
+          group[offset] = combine(group[offset], batch_values_[row]);
+        }
+      }
+    };
+    VisitCombine(agg_types_[i], aggregates_[i].type_ == TypeId::DECIMAL, update);
+  }
+}
+
+void AggregationHashTable::ReadInput(const Input &input, const TupleBatch &batch, uint64_t *words,
+                                     uint64_t *null_flags, uint64_t null_bit, size_t stride, bool is_key) {
+  size_t n = batch.Size();
+  if (input.col_idx_ >= 0) {
+    const ColumnVector &column = batch.GetColumn(input.col_idx_);
+    const char *data = column.GetData();
+    if (column.GetType() == input.type_ && column.IsInlined()) {
+      auto to_int = [](auto raw) { return FromInt(raw); };
+      switch (input.type_) {
+        case TypeId::BOOLEAN:
+          ReadRaw<int8_t>(data, n, BUSTUB_BOOLEAN_NULL, to_int, words, null_flags, null_bit, stride);
+          return;
+        case TypeId::TINYINT:
+          ReadRaw<int8_t>(data, n, BUSTUB_INT8_NULL, to_int, words, null_flags, null_bit, stride);
+          return;
+        case TypeId::SMALLINT:
+          ReadRaw<int16_t>(data, n, BUSTUB_INT16_NULL, to_int, words, null_flags, null_bit, stride);
+          return;
+        case TypeId::INTEGER:
+          ReadRaw<int32_t>(data, n, BUSTUB_INT32_NULL, to_int, words, null_flags, null_bit, stride);
+          return;
+        case TypeId::BIGINT:
+          ReadRaw<int64_t>(data, n, BUSTUB_INT64_NULL, to_int, words, null_flags, null_bit, stride);
+          return;
+        case TypeId::TIMESTAMP:
+          ReadRaw<uint64_t>(
+              data, n, BUSTUB_TIMESTAMP_NULL, [](uint64_t raw) { return raw; }, words, null_flags, null_bit, stride);
+          return;
+        case TypeId::DECIMAL:
+          // 0.0 and -0.0 are one key
+          ReadRaw<double>(
+              data, n, BUSTUB_DECIMAL_NULL, [is_key](double raw) { return FromDouble(is_key && raw == 0 ? 0.0 : raw); },
+              words, null_flags, null_bit, stride);
+          return;
+        default:
+          break;
+      }
+    }
+  }
+  for (size_t row = 0; row < n; row++) {
+    Value value = input.expr_->EvaluateRow(&batch, row);
+    if (value.IsNull()) {
+      null_flags[row * stride] |= null_bit;
+    } else {
+      words[row * stride] = PackValue(input, value, is_key);
+    }
+  }
+}
+
+uint64_t AggregationHashTable::PackValue(const Input &input, const Value &value, bool is_key) {
+  if (value.GetTypeId() != input.type_) {
+    return PackValue(input, value.CastAs(input.type_), is_key);
+  }
+  switch (input.type_) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return FromInt(value.GetAs<int8_t>());
+    case TypeId::SMALLINT:
+      return FromInt(value.GetAs<int16_t>());
+    case TypeId::INTEGER:
+      return FromInt(value.GetAs<int32_t>());
+    case TypeId::BIGINT:
+      return FromInt(value.GetAs<int64_t>());
+    case TypeId::TIMESTAMP:
+      return value.GetAs<uint64_t>();
+    case TypeId::DECIMAL: {
+      double raw = value.GetAs<double>();
+      return FromDouble(is_key && raw == 0 ? 0.0 : raw);
+    }
+    case TypeId::VARCHAR:
+      return InternString(value.ToString());
+    default:
+      UNREACHABLE("Unsupported aggregation input type.");
+  }
+}
+
+uint64_t AggregationHashTable::InternString(std::string string) {
+  auto [iter, inserted] = string_ids_.emplace(string, strings_.size());
+  if (inserted) {
+    string_hashes_.push_back(HashUtil::HashBytesMixed(string.data(), string.size()));
+    strings_.push_back(std::move(string));
+  }
+  return iter->second;
+}
+
+hash_t AggregationHashTable::HashKey(const uint64_t *key) {
+  size_t bytes = key_words_ * sizeof(uint64_t);
+  if (varchar_keys_.empty()) {
+    return HashUtil::HashBytesMixed(reinterpret_cast<const char *>(key), bytes);
+  }
+  hash_key_.assign(key, key + key_words_);
+  for (size_t k : varchar_keys_) {
+    if (((key[0] >> k) & 1) == 0) {
+      hash_key_[1 + k] = string_hashes_[key[1 + k]];
+    }
+  }
+  return HashUtil::HashBytesMixed(reinterpret_cast<const char *>(hash_key_.data()), bytes);
+}
+
+Value AggregationHashTable::UnpackValue(TypeId type, uint64_t word) const {
+  switch (type) {
+    case TypeId::BOOLEAN:
+      return ValueFactory::GetBooleanValue(static_cast<int8_t>(AsInt(word)));
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(static_cast<int8_t>(AsInt(word)));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(static_cast<int16_t>(AsInt(word)));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(static_cast<int32_t>(AsInt(word)));
+    case TypeId::BIGINT:
+      return ValueFactory::GetBigIntValue(AsInt(word));
+    case TypeId::TIMESTAMP:
+      return ValueFactory::GetTimestampValue(AsInt(word));
+    case TypeId::DECIMAL:
+      return ValueFactory::GetDecimalValue(AsDouble(word));
+    case TypeId::VARCHAR:
+      return ValueFactory::GetVarcharValue(strings_[word]);
+    default:
+      UNREACHABLE("Unsupported aggregation input type.");
+  }
+}
+
+template <bool CreateGroups>
+size_t AggregationHashTable::FindGroup(const uint64_t *key, hash_t hash) {
+  if (CreateGroups && (NumGroups() + 1) * 2 > slots_.size()) {
+    Grow();
+  }
+  for (size_t s = hash & mask_;; s = (s + 1) & mask_) {
+    Slot &slot = slots_[s];
+    if (slot.group_ == 0) {
+      if (!CreateGroups) {
+        return NO_GROUP;
+      }
+      size_t group = NumGroups();
+      groups_.insert(groups_.end(), key, key + key_words_);
+      groups_.resize(groups_.size() + group_words_ - key_words_, 0);
+      group_hashes_.push_back(hash);
+      slot.hash_ = hash;
+      slot.group_ = group + 1;
+      return group;
+    }
+    if (slot.hash_ == hash && std::equal(key, key + key_words_, &groups_[(slot.group_ - 1) * group_words_])) {
+      return slot.group_ - 1;
+    }
+  }
+}
+
+void AggregationHashTable::Grow() {
+  std::vector<Slot> old_slots = std::move(slots_);
+  slots_.assign(old_slots.size() * 2, Slot{0, 0});
+  mask_ = slots_.size() - 1;
+  for (const Slot &old_slot : old_slots) {
+    if (old_slot.group_ == 0) {
+      continue;
+    }
+    size_t s = old_slot.hash_ & mask_;
+    while (slots_[s].group_ != 0) {
+      s = (s + 1) & mask_;
+    }
+    slots_[s] = old_slot;
+  }
+}
+
+void AggregationHashTable::MergeGroup(const AggregationHashTable &other, size_t group) {
+  const uint64_t *other_group = &other.groups_[group * group_words_];
+  // the strings of the key have other indexes here
+  hash_key_.assign(other_group, other_group + key_words_);
+  for (size_t k : varchar_keys_) {
+    if (((hash_key_[0] >> k) & 1) == 0) {
+      hash_key_[1 + k] = InternString(other.strings_[hash_key_[1 + k]]);
+    }
+  }
+  uint64_t *words = &groups_[FindGroup<true>(hash_key_.data(), other.group_hashes_[group]) * group_words_];
+
+  for (size_t i = 0; i < aggregates_.size(); i++) {
+    size_t offset = agg_offset_ + 1 + i;
+    uint64_t valid_bit = uint64_t{1} << i;
+    if (agg_types_[i] == AggregationType::CountAggregate) {
+      words[offset] += other_group[offset];
+    } else if ((other_group[agg_offset_] & valid_bit) == 0) {
+      continue;
+    } else if ((words[agg_offset_] & valid_bit) == 0) {
+      words[agg_offset_] |= valid_bit;
+      words[offset] = other_group[offset];
+    } else {
+      VisitCombine(agg_types_[i], aggregates_[i].type_ == TypeId::DECIMAL,
+                   [&](auto combine) { words[offset] = combine(words[offset], other_group[offset]); });
+    }
+  }
+}
+
+void AggregationHashTable::GetGroup(size_t group, std::vector<Value> *group_bys,
+                                    std::vector<Value> *aggregates) const {
+  const uint64_t *words = &groups_[group * group_words_];
+  group_bys->clear();
+  for (size_t k = 0; k < keys_.size(); k++) {
+    bool is_null = ((words[0] >> k) & 1) != 0;
+    group_bys->push_back(is_null ? ValueFactory::GetNullValueByType(keys_[k].type_)
+                                 : UnpackValue(keys_[k].type_, words[1 + k]));
+  }
+  aggregates->clear();
+  for (size_t i = 0; i < aggregates_.size(); i++) {
+    uint64_t state = words[agg_offset_ + 1 + i];
+    bool valid = ((words[agg_offset_] >> i) & 1) != 0;
+    TypeId type = aggregates_[i].type_;
+    switch (agg_types_[i]) {
+      case AggregationType::CountAggregate:
+        aggregates->push_back(ValueFactory::GetIntegerValue(static_cast<int32_t>(state)));
+        break;
+      case AggregationType::SumAggregate: {
+        // the sum has the type of the input widened to at least INTEGER
+        TypeId sum_type = type == TypeId::DECIMAL ? TypeId::DECIMAL
+                          : type == TypeId::BIGINT || type == TypeId::TIMESTAMP ? TypeId::BIGINT
+                                                                                : TypeId::INTEGER;
+        if (!valid) {
+          aggregates->push_back(ValueFactory::GetNullValueByType(sum_type));
+        } else if (sum_type == TypeId::INTEGER &&
+                   (AsInt(state) > BUSTUB_INT32_MAX || AsInt(state) < BUSTUB_INT32_MIN)) {
+          throw Exception(ExceptionType::OUT_OF_RANGE, "SUM is out of range.");
+        } else {
+          aggregates->push_back(UnpackValue(sum_type, state));
+        }
+        break;
+      }
+      case AggregationType::MinAggregate:
+      case AggregationType::MaxAggregate:
+        aggregates->push_back(valid ? UnpackValue(type, state) : ValueFactory::GetNullValueByType(type));
+        break;
+    }
+  }
+}
+
+size_t AggregationHashTable::MemoryUsage() const {
+  size_t bytes = groups_.capacity() * sizeof(uint64_t) + group_hashes_.capacity() * sizeof(hash_t) +
+                 slots_.size() * sizeof(Slot);
+  for (const std::string &string : strings_) {
+    // once in the dictionary and once as its key, with its hash and its index
+    bytes += 2 * (sizeof(std::string) + string.capacity()) + sizeof(hash_t) + sizeof(uint64_t);
+  }
+  return bytes;
+}
+
+void AggregationHashTable::Clear() {
+  groups_ = std::vector<uint64_t>();
+  group_hashes_ = std::vector<hash_t>();
+  slots_ = std::vector<Slot>(INITIAL_SLOTS, Slot{0, 0});
+  mask_ = INITIAL_SLOTS - 1;
+  strings_ = std::vector<std::string>();
+  string_hashes_ = std::vector<hash_t>();
+  string_ids_ = std::unordered_map<std::string, uint64_t>();
+}
+
+}  // namespace bustub
@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_channel.cpp
+//
+// Identification: src/execution/batch_channel.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/batch_channel.h"
+
+#include <thread>  // NOLINT
+#include <utility>
+
+namespace bustub {
+
+BatchChannel::BatchChannel(size_t capacity, size_t num_producers)
+    : queue_(capacity), num_producers_(num_producers) {}
+
+void BatchChannel::Wait(size_t *round, uint64_t seen) {
+  static constexpr size_t SPIN_ROUNDS = 64;
+  static constexpr size_t YIELD_ROUNDS = 256;
+  (*round)++;
+  if (*round < SPIN_ROUNDS) {
+    return;
+  }
+  if (*round < YIELD_ROUNDS) {
+    std::this_thread::yield();
+    return;
+  }
+  // Notify() counts the change before it looks for waiters, and a waiter registers before it looks at the count; both
+  // are sequentially consistent, so either the waiter sees the change or Notify() sees the waiter and wakes it up.
+  std::unique_lock lock(wait_latch_);
+  num_waiters_++;
+  wait_cv_.wait(lock, [this, seen] { return events_ != seen; });
+  num_waiters_--;
+}
+
+void BatchChannel::Notify() {
+  events_++;
+  if (num_waiters_ > 0) {
+    {
+      // a waiter between registering and blocking holds the latch, so it cannot miss the notification
+      std::scoped_lock lock(wait_latch_);
+    }
+    wait_cv_.notify_all();
+  }
+}
+
+bool BatchChannel::Push(std::unique_ptr<TupleBatch> batch) {
+  size_t round = 0;
+  while (true) {
+    uint64_t seen = events_;
+    if (closed_) {
+      return false;
+    }
+    if (queue_.TryPush(&batch)) {
+      Notify();
+      return true;
+    }
+    Wait(&round, seen);
+  }
+}
+
+void BatchChannel::ProducerDone(std::exception_ptr error) {
+  if (error != nullptr) {
+    std::scoped_lock lock(error_latch_);
+    if (error_ == nullptr) {
+      error_ = std::move(error);
+      failed_ = true;
+    }
+  }
+  // Under the latch, which WaitForProducers() takes before it returns, so that the channel outlives this call.
+  std::scoped_lock lock(wait_latch_);
+  done_producers_.fetch_add(1);
+  events_++;
+  wait_cv_.notify_all();
+}
+
+void BatchChannel::WaitForProducers() {
+  size_t round = 0;
+  while (true) {
+    uint64_t seen = events_;
+    if (done_producers_ == num_producers_) {
+      break;
+    }
+    Wait(&round, seen);
+  }
+  // the last producer may still be notifying
+  std::scoped_lock lock(wait_latch_);
+}
+
+bool BatchChannel::NextPending(bool dont_wait) {
+  size_t round = 0;
+  while (true) {
+    uint64_t seen = events_;
+    if (failed_) {
+      std::scoped_lock lock(error_latch_);
+      std::rethrow_exception(error_);
+    }
+    if (queue_.TryPop(&pending_)) {
+      pending_row_ = 0;
+      Notify();
+      return true;
+    }
+    if (dont_wait) {
+      return false;
+    }
+    if (done_producers_ == num_producers_) {
+      // the producers pushed their last batches before they reported done
+      if (queue_.TryPop(&pending_)) {
+        pending_row_ = 0;
+        return true;
+      }
+      return false;
+    }
+    Wait(&round, seen);
+  }
+}
+
+bool BatchChannel::NextBatch(TupleBatch *batch) {
+  batch->Clear();
+  while (!batch->IsFull()) {
+    if (pending_ == nullptr || pending_row_ >= pending_->Size()) {
+      if (!NextPending(!batch->IsEmpty())) {
+        break;
+      }
+      if (batch->IsEmpty() && pending_->GetSchema() == batch->GetSchema() &&
+          pending_->Capacity() == batch->Capacity()) {
+        // hand the pushed batch over as it is; pending_ keeps the emptied one
+        std::swap(*batch, *pending_);
+        pending_row_ = pending_->Size();
+        break;
+      }
+      continue;
+    }
+    batch->AppendRow(*pending_, pending_row_++);
+  }
+  return !batch->IsEmpty();
+}
+
+}  // namespace bustub
@@ -14,29 +14,79 @@
 
 namespace bustub {
 
+namespace {
+
+std::vector<const AbstractExpression *> Pointers(const std::vector<std::unique_ptr<ColumnValueExpression>> &columns) {
+  std::vector<const AbstractExpression *> pointers;
+  for (const auto &column : columns) {
+    pointers.push_back(column.get());
+  }
+  return pointers;
+}
+
+}  // namespace
+
 DistinctExecutor::DistinctExecutor(ExecutorContext *exec_ctx, const DistinctPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)), iterator_(dht_.Begin()) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      columns_(MakeColumns(child_executor_->GetOutputSchema())),
+      distinct_(exec_ctx, Pointers(columns_), {}, {}) {}
+
+std::vector<std::unique_ptr<ColumnValueExpression>> DistinctExecutor::MakeColumns(const Schema *schema) {
+  std::vector<std::unique_ptr<ColumnValueExpression>> columns;
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    columns.push_back(std::make_unique<ColumnValueExpression>(0, i, schema->GetColumn(i).GetType()));
+  }
+  return columns;
+}
 
 void DistinctExecutor::Init() {
   child_executor_->Init();
-  Tuple tuple;
-  RID rid;
-  while (child_executor_->Next(&tuple, &rid)) {
-    DistinctKey key = MakeDistinctKey(&tuple);
-    dht_.Insert(key);
-  }
-  iterator_ = dht_.Begin();
+  distinct_.Clear();
+  child_batch_ = std::make_unique<TupleBatch>(child_executor_->GetOutputSchema());
+  child_done_ = false;
+  next_group_ = 0;
+  ResetNextFromBatch();
 }
 
-bool DistinctExecutor::Next(Tuple *tuple, RID *rid) {
-  if (iterator_ == dht_.End()) {
-    return false;
+bool DistinctExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool DistinctExecutor::NextBatch(TupleBatch *batch) {
+  batch->Clear();
+  while (!child_done_) {
+    if (!child_executor_->NextBatch(child_batch_.get())) {
+      // the groups in memory went out as their first rows came in
+      child_done_ = true;
+      next_group_ = distinct_.GetTable().NumGroups();
+      break;
+    }
+    first_rows_.clear();
+    distinct_.InsertBatch(*child_batch_, &first_rows_);
+    for (size_t row : first_rows_) {
+      batch->AppendRow(*child_batch_, row);
+    }
+    if (!batch->IsEmpty()) {
+      return true;
+    }
+  }
+
+  std::vector<Value> values;
+  std::vector<Value> aggregates;
+  while (!batch->IsFull()) {
+    if (next_group_ == distinct_.GetTable().NumGroups()) {
+      // the table takes the rows of each spilled partition in turn
+      next_group_ = 0;
+      if (!distinct_.NextPartition()) {
+        break;
+      }
+      continue;
+    }
+    distinct_.GetTable().GetGroup(next_group_++, &values, &aggregates);
+    batch->AppendValues(values);
   }
-  DistinctKey key = iterator_.Key();
-  *tuple = Tuple(key.distinct_key_, GetOutputSchema());
-  ++iterator_;
-  return true;
+  return !batch->IsEmpty();
 }
 
 }  // namespace bustub
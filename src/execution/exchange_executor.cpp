@@ -0,0 +1,164 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_executor.cpp
+//
+// Identification: src/execution/exchange_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/exchange_executor.h"
+
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/executor_factory.h"
+#include "execution/join_hash_table.h"
+
+namespace bustub {
+
+class ExchangeExecutor::SharedState {
+ public:
+  /** Start the producers, one per partition. */
+  SharedState(ExecutorContext *exec_ctx, const ExchangePlanNode *plan, size_t num_partitions) : plan_(plan) {
+    auto operator_states = std::make_shared<OperatorStateRegistry>();
+    for (size_t i = 0; i < num_partitions; i++) {
+      channels_.push_back(std::make_unique<BatchChannel>(EXCHANGE_QUEUE_BATCHES, num_partitions));
+      producer_ctxs_.push_back(std::make_unique<ExecutorContext>(exec_ctx, i, num_partitions, operator_states));
+      producers_.push_back(ExecutorFactory::CreateExecutor(producer_ctxs_.back().get(), plan_->GetChildPlan()));
+    }
+    ThreadPool *thread_pool = exec_ctx->GetThreadPool();
+    for (size_t i = 0; i < num_partitions; i++) {
+      thread_pool->Submit([this, i] { Produce(i); });
+    }
+  }
+
+  /** Stop the producers and wait for them. */
+  ~SharedState() {
+    for (auto &channel : channels_) {
+      channel->Close();
+    }
+    for (auto &channel : channels_) {
+      channel->WaitForProducers();
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(SharedState);
+
+  /** @return the channel of a partition */
+  BatchChannel *GetChannel(size_t partition) { return channels_[partition].get(); }
+
+ private:
+  /** Body of the task that runs a producer. */
+  void Produce(size_t producer_idx);
+
+  /**
+   * @return the partition of a row of a batch of the child's output
+   * @param key scratch space for the serialized key of the row
+   */
+  size_t Partition(const TupleBatch &batch, size_t row, std::vector<char> *key) const;
+
+  const ExchangePlanNode *plan_;
+  std::vector<std::unique_ptr<BatchChannel>> channels_;
+  std::vector<std::unique_ptr<ExecutorContext>> producer_ctxs_;
+  /** The producers; a producer is released by its task as soon as it is done */
+  std::vector<std::unique_ptr<AbstractExecutor>> producers_;
+};
+
+size_t ExchangeExecutor::SharedState::Partition(const TupleBatch &batch, size_t row, std::vector<char> *key) const {
+  // keys are hashed in the form the hash join compares them in, so that e.g. 5 and 5.0 meet in one partition
+  key->clear();
+  if (!JoinHashTable::SerializeKey(plan_->GetPartitionBy(), &batch, row, key)) {
+    // a key with a NULL joins nothing; any partition does, as long as equal keys share it
+    return 0;
+  }
+  return JoinHashTable::HashKey(key->data(), key->size()) % channels_.size();
+}
+
+void ExchangeExecutor::SharedState::Produce(size_t producer_idx) {
+  // the state goes away once the last channel hears from the last producer, so keep to locals from then on
+  std::vector<BatchChannel *> channels;
+  for (auto &channel : channels_) {
+    channels.push_back(channel.get());
+  }
+  size_t num_partitions = channels.size();
+  std::exception_ptr error;
+  try {
+    AbstractExecutor *producer = producers_[producer_idx].get();
+    producer->Init();
+    const Schema *schema = plan_->OutputSchema();
+    std::vector<std::unique_ptr<TupleBatch>> outputs(num_partitions);
+    for (auto &output : outputs) {
+      output = std::make_unique<TupleBatch>(schema);
+    }
+    // a partition whose copy closed its channel takes no more tuples
+    std::vector<bool> closed(num_partitions, false);
+    size_t num_open = num_partitions;
+    auto flush = [&](size_t partition) {
+      if (!channels[partition]->Push(std::move(outputs[partition]))) {
+        closed[partition] = true;
+        num_open--;
+      }
+      outputs[partition] = std::make_unique<TupleBatch>(schema);
+    };
+
+    TupleBatch input(producer->GetOutputSchema());
+    std::vector<char> key;
+    size_t next_partition = producer_idx;
+    while (num_open > 0 && producer->NextBatch(&input)) {
+      bool round_robin = plan_->GetPartitionBy().empty();
+      for (size_t row = 0; row < input.Size(); row++) {
+        size_t partition = round_robin ? next_partition : Partition(input, row, &key);
+        if (closed[partition]) {
+          continue;
+        }
+        outputs[partition]->AppendRow(input, row);
+        if (outputs[partition]->IsFull()) {
+          flush(partition);
+        }
+      }
+      next_partition = (next_partition + 1) % num_partitions;
+    }
+    for (size_t partition = 0; partition < num_partitions; partition++) {
+      if (!closed[partition] && !outputs[partition]->IsEmpty()) {
+        flush(partition);
+      }
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+  producers_[producer_idx].reset();
+  for (BatchChannel *channel : channels) {
+    channel->ProducerDone(error);
+  }
+}
+
+ExchangeExecutor::ExchangeExecutor(ExecutorContext *exec_ctx, const ExchangePlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+ExchangeExecutor::~ExchangeExecutor() {
+  if (channel_ != nullptr) {
+    channel_->Close();
+  }
+}
+
+void ExchangeExecutor::Init() {
+  if (state_ != nullptr) {
+    throw Exception(ExceptionType::NOT_IMPLEMENTED, "An exchange cannot be restarted.");
+  }
+  ResetNextFromBatch();
+  size_t num_partitions = exec_ctx_->GetNumWorkers();
+  auto create_state = [&] { return std::make_shared<SharedState>(exec_ctx_, plan_, num_partitions); };
+  OperatorStateRegistry *operator_states = exec_ctx_->GetOperatorStates();
+  state_ = operator_states == nullptr ? create_state() : operator_states->GetOrCreate<SharedState>(plan_, create_state);
+  channel_ = state_->GetChannel(exec_ctx_->GetWorkerIndex());
+}
+
+bool ExchangeExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool ExchangeExecutor::NextBatch(TupleBatch *batch) { return channel_->NextBatch(batch); }
+
+}  // namespace bustub
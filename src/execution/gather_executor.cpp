@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.cpp
+//
+// Identification: src/execution/gather_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/gather_executor.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include "execution/executor_factory.h"
+
+namespace bustub {
+
+GatherExecutor::GatherExecutor(ExecutorContext *exec_ctx, const GatherPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+GatherExecutor::~GatherExecutor() { StopFragments(); }
+
+void GatherExecutor::Init() {
+  StopFragments();
+  ResetNextFromBatch();
+  size_t num_workers = std::max<size_t>(plan_->GetNumWorkers(), 1);
+  auto operator_states = std::make_shared<OperatorStateRegistry>();
+  for (size_t i = 0; i < num_workers; i++) {
+    fragment_ctxs_.push_back(std::make_unique<ExecutorContext>(exec_ctx_, i, num_workers, operator_states));
+    fragments_.push_back(ExecutorFactory::CreateExecutor(fragment_ctxs_.back().get(), plan_->GetChildPlan()));
+  }
+  channel_ = std::make_unique<BatchChannel>(EXCHANGE_QUEUE_BATCHES, num_workers);
+  ThreadPool *thread_pool = exec_ctx_->GetThreadPool();
+  for (size_t i = 0; i < num_workers; i++) {
+    thread_pool->Submit([this, i] { RunFragment(i); });
+  }
+}
+
+bool GatherExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool GatherExecutor::NextBatch(TupleBatch *batch) { return channel_->NextBatch(batch); }
+
+void GatherExecutor::RunFragment(size_t worker_idx) {
+  BatchChannel *channel = channel_.get();
+  std::exception_ptr error;
+  try {
+    AbstractExecutor *fragment = fragments_[worker_idx].get();
+    fragment->Init();
+    auto batch = std::make_unique<TupleBatch>(fragment->GetOutputSchema());
+    while (fragment->NextBatch(batch.get())) {
+      if (!channel->Push(std::move(batch))) {
+        break;
+      }
+      batch = std::make_unique<TupleBatch>(fragment->GetOutputSchema());
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+  // let go of what the copy holds, such as its partition of an exchange, without waiting for the other copies
+  fragments_[worker_idx].reset();
+  channel->ProducerDone(error);
+}
+
+void GatherExecutor::StopFragments() {
+  if (channel_ != nullptr) {
+    channel_->Close();
+    channel_->WaitForProducers();
+  }
+  fragments_.clear();
+  fragment_ctxs_.clear();
+  channel_.reset();
+}
+
+}  // namespace bustub
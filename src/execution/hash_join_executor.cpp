@@ -12,8 +12,26 @@
 
 #include "execution/executors/hash_join_executor.h"
 
+#include <algorithm>
+
+#include "execution/expressions/column_value_expression.h"
+
 namespace bustub {
 
+namespace {
+
+/** Read the next batch of tuples from a file of spilled rows. */
+bool ReadBatch(TmpTupleFile *file, TupleBatch *batch) {
+  batch->Clear();
+  Tuple tuple;
+  while (!batch->IsFull() && file->Next(&tuple)) {
+    batch->AppendTuple(tuple, RID());
+  }
+  return !batch->IsEmpty();
+}
+
+}  // namespace
+
 HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&left_child,
                                    std::unique_ptr<AbstractExecutor> &&right_child)
@@ -23,52 +41,344 @@ HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlan
   right_child_ = std::move(right_child);
 }
 
+HashJoinExecutor::~HashJoinExecutor() {
+  ReleaseMemory();
+  GetExecutorContext()->GetMemoryBudget()->Release(filter_reserved_);
+}
+
 void HashJoinExecutor::Init() {
-  left_child_->Init();
   right_child_->Init();
-  idx_ = 0;
-  Tuple tuple;
-  RID rid;
-  AbstractExpression *right = const_cast<AbstractExpression *>(plan_->RightJoinKeyExpression());
-  AbstractPlanNode *right_plan = const_cast<AbstractPlanNode *>(plan_->GetRightPlan());
-  while (right_child_->Next(&tuple, &rid)) {
-    int32_t key = right->Evaluate(&tuple, right_plan->OutputSchema()).GetAs<int32_t>();
-    right_ht_[key].push_back(tuple);
+  current_.reset();
+  pending_.clear();
+  level_ = 0;
+  chunked_ = false;
+  build_done_ = false;
+  MemoryBudget *budget = GetExecutorContext()->GetMemoryBudget();
+  budget->Release(filter_reserved_);
+  filter_reserved_ = 0;
+  runtime_filter_.reset();
+  std::vector<const AbstractExpression *> scan_keys;
+  if (PushdownKeys(&scan_keys)) {
+    ReserveBuildFilter();
+  }
+  Build();
+  if (build_filter_ != nullptr) {
+    build_filter_->ShrinkToFit();
+    budget->Release(filter_reserved_ - build_filter_->MemoryUsage());
+    filter_reserved_ = build_filter_->MemoryUsage();
+    // the left child is initialized after the filter is pushed down, so that its scan picks the filter up
+    runtime_filter_ = std::make_shared<RuntimeFilter>(std::move(scan_keys), std::move(*build_filter_));
+    GetExecutorContext()->SetRuntimeFilter(plan_->GetLeftPlan(), runtime_filter_);
+    build_filter_.reset();
   }
-  left_child_->Next(&left_tuple_, &left_rid_);
+  left_child_->Init();
+  left_batch_ = std::make_unique<TupleBatch>(left_child_->GetOutputSchema());
+  left_row_ = 0;
+  left_done_ = false;
+  probed_ = false;
+  match_ = nullptr;
+  ResetNextFromBatch();
 }
 
-Tuple HashJoinExecutor::CombineTuple(Tuple *left, Tuple *right) {
-  std::vector<Value> values;
-  for (auto &col : GetOutputSchema()->GetColumns()) {
-    values.push_back(
-        col.GetExpr()->EvaluateJoin(left, left_child_->GetOutputSchema(), right, right_child_->GetOutputSchema()));
+void HashJoinExecutor::Build() {
+  ReleaseMemory();
+  right_batches_.clear();
+  right_ht_.Clear();
+  partitions_.clear();
+  memory_ = 0;
+  MemoryBudget *budget = GetExecutorContext()->GetMemoryBudget();
+  const std::vector<const AbstractExpression *> &right_keys = plan_->RightJoinKeyExpressions();
+  std::vector<char> key;
+  size_t batches_memory = 0;
+  while (!build_done_) {
+    auto batch = std::make_unique<TupleBatch>(right_child_->GetOutputSchema());
+    if (!NextBuildBatch(batch.get())) {
+      build_done_ = true;
+      break;
+    }
+    if (!partitions_.empty()) {
+      for (size_t row = 0; row < batch->Size(); row++) {
+        key.clear();
+        if (JoinHashTable::SerializeKey(right_keys, batch.get(), row, &key)) {
+          hash_t hash = JoinHashTable::HashKey(key.data(), key.size());
+          if (build_filter_ != nullptr) {
+            build_filter_->Insert(hash);
+          }
+          AddToPartition(*batch, row, key, hash);
+        }
+      }
+      FitPartitionsInBudget();
+      continue;
+    }
+    batches_memory += batch->MemoryUsage();
+    InsertBatch(std::move(batch), build_filter_.get());
+    memory_ = batches_memory + right_ht_.MemoryUsage();
+    if (budget->TryReserve(memory_ - reserved_)) {
+      reserved_ = memory_;
+      continue;
+    }
+    if (chunked_) {
+      // the chunk ends here; it keeps the batch that did not fit, so that every chunk has rows
+      budget->Reserve(memory_ - reserved_);
+      reserved_ = memory_;
+      break;
+    }
+    StartPartitioning();
+  }
+  for (Partition &partition : partitions_) {
+    if (partition.build_file_ != nullptr) {
+      partition.build_file_->Rewind();
+      continue;
+    }
+    for (auto &batch : partition.batches_) {
+      InsertBatch(std::move(batch));
+    }
+    partition.batches_.clear();
   }
-  return Tuple{values, GetOutputSchema()};
 }
 
-bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) {
-  Tuple right_tuple;
-  if (left_rid_.GetPageId() == INVALID_PAGE_ID) {
+bool HashJoinExecutor::PushdownKeys(std::vector<const AbstractExpression *> *scan_keys) const {
+  const AbstractPlanNode *left_plan = plan_->GetLeftPlan();
+  if (left_plan->GetType() != PlanType::SeqScan) {
     return false;
   }
-  AbstractExpression *left = const_cast<AbstractExpression *>(plan_->LeftJoinKeyExpression());
-  AbstractPlanNode *left_plan = const_cast<AbstractPlanNode *>(plan_->GetLeftPlan());
-  int32_t key = left->Evaluate(&left_tuple_, left_plan->OutputSchema()).GetAs<int32_t>();
-  while (true) {
-    if (idx_ >= right_ht_[key].size()) {
-      if (!left_child_->Next(&left_tuple_, &left_rid_)) {
-        return false;
+  // the scan filters its rows before projecting them, so the keys have to be put in terms of the table's columns
+  for (const AbstractExpression *key : plan_->LeftJoinKeyExpressions()) {
+    const auto *column = dynamic_cast<const ColumnValueExpression *>(key);
+    if (column == nullptr) {
+      return false;
+    }
+    const AbstractExpression *expr = left_plan->OutputSchema()->GetColumn(column->GetColIdx()).GetExpr();
+    if (expr == nullptr) {
+      return false;
+    }
+    scan_keys->push_back(expr);
+  }
+  return true;
+}
+
+void HashJoinExecutor::ReserveBuildFilter() {
+  MemoryBudget *budget = GetExecutorContext()->GetMemoryBudget();
+  size_t limit = budget->GetLimit();
+  size_t reserved = budget->GetReserved();
+  size_t max_bytes = std::min(reserved < limit ? (limit - reserved) / FILTER_BUDGET_SHARE : 0, MAX_FILTER_BYTES);
+  // filters come in powers of two of blocks
+  size_t num_keys = max_bytes * 8 / BloomFilter::BITS_PER_KEY;
+  while (num_keys > 0 && BloomFilter::MemoryUsage(num_keys) > max_bytes) {
+    num_keys /= 2;
+  }
+  // the memory is better spent on the build side than on a filter too small to drop much
+  if (num_keys == 0 || !budget->TryReserve(BloomFilter::MemoryUsage(num_keys))) {
+    return;
+  }
+  filter_reserved_ = BloomFilter::MemoryUsage(num_keys);
+  build_filter_ = std::make_unique<BloomFilter>(num_keys);
+}
+
+void HashJoinExecutor::InsertBatch(std::unique_ptr<TupleBatch> &&batch, BloomFilter *filter) {
+  const std::vector<const AbstractExpression *> &right_keys = plan_->RightJoinKeyExpressions();
+  auto batch_idx = static_cast<uint32_t>(right_batches_.size());
+  std::vector<char> key;
+  for (uint32_t row = 0; row < batch->Size(); row++) {
+    key.clear();
+    if (JoinHashTable::SerializeKey(right_keys, batch.get(), row, &key)) {
+      hash_t hash = JoinHashTable::HashKey(key.data(), key.size());
+      right_ht_.Insert(key.data(), key.size(), hash, batch_idx, row);
+      if (filter != nullptr) {
+        filter->Insert(hash);
+      }
+    }
+  }
+  right_batches_.push_back(std::move(batch));
+}
+
+void HashJoinExecutor::StartPartitioning() {
+  partitions_.resize(NUM_PARTITIONS);
+  memory_ = 0;
+  const std::vector<const AbstractExpression *> &right_keys = plan_->RightJoinKeyExpressions();
+  std::vector<char> key;
+  for (const auto &batch : right_batches_) {
+    for (size_t row = 0; row < batch->Size(); row++) {
+      key.clear();
+      if (JoinHashTable::SerializeKey(right_keys, batch.get(), row, &key)) {
+        AddToPartition(*batch, row, key, JoinHashTable::HashKey(key.data(), key.size()));
+      }
+    }
+  }
+  right_batches_.clear();
+  right_ht_.Clear();
+  FitPartitionsInBudget();
+}
+
+void HashJoinExecutor::AddToPartition(const TupleBatch &batch, size_t row, const std::vector<char> &key,
+                                      hash_t hash) {
+  Partition &partition = partitions_[PartitionOf(hash, level_)];
+  if (partition.build_file_ != nullptr) {
+    partition.build_file_->Append(batch.GetTuple(row));
+    return;
+  }
+  if (partition.batches_.empty() || partition.batches_.back()->IsFull()) {
+    partition.batches_.push_back(std::make_unique<TupleBatch>(batch.GetSchema()));
+  }
+  partition.batches_.back()->AppendRow(batch, row);
+  size_t bytes = batch.MemoryUsage(row) + JoinHashTable::EstimateMemoryUsage(key.size());
+  partition.memory_ += bytes;
+  memory_ += bytes;
+}
+
+void HashJoinExecutor::FitPartitionsInBudget() {
+  MemoryBudget *budget = GetExecutorContext()->GetMemoryBudget();
+  while (memory_ > reserved_ && !budget->TryReserve(memory_ - reserved_)) {
+    // the largest partition frees the most memory per partition spilled
+    Partition *largest = nullptr;
+    for (Partition &partition : partitions_) {
+      if (partition.build_file_ == nullptr && (largest == nullptr || partition.memory_ > largest->memory_)) {
+        largest = &partition;
+      }
+    }
+    BufferPoolManager *bpm = GetExecutorContext()->GetBufferPoolManager();
+    largest->build_file_ = std::make_unique<TmpTupleFile>(bpm);
+    largest->probe_file_ = std::make_unique<TmpTupleFile>(bpm);
+    for (const auto &batch : largest->batches_) {
+      for (size_t row = 0; row < batch->Size(); row++) {
+        largest->build_file_->Append(batch->GetTuple(row));
+      }
+    }
+    largest->batches_.clear();
+    memory_ -= largest->memory_;
+    largest->memory_ = 0;
+    num_spilled_partitions_++;
+  }
+  if (memory_ > reserved_) {
+    reserved_ = memory_;
+  } else {
+    budget->Release(reserved_ - memory_);
+    reserved_ = memory_;
+  }
+}
+
+void HashJoinExecutor::ReleaseMemory() {
+  GetExecutorContext()->GetMemoryBudget()->Release(reserved_);
+  reserved_ = 0;
+}
+
+bool HashJoinExecutor::NextPhase() {
+  if (!build_done_) {
+    // the next chunk of a skewed partition, joined with all of its probe side again
+    Build();
+    current_->probe_file_->Rewind();
+  } else {
+    for (Partition &partition : partitions_) {
+      if (partition.build_file_ != nullptr && partition.probe_file_->NumTuples() > 0) {
+        bool skewed = current_ != nullptr && partition.build_file_->NumTuples() == current_->build_file_->NumTuples();
+        partition.probe_file_->Rewind();
+        pending_.push_back(
+            SpilledPartition{std::move(partition.build_file_), std::move(partition.probe_file_), level_ + 1, skewed});
+      }
+    }
+    partitions_.clear();
+    right_batches_.clear();
+    right_ht_.Clear();
+    ReleaseMemory();
+    if (pending_.empty()) {
+      current_.reset();
+      return false;
+    }
+    // the partitions spilled last are joined first, so that those split off a partition go before its siblings
+    current_ = std::make_unique<SpilledPartition>(std::move(pending_.back()));
+    pending_.pop_back();
+    level_ = current_->level_;
+    chunked_ = current_->skewed_ || level_ >= MAX_PARTITION_LEVELS;
+    build_done_ = false;
+    Build();
+  }
+  left_batch_->Clear();
+  left_row_ = 0;
+  left_done_ = false;
+  probed_ = false;
+  match_ = nullptr;
+  return true;
+}
+
+bool HashJoinExecutor::NextBuildBatch(TupleBatch *batch) {
+  if (current_ == nullptr) {
+    return right_child_->NextBatch(batch);
+  }
+  return ReadBatch(current_->build_file_.get(), batch);
+}
+
+bool HashJoinExecutor::NextProbeBatch(TupleBatch *batch) {
+  if (current_ == nullptr) {
+    return left_child_->NextBatch(batch);
+  }
+  return ReadBatch(current_->probe_file_.get(), batch);
+}
+
+void HashJoinExecutor::PrepareProbe() {
+  const std::vector<const AbstractExpression *> &left_keys = plan_->LeftJoinKeyExpressions();
+  left_keys_.clear();
+  left_key_offsets_.assign(1, 0);
+  left_hashes_.clear();
+  for (size_t row = 0; row < left_batch_->Size(); row++) {
+    size_t offset = left_keys_.size();
+    bool valid = JoinHashTable::SerializeKey(left_keys, left_batch_.get(), row, &left_keys_);
+    hash_t hash = valid ? JoinHashTable::HashKey(left_keys_.data() + offset, left_keys_.size() - offset) : 0;
+    if (valid && !partitions_.empty()) {
+      Partition &partition = partitions_[PartitionOf(hash, level_)];
+      if (partition.probe_file_ != nullptr) {
+        // joined later, together with the build rows of its partition
+        partition.probe_file_->Append(left_batch_->GetTuple(row));
+        left_keys_.resize(offset);
+        valid = false;
+      }
+    }
+    left_key_offsets_.push_back(left_keys_.size());
+    left_hashes_.push_back(valid ? hash : 0);
+    if (valid) {
+      // overlap the cache misses of the whole batch instead of taking them one probe at a time
+      right_ht_.Prefetch(hash);
+    }
+  }
+}
+
+bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool HashJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Clear();
+  const std::vector<Column> &columns = GetOutputSchema()->GetColumns();
+  std::vector<Value> values(columns.size());
+  while (!batch->IsFull()) {
+    if (left_row_ >= left_batch_->Size()) {
+      if (left_done_ || !NextProbeBatch(left_batch_.get())) {
+        left_done_ = true;
+        if (!NextPhase()) {
+          break;
+        }
+        continue;
       }
-      key = left->Evaluate(&left_tuple_, left_plan->OutputSchema()).GetAs<int32_t>();
-      idx_ = 0;
+      left_row_ = 0;
+      PrepareProbe();
+    }
+    if (!probed_) {
+      probed_ = true;
+      size_t offset = left_key_offsets_[left_row_];
+      size_t size = left_key_offsets_[left_row_ + 1] - offset;
+      match_ = size == 0 ? nullptr : right_ht_.Find(left_keys_.data() + offset, size, left_hashes_[left_row_]);
+    }
+    if (match_ == nullptr) {
+      probed_ = false;
+      left_row_++;
       continue;
     }
-    right_tuple = right_ht_[key][idx_];
-    idx_++;
-    *tuple = CombineTuple(&left_tuple_, &right_tuple);
-    return true;
+    const JoinHashTable::RowEntry *match = match_;
+    match_ = match_->next_;
+    const TupleBatch *right_batch = right_batches_[match->batch_idx_].get();
+    for (uint32_t i = 0; i < columns.size(); i++) {
+      values[i] = columns[i].GetExpr()->EvaluateJoinRow(left_batch_.get(), left_row_, right_batch, match->row_);
+    }
+    batch->AppendValues(values);
   }
+  return !batch->IsEmpty();
 }
 
 }  // namespace bustub
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hybrid_hash_aggregation.cpp
+//
+// Identification: src/execution/hybrid_hash_aggregation.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/hybrid_hash_aggregation.h"
+
+#include <utility>
+
+namespace bustub {
+
+HybridHashAggregation::HybridHashAggregation(ExecutorContext *exec_ctx,
+                                             const std::vector<const AbstractExpression *> &group_bys,
+                                             const std::vector<const AbstractExpression *> &aggregates,
+                                             const std::vector<AggregationType> &agg_types, size_t hash_bits)
+    : bpm_(exec_ctx->GetBufferPoolManager()),
+      budget_(exec_ctx->ShareMemoryBudget()),
+      hash_bits_(hash_bits),
+      table_(group_bys, aggregates, agg_types) {
+  // the hash has to leave bits for every level of partitions
+  BUSTUB_ASSERT(hash_bits_ + PARTITION_BITS * (MAX_PARTITION_LEVELS + 1) <= 8 * sizeof(hash_t),
+                "Too few hash bits left to partition by.");
+}
+
+HybridHashAggregation::~HybridHashAggregation() { ReleaseMemory(); }
+
+void HybridHashAggregation::InsertBatch(const TupleBatch &batch, std::vector<size_t> *created) {
+  if (!spilling_) {
+    table_.InsertBatch(batch, created);
+    if (!FitInBudget()) {
+      // the groups so far stay in memory, but no new ones join them
+      spilling_ = true;
+      input_schema_ = batch.GetSchema();
+      files_.resize(NUM_PARTITIONS);
+    }
+    return;
+  }
+  rejected_.clear();
+  table_.UpdateBatch(batch, &rejected_);
+  for (const auto &[row, hash] : rejected_) {
+    std::unique_ptr<TmpTupleFile> &file = files_[PartitionOf(hash, level_)];
+    if (file == nullptr) {
+      file = std::make_unique<TmpTupleFile>(bpm_);
+      num_spilled_partitions_++;
+    }
+    Tuple tuple = batch.GetTuple(row);
+    file->Append(tuple);
+    spilled_bytes_ += tuple.GetLength();
+  }
+}
+
+void HybridHashAggregation::MergeGroups(const AggregationHashTable &other, const std::vector<size_t> &groups) {
+  BUSTUB_ASSERT(!spilling_ && pending_.empty(), "Cannot merge groups once rows have spilled.");
+  for (size_t group : groups) {
+    table_.MergeGroup(other, group);
+  }
+  size_t memory = table_.MemoryUsage();
+  if (memory > reserved_) {
+    budget_->Reserve(memory - reserved_);
+    reserved_ = memory;
+  }
+}
+
+bool HybridHashAggregation::NextPartition() {
+  FinishSpilling();
+  table_.Clear();
+  ReleaseMemory();
+  if (pending_.empty()) {
+    return false;
+  }
+  SpilledPartition partition = std::move(pending_.back());
+  pending_.pop_back();
+  level_ = partition.level_;
+  TupleBatch batch(input_schema_);
+  Tuple tuple;
+  while (partition.file_->Next(&tuple)) {
+    batch.AppendTuple(tuple, RID());
+    if (batch.IsFull()) {
+      InsertBatch(batch);
+      batch.Clear();
+    }
+  }
+  if (!batch.IsEmpty()) {
+    InsertBatch(batch);
+  }
+  return true;
+}
+
+void HybridHashAggregation::Clear() {
+  table_.Clear();
+  ReleaseMemory();
+  files_.clear();
+  pending_.clear();
+  spilling_ = false;
+  level_ = 0;
+}
+
+bool HybridHashAggregation::FitInBudget() {
+  size_t memory = table_.MemoryUsage();
+  if (memory <= reserved_) {
+    return true;
+  }
+  if (budget_->TryReserve(memory - reserved_)) {
+    reserved_ = memory;
+    return true;
+  }
+  // the table holds the memory already; past the last level, or without a group to update, it also keeps growing
+  budget_->Reserve(memory - reserved_);
+  reserved_ = memory;
+  return level_ >= MAX_PARTITION_LEVELS || table_.NumGroups() == 0;
+}
+
+void HybridHashAggregation::FinishSpilling() {
+  for (std::unique_ptr<TmpTupleFile> &file : files_) {
+    if (file != nullptr) {
+      file->Rewind();
+      pending_.push_back(SpilledPartition{std::move(file), level_ + 1});
+    }
+  }
+  files_.clear();
+  spilling_ = false;
+}
+
+void HybridHashAggregation::ReleaseMemory() {
+  budget_->Release(reserved_);
+  reserved_ = 0;
+}
+
+}  // namespace bustub
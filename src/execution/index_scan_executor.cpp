@@ -11,12 +11,164 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include <memory>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {
+  index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_);
+}
+
+void IndexScanExecutor::LockShared(const RID &rid) {
+  Transaction *txn = exec_ctx_->GetTransaction();
+  if (txn->GetIsolationLevel() == IsolationLevel::READ_UNCOMMITTED) {
+    return;
+  }
+  if (txn->GetExclusiveLockSet()->find(rid) != txn->GetExclusiveLockSet()->end() ||
+      txn->GetSharedLockSet()->find(rid) != txn->GetSharedLockSet()->end()) {
+    return;
+  }
+  exec_ctx_->GetLockManager()->LockShared(txn, rid);
+}
+
+void IndexScanExecutor::UnLock(const RID &rid) {
+  Transaction *txn = exec_ctx_->GetTransaction();
+  if (txn->GetIsolationLevel() == IsolationLevel::READ_COMMITTED &&
+      txn->GetExclusiveLockSet()->find(rid) == txn->GetExclusiveLockSet()->end()) {
+    exec_ctx_->GetLockManager()->Unlock(txn, rid);
+  }
+}
+
+void IndexScanExecutor::ComputeBounds() {
+  lower_bound_.reset();
+  upper_bound_.reset();
+  // Only a single comparison between the first key column and a constant narrows the scan.
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(plan_->GetPredicate());
+  if (comparison == nullptr) {
+    return;
+  }
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1));
+  const std::vector<uint32_t> &key_attrs = index_info_->index_->GetKeyAttrs();
+  if (column == nullptr || constant == nullptr || column->GetColIdx() != key_attrs[0]) {
+    return;
+  }
+  Value bound = constant->Evaluate(nullptr, nullptr);
+  // the tree builds its keys with the types of the indexed columns, which the declared key schema need not match
+  TypeId key_type = index_info_->index_->GetKeySchema()->GetColumn(0).GetType();
+  if (bound.GetTypeId() != key_type) {
+    // e.g. an integer literal against a bigint key: widen it, but never narrow a bound lest it exclude matches
+    bool widens = bound.GetTypeId() >= TypeId::TINYINT && key_type <= TypeId::BIGINT && bound.GetTypeId() < key_type;
+    if (!widens) {
+      return;
+    }
+    bound = bound.CastAs(key_type);
+  }
+  switch (comparison->GetComparisonType()) {
+    case ComparisonType::Equal:
+      lower_bound_ = bound;
+      upper_bound_ = bound;
+      upper_inclusive_ = true;
+      break;
+    case ComparisonType::GreaterThan:
+    case ComparisonType::GreaterThanOrEqual:
+      lower_bound_ = bound;
+      break;
+    case ComparisonType::LessThan:
+    case ComparisonType::LessThanOrEqual:
+      upper_bound_ = bound;
+      upper_inclusive_ = comparison->GetComparisonType() == ComparisonType::LessThanOrEqual;
+      break;
+    default:
+      break;
+  }
+}
+
+template <size_t KeySize>
+void IndexScanExecutor::OpenScan() {
+  using KeyType = GenericKey<KeySize>;
+  using Iterator = IndexIterator<KeyType, RID, GenericComparator<KeySize>>;
+  auto *tree = dynamic_cast<BPlusTreeIndex<KeyType, RID, GenericComparator<KeySize>> *>(index_info_->index_.get());
+  BUSTUB_ASSERT(tree != nullptr, "index scans need a B+ tree index");
+
+  Schema *key_schema = tree->GetKeySchema();
+  std::shared_ptr<Iterator> iterator;
+  if (lower_bound_.has_value() && key_schema->GetColumnCount() == 1) {
+    KeyType key;
+    key.SetFromKey(Tuple({*lower_bound_}, key_schema));
+    iterator = std::make_shared<Iterator>(tree->GetBeginIterator(key));
+  } else {
+    // a composite key whose first column alone is bounded still has to start from the beginning
+    iterator = std::make_shared<Iterator>(tree->GetBeginIterator());
+  }
+
+  next_rid_ = [this, iterator, key_schema](RID *rid) {
+    if (iterator->IsEnd()) {
+      return false;
+    }
+    if (upper_bound_.has_value()) {
+      Value key = (**iterator).first.ToValue(key_schema, 0);
+      CmpBool past_end = upper_inclusive_ ? key.CompareGreaterThan(*upper_bound_)
+                                          : key.CompareGreaterThanEquals(*upper_bound_);
+      if (past_end == CmpBool::CmpTrue) {
+        return false;
+      }
+    }
+    *rid = (**iterator).second;
+    ++(*iterator);
+    return true;
+  };
+}
 
-void IndexScanExecutor::Init() {}
+void IndexScanExecutor::Init() {
+  ComputeBounds();
+  switch (index_info_->key_size_) {
+    case 4:
+      OpenScan<4>();
+      break;
+    case 8:
+      OpenScan<8>();
+      break;
+    case 16:
+      OpenScan<16>();
+      break;
+    case 32:
+      OpenScan<32>();
+      break;
+    case 64:
+      OpenScan<64>();
+      break;
+    default:
+      BUSTUB_ASSERT(false, "unsupported index key size");
+  }
+}
 
-bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) {
+  Transaction *txn = exec_ctx_->GetTransaction();
+  RID cur_rid;
+  Tuple cur_tuple;
+  while (next_rid_(&cur_rid)) {
+    LockShared(cur_rid);
+    if (table_info_->table_->GetTuple(cur_rid, &cur_tuple, txn) &&
+        (plan_->GetPredicate() == nullptr ||
+         plan_->GetPredicate()->Evaluate(&cur_tuple, &table_info_->schema_).GetAs<bool>())) {
+      std::vector<Value> values;
+      for (auto &col : GetOutputSchema()->GetColumns()) {
+        values.push_back(col.GetExpr()->Evaluate(&cur_tuple, &(table_info_->schema_)));
+      }
+      *tuple = Tuple(values, GetOutputSchema());
+      *rid = cur_rid;
+      UnLock(cur_rid);
+      return true;
+    }
+    UnLock(cur_rid);
+  }
+  return false;
+}
 
 }  // namespace bustub
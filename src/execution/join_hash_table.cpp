@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table.cpp
+//
+// Identification: src/execution/join_hash_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/join_hash_table.h"
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace bustub {
+
+namespace {
+
+/** Numbers are tagged as whole or not, so that the bytes of a fraction never equal those of a whole number */
+constexpr char WHOLE_NUMBER = 0;
+constexpr char FRACTION = 1;
+
+template <typename T>
+void AppendRaw(T raw, std::vector<char> *key) {
+  auto bytes = reinterpret_cast<const char *>(&raw);
+  key->insert(key->end(), bytes, bytes + sizeof(T));
+}
+
+void AppendWholeNumber(int64_t number, std::vector<char> *key) {
+  key->push_back(WHOLE_NUMBER);
+  AppendRaw(number, key);
+}
+
+}  // namespace
+
+JoinHashTable::JoinHashTable() { Clear(); }
+
+bool JoinHashTable::SerializeKeyColumn(const Value &value, std::vector<char> *key) {
+  if (value.IsNull()) {
+    return false;
+  }
+  switch (value.GetTypeId()) {
+    case TypeId::BOOLEAN:
+      AppendWholeNumber(value.GetAs<int8_t>(), key);
+      break;
+    case TypeId::TINYINT:
+      AppendWholeNumber(value.GetAs<int8_t>(), key);
+      break;
+    case TypeId::SMALLINT:
+      AppendWholeNumber(value.GetAs<int16_t>(), key);
+      break;
+    case TypeId::INTEGER:
+      AppendWholeNumber(value.GetAs<int32_t>(), key);
+      break;
+    case TypeId::BIGINT:
+      AppendWholeNumber(value.GetAs<int64_t>(), key);
+      break;
+    case TypeId::TIMESTAMP:
+      AppendRaw(value.GetAs<uint64_t>(), key);
+      break;
+    case TypeId::DECIMAL: {
+      // a whole number takes the form of the integer it equals, which also makes 0.0 and -0.0 equal
+      double raw = value.GetAs<double>();
+      if (std::trunc(raw) == raw && raw >= -0x1p63 && raw < 0x1p63) {
+        AppendWholeNumber(static_cast<int64_t>(raw), key);
+        break;
+      }
+      key->push_back(FRACTION);
+      AppendRaw(raw, key);
+      break;
+    }
+    case TypeId::VARCHAR: {
+      uint32_t length = value.GetLength();
+      AppendRaw(length, key);
+      key->insert(key->end(), value.GetData(), value.GetData() + length);
+      break;
+    }
+    default:
+      UNREACHABLE("Unsupported join key type.");
+  }
+  return true;
+}
+
+bool JoinHashTable::SerializeKey(const std::vector<const AbstractExpression *> &key_exprs, const TupleBatch *batch,
+                                 size_t row, std::vector<char> *keys) {
+  size_t size = keys->size();
+  for (const AbstractExpression *expr : key_exprs) {
+    if (!SerializeKeyColumn(expr->EvaluateRow(batch, row), keys)) {
+      keys->resize(size);
+      return false;
+    }
+  }
+  return true;
+}
+
+void JoinHashTable::Insert(const char *key, size_t size, hash_t hash, uint32_t batch_idx, uint32_t row) {
+  if ((num_keys_ + 1) * 2 > buckets_.size() * SLOTS_PER_BUCKET) {
+    Grow();
+  }
+  auto *row_entry = reinterpret_cast<RowEntry *>(arena_.Allocate(sizeof(RowEntry), alignof(RowEntry)));
+  row_entry->next_ = nullptr;
+  row_entry->batch_idx_ = batch_idx;
+  row_entry->row_ = row;
+  num_rows_++;
+
+  for (size_t b = hash & mask_;; b = (b + 1) & mask_) {
+    Bucket &bucket = buckets_[b];
+    for (size_t slot = 0; slot < SLOTS_PER_BUCKET; slot++) {
+      KeyEntry *entry = bucket.keys_[slot];
+      if (entry == nullptr) {
+        entry = reinterpret_cast<KeyEntry *>(arena_.Allocate(sizeof(KeyEntry) + size, alignof(KeyEntry)));
+        entry->head_ = row_entry;
+        entry->tail_ = row_entry;
+        entry->size_ = static_cast<uint32_t>(size);
+        memcpy(reinterpret_cast<char *>(entry + 1), key, size);
+        bucket.hashes_[slot] = hash;
+        bucket.keys_[slot] = entry;
+        num_keys_++;
+        return;
+      }
+      if (bucket.hashes_[slot] == hash && KeyEquals(entry, key, size)) {
+        entry->tail_->next_ = row_entry;
+        entry->tail_ = row_entry;
+        return;
+      }
+    }
+  }
+}
+
+void JoinHashTable::Grow() {
+  std::vector<Bucket> old_buckets = std::move(buckets_);
+  buckets_.assign(old_buckets.size() * 2, Bucket{});
+  mask_ = buckets_.size() - 1;
+  for (const Bucket &old_bucket : old_buckets) {
+    for (size_t old_slot = 0; old_slot < SLOTS_PER_BUCKET && old_bucket.keys_[old_slot] != nullptr; old_slot++) {
+      hash_t hash = old_bucket.hashes_[old_slot];
+      bool placed = false;
+      for (size_t b = hash & mask_; !placed; b = (b + 1) & mask_) {
+        Bucket &bucket = buckets_[b];
+        for (size_t slot = 0; slot < SLOTS_PER_BUCKET; slot++) {
+          if (bucket.keys_[slot] == nullptr) {
+            bucket.hashes_[slot] = hash;
+            bucket.keys_[slot] = old_bucket.keys_[old_slot];
+            placed = true;
+            break;
+          }
+        }
+      }
+    }
+  }
+}
+
+void JoinHashTable::Clear() {
+  buckets_.assign(INITIAL_BUCKETS, Bucket{});
+  mask_ = INITIAL_BUCKETS - 1;
+  num_keys_ = 0;
+  num_rows_ = 0;
+  arena_.Clear();
+}
+
+}  // namespace bustub
@@ -21,16 +21,18 @@ LimitExecutor::LimitExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *pla
 void LimitExecutor::Init() {
   child_executor_->Init();
   count_ = 0;
+  ResetNextFromBatch();
 }
 
-bool LimitExecutor::Next(Tuple *tuple, RID *rid) {
-  if (count_ >= plan_->GetLimit()) {
-    return false;
-  }
-  if (!child_executor_->Next(tuple, rid)) {
+bool LimitExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool LimitExecutor::NextBatch(TupleBatch *batch) {
+  batch->Clear();
+  if (count_ >= plan_->GetLimit() || !child_executor_->NextBatch(batch)) {
     return false;
   }
-  count_++;
+  batch->Truncate(plan_->GetLimit() - count_);
+  count_ += batch->Size();
   return true;
 }
 
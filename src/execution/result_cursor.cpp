@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// result_cursor.cpp
+//
+// Identification: src/execution/result_cursor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/result_cursor.h"
+
+#include <utility>
+
+#include "concurrency/transaction_manager.h"
+
+namespace bustub {
+
+ResultCursor::ResultCursor(ExecutorContext *exec_ctx, std::unique_ptr<AbstractExecutor> &&executor)
+    : exec_ctx_(exec_ctx), executor_(std::move(executor)), batch_(executor_->GetOutputSchema()) {}
+
+bool ResultCursor::Fetch() {
+  batch_.Clear();
+  next_row_ = 0;
+  if (done_) {
+    return false;
+  }
+  try {
+    if (!initialized_) {
+      executor_->Init();
+      initialized_ = true;
+    }
+    if (executor_->NextBatch(&batch_)) {
+      return true;
+    }
+  } catch (TransactionAbortException &e) {
+    exec_ctx_->GetTransactionManager()->Abort(TransactionManager::GetTransaction(e.GetTransactionId()));
+    aborted_ = true;
+  } catch (Exception &e) {
+    error_ = e;
+  }
+  batch_.Clear();
+  Close();
+  return false;
+}
+
+bool ResultCursor::Next(Tuple *tuple) {
+  if (next_row_ >= batch_.Size() && !Fetch()) {
+    return false;
+  }
+  *tuple = batch_.GetTuple(next_row_++);
+  return true;
+}
+
+const TupleBatch *ResultCursor::NextBatch() {
+  if (next_row_ >= batch_.Size()) {
+    if (!Fetch()) {
+      return nullptr;
+    }
+  } else if (next_row_ > 0) {
+    // drop the rows Next() has handed out
+    TupleBatch rest(batch_.GetSchema(), batch_.Capacity());
+    for (size_t row = next_row_; row < batch_.Size(); row++) {
+      rest.AppendRow(batch_, row);
+    }
+    std::swap(batch_, rest);
+  }
+  next_row_ = batch_.Size();
+  return &batch_;
+}
+
+void ResultCursor::Close() {
+  done_ = true;
+  // stopping the executor tree joins the tasks of any parallel executors in it
+  executor_.reset();
+}
+
+}  // namespace bustub
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter.cpp
+//
+// Identification: src/execution/runtime_filter.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/runtime_filter.h"
+
+#include <utility>
+
+#include "execution/join_hash_table.h"
+
+namespace bustub {
+
+RuntimeFilter::RuntimeFilter(std::vector<const AbstractExpression *> key_exprs, BloomFilter &&bloom_filter)
+    : key_exprs_(std::move(key_exprs)), bloom_filter_(std::move(bloom_filter)) {}
+
+void RuntimeFilter::Apply(const TupleBatch &batch, SelectionBitmap *selection) {
+  std::vector<char> key;
+  std::vector<hash_t> hashes(batch.Size());
+  size_t checked = 0;
+  size_t eliminated = 0;
+  // hash all keys first, so that the cache misses on the filter overlap
+  for (size_t row = 0; row < batch.Size(); row++) {
+    if (!selection->IsSelected(row)) {
+      continue;
+    }
+    checked++;
+    key.clear();
+    if (!JoinHashTable::SerializeKey(key_exprs_, &batch, row, &key)) {
+      selection->Deselect(row);
+      eliminated++;
+      continue;
+    }
+    hashes[row] = JoinHashTable::HashKey(key.data(), key.size());
+    bloom_filter_.Prefetch(hashes[row]);
+  }
+  for (size_t row = 0; row < batch.Size(); row++) {
+    if (selection->IsSelected(row) && !bloom_filter_.MayContain(hashes[row])) {
+      selection->Deselect(row);
+      eliminated++;
+    }
+  }
+  rows_checked_ += checked;
+  rows_eliminated_ += eliminated;
+}
+
+}  // namespace bustub
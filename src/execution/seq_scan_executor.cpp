@@ -1,72 +1,202 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {
-  plan_ = plan;
-  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
-}
-void SeqScanExecutor::LockShared(const RID &rid) {
-  Transaction *txn = exec_ctx_->GetTransaction();
-  if (txn->GetIsolationLevel() == IsolationLevel::READ_UNCOMMITTED) {
-    return;
-  }
-  if (txn->GetExclusiveLockSet()->find(rid) != txn->GetExclusiveLockSet()->end() ||
-      txn->GetSharedLockSet()->find(rid) != txn->GetSharedLockSet()->end()) {
-    return;
-  }
-  exec_ctx_->GetLockManager()->LockShared(txn, rid);
-}
-
-void SeqScanExecutor::UnLock(const RID &rid) {
-  Transaction *txn = exec_ctx_->GetTransaction();
-  if (txn->GetIsolationLevel() == IsolationLevel::READ_COMMITTED &&
-      txn->GetExclusiveLockSet()->find(rid) == txn->GetExclusiveLockSet()->end()) {
-    exec_ctx_->GetLockManager()->Unlock(txn, rid);
-  }
-}
-
-void SeqScanExecutor::Init() { table_iterator_ = table_info_->table_->Begin(exec_ctx_->GetTransaction()); }
-
-bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
-  if (table_iterator_ == table_info_->table_->End()) {
-    return false;
-  }
-  LockShared(table_iterator_->GetRid());
-  Tuple *cur_tuple = table_iterator_.operator->();
-
-  while (plan_->GetPredicate() != nullptr &&
-         !plan_->GetPredicate()->Evaluate(cur_tuple, &table_info_->schema_).GetAs<bool>()) {
-    UnLock(table_iterator_->GetRid());
-    ++table_iterator_;
-    if (table_iterator_ == table_info_->table_->End()) {
-      return false;
-    }
-    LockShared(table_iterator_->GetRid());
-    cur_tuple = table_iterator_.operator->();
-  }
-  std::vector<Value> values;
-  for (auto &col : GetOutputSchema()->GetColumns()) {
-    Value v = col.GetExpr()->Evaluate(cur_tuple, &(table_info_->schema_));
-    values.push_back(v);
-  }
-  *tuple = Tuple(values, GetOutputSchema());
-  *rid = cur_tuple->GetRid();
-  UnLock(cur_tuple->GetRid());
-  ++table_iterator_;
-  return true;
-}
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/seq_scan_executor.h"
+
+#include <exception>
+#include <utility>
+
+#include "common/exception.h"
+#include "execution/vectorized_filter.h"
+
+namespace bustub {
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {
+  plan_ = plan;
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+}
+void SeqScanExecutor::LockShared(const RID &rid) {
+  Transaction *txn = exec_ctx_->GetTransaction();
+  if (txn->GetIsolationLevel() == IsolationLevel::READ_UNCOMMITTED) {
+    return;
+  }
+  if (txn->GetExclusiveLockSet()->find(rid) != txn->GetExclusiveLockSet()->end() ||
+      txn->GetSharedLockSet()->find(rid) != txn->GetSharedLockSet()->end()) {
+    return;
+  }
+  exec_ctx_->GetLockManager()->LockShared(txn, rid);
+}
+
+void SeqScanExecutor::UnLock(const RID &rid) {
+  Transaction *txn = exec_ctx_->GetTransaction();
+  if (txn->GetIsolationLevel() == IsolationLevel::READ_COMMITTED &&
+      txn->GetExclusiveLockSet()->find(rid) == txn->GetExclusiveLockSet()->end()) {
+    exec_ctx_->GetLockManager()->Unlock(txn, rid);
+  }
+}
+
+void SeqScanExecutor::Init() {
+  StopWorkers();
+  ResetNextFromBatch();
+  cursor_ = MorselCursor();
+  runtime_filter_ = exec_ctx_->GetRuntimeFilter(plan_);
+  if (exec_ctx_->GetNumWorkers() > 1) {
+    // one of several copies of a plan fragment: share the pages with the other copies
+    dispenser_ = exec_ctx_->GetOperatorStates()->GetOrCreate<MorselDispenser>(
+        plan_, [&] { return std::make_shared<MorselDispenser>(table_info_->table_->GetPageDirectory()); });
+    return;
+  }
+  size_t parallelism = exec_ctx_->GetParallelism();
+  if (parallelism <= 1) {
+    table_iterator_ = table_info_->table_->Begin(exec_ctx_->GetTransaction());
+    return;
+  }
+  dispenser_ = std::make_shared<MorselDispenser>(table_info_->table_->GetPageDirectory());
+  // bound the queue, so that a slow consumer does not make the tasks buffer the whole table
+  channel_ = std::make_unique<BatchChannel>(2 * parallelism, parallelism);
+  ThreadPool *thread_pool = exec_ctx_->GetThreadPool();
+  for (size_t i = 0; i < parallelism; i++) {
+    thread_pool->Submit([this] { ScanMorsels(); });
+  }
+}
+
+SeqScanExecutor::~SeqScanExecutor() { StopWorkers(); }
+
+bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+void SeqScanExecutor::Filter(const TupleBatch &batch, SelectionBitmap *selection) {
+  VectorizedFilter::Filter(plan_->GetPredicate(), batch, selection);
+  if (runtime_filter_ != nullptr) {
+    runtime_filter_->Apply(batch, selection);
+  }
+}
+
+void SeqScanExecutor::ProjectSelected(const TupleBatch &scan_batch, const SelectionBitmap &selection,
+                                      TupleBatch *out) {
+  const std::vector<Column> &columns = GetOutputSchema()->GetColumns();
+  std::vector<Value> values(columns.size());
+  for (size_t row = 0; row < scan_batch.Size(); row++) {
+    if (!selection.IsSelected(row)) {
+      continue;
+    }
+    for (uint32_t i = 0; i < columns.size(); i++) {
+      values[i] = columns[i].GetExpr()->EvaluateRow(&scan_batch, row);
+    }
+    out->AppendValues(values, scan_batch.GetRid(row));
+  }
+}
+
+bool SeqScanExecutor::NextBatch(TupleBatch *batch) {
+  if (channel_ != nullptr) {
+    return channel_->NextBatch(batch);
+  }
+  if (dispenser_ != nullptr) {
+    return NextMorselBatch(&cursor_, batch);
+  }
+  batch->Clear();
+  if (scan_batch_ == nullptr || scan_batch_->Capacity() != batch->Capacity()) {
+    scan_batch_ = std::make_unique<TupleBatch>(&table_info_->schema_, batch->Capacity());
+  }
+  // keep reading until some tuple passes the predicate
+  while (batch->IsEmpty() && table_iterator_ != table_info_->table_->End()) {
+    scan_batch_->Clear();
+    while (!scan_batch_->IsFull() && table_iterator_ != table_info_->table_->End()) {
+      scan_batch_->AppendTuple(*table_iterator_, table_iterator_->GetRid());
+      ++table_iterator_;
+    }
+    LockRows(*scan_batch_);
+    Filter(*scan_batch_, &selection_);
+    ProjectSelected(*scan_batch_, selection_, batch);
+  }
+  return !batch->IsEmpty();
+}
+
+void SeqScanExecutor::LockRows(const TupleBatch &batch) {
+  // the lock manager is not safe to call for one transaction from several threads at once
+  std::scoped_lock lock(*exec_ctx_->GetTransactionLatch());
+  for (size_t row = 0; row < batch.Size(); row++) {
+    LockShared(batch.GetRid(row));
+    UnLock(batch.GetRid(row));
+  }
+}
+
+void SeqScanExecutor::ScanPage(page_id_t page_id, TupleBatch *batch) {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  auto page = static_cast<TablePage *>(bpm->FetchPage(page_id));
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Couldn't fetch a page of the table heap.");
+  }
+  page->RLatch();
+  RID rid;
+  Tuple tuple;
+  for (bool found = page->GetFirstTupleRid(&rid); found; found = page->GetNextTupleRid(rid, &rid)) {
+    page->GetTupleView(rid, &tuple);
+    batch->AppendTuple(tuple, rid);
+  }
+  page->RUnlatch();
+  bpm->UnpinPage(page_id, false);
+  LockRows(*batch);
+}
+
+bool SeqScanExecutor::NextMorselBatch(MorselCursor *cursor, TupleBatch *batch) {
+  if (cursor->page_batch_ == nullptr) {
+    // every tuple of a page fits in a batch
+    cursor->page_batch_ = std::make_unique<TupleBatch>(&table_info_->schema_);
+    cursor->page_output_ = std::make_unique<TupleBatch>(GetOutputSchema());
+  }
+  batch->Clear();
+  while (!batch->IsFull()) {
+    if (cursor->next_row_ < cursor->page_output_->Size()) {
+      batch->AppendRow(*cursor->page_output_, cursor->next_row_++);
+      continue;
+    }
+    if (cursor->next_page_ == cursor->morsel_end_ && !dispenser_->Next(&cursor->next_page_, &cursor->morsel_end_)) {
+      break;
+    }
+    cursor->page_batch_->Clear();
+    ScanPage(dispenser_->GetPageId(cursor->next_page_++), cursor->page_batch_.get());
+    Filter(*cursor->page_batch_, &cursor->selection_);
+    cursor->page_output_->Clear();
+    ProjectSelected(*cursor->page_batch_, cursor->selection_, cursor->page_output_.get());
+    cursor->next_row_ = 0;
+  }
+  return !batch->IsEmpty();
+}
+
+void SeqScanExecutor::ScanMorsels() {
+  BatchChannel *channel = channel_.get();
+  std::exception_ptr error;
+  try {
+    MorselCursor cursor;
+    auto batch = std::make_unique<TupleBatch>(GetOutputSchema());
+    while (NextMorselBatch(&cursor, batch.get())) {
+      if (!channel->Push(std::move(batch))) {
+        break;
+      }
+      batch = std::make_unique<TupleBatch>(GetOutputSchema());
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+  channel->ProducerDone(error);
+}
+
+void SeqScanExecutor::StopWorkers() {
+  if (channel_ != nullptr) {
+    channel_->Close();
+    channel_->WaitForProducers();
+    channel_.reset();
+  }
+  dispenser_.reset();
+}
+
+}  // namespace bustub
@@ -0,0 +1,322 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.cpp
+//
+// Identification: src/execution/sort_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/sort_executor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace bustub {
+
+namespace {
+
+/** Append the low bytes of an integer, most significant first, so that memcmp orders them as unsigned numbers. */
+void AppendUnsigned(uint64_t value, size_t width, std::string *key) {
+  for (size_t i = width; i-- > 0;) {
+    key->push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+/** Append a signed integer of the given width, offset into the unsigned range so that negative numbers order first. */
+void AppendSigned(int64_t value, size_t width, std::string *key) {
+  AppendUnsigned(static_cast<uint64_t>(value) + (uint64_t{1} << (8 * width - 1)), width, key);
+}
+
+}  // namespace
+
+SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+SortExecutor::~SortExecutor() { ReleaseMemory(); }
+
+void SortExecutor::Init() {
+  child_executor_->Init();
+  ReleaseMemory();
+  runs_.clear();
+  merge_inputs_.clear();
+  merge_heap_.clear();
+  merging_ = false;
+  ResetNextFromBatch();
+
+  MemoryBudget *budget = GetExecutorContext()->GetMemoryBudget();
+  while (true) {
+    auto batch = std::make_unique<TupleBatch>(child_executor_->GetOutputSchema());
+    if (!child_executor_->NextBatch(batch.get())) {
+      break;
+    }
+    size_t keys_size = keys_.size();
+    for (size_t row = 0; row < batch->Size(); row++) {
+      AddRow(*batch, batches_.size(), row);
+    }
+    memory_ += batch->MemoryUsage() + batch->Size() * sizeof(SortEntry) + keys_.size() - keys_size;
+    batches_.push_back(std::move(batch));
+    if (budget->TryReserve(memory_ - reserved_)) {
+      reserved_ = memory_;
+      continue;
+    }
+    // the batch that did not fit is held already; it goes to disk with the rest of the run
+    budget->Reserve(memory_ - reserved_);
+    reserved_ = memory_;
+    SpillRun();
+  }
+
+  if (runs_.empty()) {
+    SortEntries();
+    return;
+  }
+  if (!entries_.empty()) {
+    SpillRun();
+  }
+  MergeRuns();
+}
+
+bool SortExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool SortExecutor::NextBatch(TupleBatch *batch) {
+  batch->Clear();
+  if (merging_) {
+    Tuple tuple;
+    while (!batch->IsFull()) {
+      if (!NextMerged(&tuple)) {
+        ReleaseMemory();
+        break;
+      }
+      batch->AppendTuple(tuple, RID());
+    }
+    return !batch->IsEmpty();
+  }
+  while (!batch->IsFull()) {
+    if (next_entry_ == entries_.size()) {
+      ReleaseMemory();
+      break;
+    }
+    const SortEntry &entry = entries_[next_entry_++];
+    batch->AppendRow(*batches_[entry.batch_], entry.row_);
+  }
+  return !batch->IsEmpty();
+}
+
+void SortExecutor::NormalizeValue(const Value &value, bool descending, std::string *key) {
+  size_t start = key->size();
+  // a flag orders NULLs before all other values
+  key->push_back(value.IsNull() ? '\0' : '\1');
+  if (!value.IsNull()) {
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+        key->push_back(value.GetAs<bool>() ? '\1' : '\0');
+        break;
+      case TypeId::TINYINT:
+        AppendSigned(value.GetAs<int8_t>(), sizeof(int8_t), key);
+        break;
+      case TypeId::SMALLINT:
+        AppendSigned(value.GetAs<int16_t>(), sizeof(int16_t), key);
+        break;
+      case TypeId::INTEGER:
+        AppendSigned(value.GetAs<int32_t>(), sizeof(int32_t), key);
+        break;
+      case TypeId::BIGINT:
+        AppendSigned(value.GetAs<int64_t>(), sizeof(int64_t), key);
+        break;
+      case TypeId::TIMESTAMP:
+        AppendUnsigned(value.GetAs<uint64_t>(), sizeof(uint64_t), key);
+        break;
+      case TypeId::DECIMAL: {
+        // -0.0 equals 0.0; otherwise flipping the sign bit of positive numbers, and all bits of negative ones, orders
+        // the bits of IEEE doubles as unsigned numbers
+        double number = value.GetAs<double>() == 0 ? 0 : value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &number, sizeof(bits));
+        bits = (bits >> 63) != 0 ? ~bits : bits | (uint64_t{1} << 63);
+        AppendUnsigned(bits, sizeof(bits), key);
+        break;
+      }
+      case TypeId::VARCHAR: {
+        // the characters, with zero bytes escaped, then a terminator that orders a string before its extensions
+        const char *data = value.GetData();
+        for (uint32_t i = 0; i + 1 < value.GetLength(); i++) {
+          key->push_back(data[i]);
+          if (data[i] == '\0') {
+            key->push_back('\xff');
+          }
+        }
+        key->append(2, '\0');
+        break;
+      }
+      default:
+        BUSTUB_ASSERT(false, "Unsupported sort key type.");
+    }
+  }
+  if (descending) {
+    for (size_t i = start; i < key->size(); i++) {
+      (*key)[i] = static_cast<char>(~(*key)[i]);
+    }
+  }
+}
+
+int SortExecutor::CompareKeys(const char *left, size_t left_length, const char *right, size_t right_length) {
+  int cmp = memcmp(left, right, std::min(left_length, right_length));
+  if (cmp != 0 || left_length == right_length) {
+    return cmp;
+  }
+  return left_length < right_length ? -1 : 1;
+}
+
+void SortExecutor::AddRow(const TupleBatch &batch, uint32_t batch_idx, size_t row) {
+  key_.clear();
+  for (const auto &[expr, order_by_type] : plan_->GetOrderBys()) {
+    NormalizeValue(expr->EvaluateRow(&batch, row), order_by_type == OrderByType::DESC, &key_);
+  }
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < sizeof(prefix); i++) {
+    prefix = (prefix << 8) | (i < key_.size() ? static_cast<uint8_t>(key_[i]) : 0);
+  }
+  entries_.push_back(SortEntry{prefix, static_cast<uint32_t>(keys_.size()), static_cast<uint32_t>(key_.size()),
+                               batch_idx, static_cast<uint32_t>(row)});
+  keys_.append(key_);
+}
+
+void SortExecutor::MakeKey(const Tuple &tuple, std::string *key) const {
+  key->clear();
+  for (const auto &[expr, order_by_type] : plan_->GetOrderBys()) {
+    NormalizeValue(expr->Evaluate(&tuple, child_executor_->GetOutputSchema()), order_by_type == OrderByType::DESC,
+                   key);
+  }
+}
+
+void SortExecutor::SortEntries() {
+  const char *keys = keys_.data();
+  // stable, so that ties keep the order of the child
+  std::stable_sort(entries_.begin(), entries_.end(), [keys](const SortEntry &left, const SortEntry &right) {
+    if (left.prefix_ != right.prefix_) {
+      return left.prefix_ < right.prefix_;
+    }
+    return CompareKeys(keys + left.key_offset_, left.key_length_, keys + right.key_offset_, right.key_length_) < 0;
+  });
+}
+
+void SortExecutor::SpillRun() {
+  SortEntries();
+  auto run = std::make_unique<TmpTupleFile>(GetExecutorContext()->GetBufferPoolManager());
+  for (const SortEntry &entry : entries_) {
+    Tuple tuple = batches_[entry.batch_]->GetTuple(entry.row_);
+    run->Append(tuple);
+    spilled_bytes_ += tuple.GetLength();
+  }
+  run->Rewind();
+  runs_.push_back(std::move(run));
+  num_runs_++;
+  ReleaseMemory();
+}
+
+void SortExecutor::MergeRuns() {
+  size_t fan_in = ReserveMergeFanIn();
+  while (runs_.size() > fan_in) {
+    // merging consecutive runs into one keeps the runs in the order of the child, for ties
+    std::vector<std::unique_ptr<TmpTupleFile>> merged;
+    for (size_t first = 0; first < runs_.size(); first += fan_in) {
+      size_t last = std::min(first + fan_in, runs_.size());
+      if (last - first == 1) {
+        merged.push_back(std::move(runs_[first]));
+        continue;
+      }
+      StartMerge(std::vector<std::unique_ptr<TmpTupleFile>>(std::make_move_iterator(runs_.begin() + first),
+                                                            std::make_move_iterator(runs_.begin() + last)));
+      auto run = std::make_unique<TmpTupleFile>(GetExecutorContext()->GetBufferPoolManager());
+      Tuple tuple;
+      while (NextMerged(&tuple)) {
+        run->Append(tuple);
+        spilled_bytes_ += tuple.GetLength();
+      }
+      run->Rewind();
+      merged.push_back(std::move(run));
+      num_runs_++;
+    }
+    runs_ = std::move(merged);
+    num_merge_passes_++;
+  }
+  StartMerge(std::move(runs_));
+  runs_.clear();
+  merging_ = true;
+}
+
+void SortExecutor::StartMerge(std::vector<std::unique_ptr<TmpTupleFile>> &&runs) {
+  merge_inputs_.clear();
+  merge_inputs_.reserve(runs.size());
+  merge_heap_.clear();
+  for (auto &run : runs) {
+    merge_inputs_.push_back(MergeInput{std::move(run), Tuple(), std::string()});
+    if (AdvanceInput(merge_inputs_.size() - 1)) {
+      merge_heap_.push_back(merge_inputs_.size() - 1);
+    }
+  }
+  std::make_heap(merge_heap_.begin(), merge_heap_.end(),
+                 [this](size_t left, size_t right) { return MergesAfter(left, right); });
+}
+
+bool SortExecutor::AdvanceInput(size_t input) {
+  MergeInput &merge_input = merge_inputs_[input];
+  if (!merge_input.file_->Next(&merge_input.tuple_)) {
+    return false;
+  }
+  MakeKey(merge_input.tuple_, &merge_input.key_);
+  return true;
+}
+
+bool SortExecutor::MergesAfter(size_t left, size_t right) const {
+  const std::string &left_key = merge_inputs_[left].key_;
+  const std::string &right_key = merge_inputs_[right].key_;
+  int cmp = CompareKeys(left_key.data(), left_key.size(), right_key.data(), right_key.size());
+  // ties go to the run written first
+  return cmp != 0 ? cmp > 0 : left > right;
+}
+
+bool SortExecutor::NextMerged(Tuple *tuple) {
+  if (merge_heap_.empty()) {
+    // drop the pages of the runs as soon as they are merged
+    merge_inputs_.clear();
+    return false;
+  }
+  auto merges_after = [this](size_t left, size_t right) { return MergesAfter(left, right); };
+  std::pop_heap(merge_heap_.begin(), merge_heap_.end(), merges_after);
+  size_t input = merge_heap_.back();
+  *tuple = merge_inputs_[input].tuple_;
+  if (AdvanceInput(input)) {
+    std::push_heap(merge_heap_.begin(), merge_heap_.end(), merges_after);
+  } else {
+    merge_heap_.pop_back();
+  }
+  return true;
+}
+
+size_t SortExecutor::ReserveMergeFanIn() {
+  MemoryBudget *budget = GetExecutorContext()->GetMemoryBudget();
+  size_t limit = budget->GetLimit();
+  size_t reserved = budget->GetReserved();
+  size_t fan_in = reserved < limit ? (limit - reserved) / PAGE_SIZE : 0;
+  // a merge of fewer than two runs would not make progress, so it takes the memory for two regardless
+  fan_in = std::max<size_t>(2, std::min(fan_in, MAX_MERGE_FAN_IN));
+  budget->Reserve(fan_in * PAGE_SIZE);
+  reserved_ += fan_in * PAGE_SIZE;
+  return fan_in;
+}
+
+void SortExecutor::ReleaseMemory() {
+  GetExecutorContext()->GetMemoryBudget()->Release(reserved_);
+  reserved_ = 0;
+  memory_ = 0;
+  next_entry_ = 0;
+  batches_.clear();
+  std::string().swap(keys_);
+  std::vector<SortEntry>().swap(entries_);
+}
+
+}  // namespace bustub
@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+#include <cstring>
+
+#include "common/macros.h"
+#include "type/type.h"
+
+namespace bustub {
+
+ColumnVector::ColumnVector(TypeId type, size_t capacity)
+    : type_(type), width_(IsInlined() ? Type::GetTypeSize(type) : 0) {
+  if (IsInlined()) {
+    data_.reserve(capacity * width_);
+  } else {
+    values_.reserve(capacity);
+  }
+}
+
+Value ColumnVector::GetValue(size_t row) const {
+  BUSTUB_ASSERT(row < size_, "row out of range");
+  if (IsInlined()) {
+    return Value::DeserializeFrom(data_.data() + row * width_, type_);
+  }
+  return values_[row];
+}
+
+void ColumnVector::Append(const Value &value) {
+  if (IsInlined()) {
+    data_.resize(data_.size() + width_);
+    value.SerializeTo(data_.data() + size_ * width_);
+  } else {
+    values_.push_back(value);
+  }
+  size_++;
+}
+
+void ColumnVector::AppendRaw(const char *storage) {
+  BUSTUB_ASSERT(IsInlined(), "only inlined values have a fixed-width form");
+  data_.insert(data_.end(), storage, storage + width_);
+  size_++;
+}
+
+void ColumnVector::AppendFrom(const ColumnVector &other, size_t row) {
+  BUSTUB_ASSERT(other.type_ == type_, "columns of different types");
+  if (IsInlined()) {
+    AppendRaw(other.data_.data() + row * width_);
+  } else {
+    Append(other.values_[row]);
+  }
+}
+
+void ColumnVector::Truncate(size_t size) {
+  if (size >= size_) {
+    return;
+  }
+  if (IsInlined()) {
+    data_.resize(size * width_);
+  } else {
+    values_.erase(values_.begin() + size, values_.end());
+  }
+  size_ = size;
+}
+
+size_t ColumnVector::MemoryUsage() const {
+  if (IsInlined()) {
+    return data_.size();
+  }
+  size_t bytes = 0;
+  for (size_t row = 0; row < size_; row++) {
+    bytes += MemoryUsage(row);
+  }
+  return bytes;
+}
+
+size_t ColumnVector::MemoryUsage(size_t row) const {
+  if (IsInlined()) {
+    return width_;
+  }
+  // a VARCHAR value owns a copy of its characters
+  return sizeof(Value) + (values_[row].IsNull() ? 0 : values_[row].GetLength());
+}
+
+TupleBatch::TupleBatch(const Schema *schema, size_t capacity) : schema_(schema), capacity_(capacity) {
+  if (schema != nullptr) {
+    columns_.reserve(schema->GetColumnCount());
+    for (const auto &column : schema->GetColumns()) {
+      columns_.emplace_back(column.GetType(), capacity);
+    }
+  }
+  rids_.reserve(capacity);
+}
+
+Tuple TupleBatch::GetTuple(size_t row) const {
+  BUSTUB_ASSERT(schema_ != nullptr, "rows without columns have no tuple form");
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column.GetValue(row));
+  }
+  return Tuple(values, schema_);
+}
+
+void TupleBatch::AppendTuple(const Tuple &tuple, const RID &rid) {
+  BUSTUB_ASSERT(!IsFull(), "batch is full");
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    const Column &column = schema_->GetColumn(i);
+    if (column.IsInlined()) {
+      columns_[i].AppendRaw(tuple.GetData() + column.GetOffset());
+    } else {
+      columns_[i].Append(tuple.GetValue(schema_, i));
+    }
+  }
+  rids_.push_back(rid);
+}
+
+void TupleBatch::AppendValues(const std::vector<Value> &values, const RID &rid) {
+  BUSTUB_ASSERT(!IsFull(), "batch is full");
+  BUSTUB_ASSERT(values.size() == columns_.size(), "one value per column");
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].Append(values[i]);
+  }
+  rids_.push_back(rid);
+}
+
+void TupleBatch::AppendRow(const TupleBatch &other, size_t row) {
+  BUSTUB_ASSERT(!IsFull(), "batch is full");
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].AppendFrom(other.columns_[i], row);
+  }
+  rids_.push_back(other.rids_[row]);
+}
+
+void TupleBatch::Truncate(size_t size) {
+  if (size >= rids_.size()) {
+    return;
+  }
+  for (auto &column : columns_) {
+    column.Truncate(size);
+  }
+  rids_.resize(size);
+}
+
+size_t TupleBatch::MemoryUsage() const {
+  size_t bytes = rids_.size() * sizeof(RID);
+  for (const auto &column : columns_) {
+    bytes += column.MemoryUsage();
+  }
+  return bytes;
+}
+
+size_t TupleBatch::MemoryUsage(size_t row) const {
+  size_t bytes = sizeof(RID);
+  for (const auto &column : columns_) {
+    bytes += column.MemoryUsage(row);
+  }
+  return bytes;
+}
+
+}  // namespace bustub
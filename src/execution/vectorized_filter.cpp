@@ -0,0 +1,350 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vectorized_filter.cpp
+//
+// Identification: src/execution/vectorized_filter.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/vectorized_filter.h"
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+namespace {
+
+/** Set the bits of values [begin, end) that are not null and satisfy pred. */
+template <typename T, typename Pred>
+void SetBits(const T *values, size_t begin, size_t end, T null_value, uint64_t *bits, Pred pred) {
+  for (size_t i = begin; i < end; i++) {
+    auto bit = static_cast<uint64_t>(values[i] != null_value && pred(values[i]));
+    bits[i / SelectionBitmap::WORD_BITS] |= bit << (i % SelectionBitmap::WORD_BITS);
+  }
+}
+
+/** The scalar kernel, which also finishes the tail the SIMD kernels leave. */
+template <typename T>
+void CompareScalar(const T *values, size_t begin, size_t end, ComparisonType comp_type, T constant, T null_value,
+                   uint64_t *bits) {
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      SetBits(values, begin, end, null_value, bits, [constant](T v) { return v == constant; });
+      break;
+    case ComparisonType::NotEqual:
+      SetBits(values, begin, end, null_value, bits, [constant](T v) { return v != constant; });
+      break;
+    case ComparisonType::LessThan:
+      SetBits(values, begin, end, null_value, bits, [constant](T v) { return v < constant; });
+      break;
+    case ComparisonType::LessThanOrEqual:
+      SetBits(values, begin, end, null_value, bits, [constant](T v) { return v <= constant; });
+      break;
+    case ComparisonType::GreaterThan:
+      SetBits(values, begin, end, null_value, bits, [constant](T v) { return v > constant; });
+      break;
+    case ComparisonType::GreaterThanOrEqual:
+      SetBits(values, begin, end, null_value, bits, [constant](T v) { return v >= constant; });
+      break;
+  }
+}
+
+/**
+ * The SIMD kernel, generic over a Lanes type that wraps one instruction set and value type: it compares WIDTH values at
+ * a time and turns the result into WIDTH bits. Lane groups never straddle a word, as WIDTH divides 64.
+ * @return the number of values compared; the caller finishes the rest
+ */
+template <class Lanes>
+size_t CompareLanes(const typename Lanes::Scalar *values, size_t n, ComparisonType comp_type,
+                    typename Lanes::Scalar constant, uint64_t *bits) {
+  const auto constants = Lanes::Set1(constant);
+  const auto nulls = Lanes::Set1(Lanes::NULL_VALUE);
+  size_t i = 0;
+  for (; i + Lanes::WIDTH <= n; i += Lanes::WIDTH) {
+    auto lanes = Lanes::Load(values + i);
+    uint64_t mask = Lanes::Mask(lanes, constants, comp_type) & ~Lanes::Mask(lanes, nulls, ComparisonType::Equal);
+    bits[i / SelectionBitmap::WORD_BITS] |= mask << (i % SelectionBitmap::WORD_BITS);
+  }
+  return i;
+}
+
+/** Derive all six comparisons of integer lanes from equality and greater-than masks. */
+inline uint32_t IntegerMask(uint32_t eq, uint32_t gt, uint32_t lt, uint32_t all, ComparisonType comp_type) {
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return eq;
+    case ComparisonType::NotEqual:
+      return ~eq & all;
+    case ComparisonType::LessThan:
+      return lt;
+    case ComparisonType::LessThanOrEqual:
+      return ~gt & all;
+    case ComparisonType::GreaterThan:
+      return gt;
+    case ComparisonType::GreaterThanOrEqual:
+      return ~lt & all;
+  }
+  return 0;
+}
+
+#if defined(__AVX2__)
+
+struct Int32Lanes {
+  using Scalar = int32_t;
+  using Vector = __m256i;
+  static constexpr size_t WIDTH = 8;
+  static constexpr Scalar NULL_VALUE = BUSTUB_INT32_NULL;
+  static Vector Load(const Scalar *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+  static Vector Set1(Scalar v) { return _mm256_set1_epi32(v); }
+  static uint32_t Bits(Vector v) { return _mm256_movemask_ps(_mm256_castsi256_ps(v)); }
+  static uint32_t Mask(Vector a, Vector b, ComparisonType comp_type) {
+    return IntegerMask(Bits(_mm256_cmpeq_epi32(a, b)), Bits(_mm256_cmpgt_epi32(a, b)), Bits(_mm256_cmpgt_epi32(b, a)),
+                       0xff, comp_type);
+  }
+};
+
+struct Int64Lanes {
+  using Scalar = int64_t;
+  using Vector = __m256i;
+  static constexpr size_t WIDTH = 4;
+  static constexpr Scalar NULL_VALUE = BUSTUB_INT64_NULL;
+  static Vector Load(const Scalar *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+  static Vector Set1(Scalar v) { return _mm256_set1_epi64x(v); }
+  static uint32_t Bits(Vector v) { return _mm256_movemask_pd(_mm256_castsi256_pd(v)); }
+  static uint32_t Mask(Vector a, Vector b, ComparisonType comp_type) {
+    return IntegerMask(Bits(_mm256_cmpeq_epi64(a, b)), Bits(_mm256_cmpgt_epi64(a, b)), Bits(_mm256_cmpgt_epi64(b, a)),
+                       0xf, comp_type);
+  }
+};
+
+struct DoubleLanes {
+  using Scalar = double;
+  using Vector = __m256d;
+  static constexpr size_t WIDTH = 4;
+  static constexpr Scalar NULL_VALUE = BUSTUB_DECIMAL_NULL;
+  static Vector Load(const Scalar *p) { return _mm256_loadu_pd(p); }
+  static Vector Set1(Scalar v) { return _mm256_set1_pd(v); }
+  static uint32_t Mask(Vector a, Vector b, ComparisonType comp_type) {
+    switch (comp_type) {
+      case ComparisonType::Equal:
+        return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ));
+      case ComparisonType::NotEqual:
+        return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_NEQ_OQ));
+      case ComparisonType::LessThan:
+        return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ));
+      case ComparisonType::LessThanOrEqual:
+        return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ));
+      case ComparisonType::GreaterThan:
+        return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ));
+      case ComparisonType::GreaterThanOrEqual:
+        return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GE_OQ));
+    }
+    return 0;
+  }
+};
+
+#elif defined(__SSE4_2__)
+
+struct Int32Lanes {
+  using Scalar = int32_t;
+  using Vector = __m128i;
+  static constexpr size_t WIDTH = 4;
+  static constexpr Scalar NULL_VALUE = BUSTUB_INT32_NULL;
+  static Vector Load(const Scalar *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+  static Vector Set1(Scalar v) { return _mm_set1_epi32(v); }
+  static uint32_t Bits(Vector v) { return _mm_movemask_ps(_mm_castsi128_ps(v)); }
+  static uint32_t Mask(Vector a, Vector b, ComparisonType comp_type) {
+    return IntegerMask(Bits(_mm_cmpeq_epi32(a, b)), Bits(_mm_cmpgt_epi32(a, b)), Bits(_mm_cmpgt_epi32(b, a)), 0xf,
+                       comp_type);
+  }
+};
+
+struct Int64Lanes {
+  using Scalar = int64_t;
+  using Vector = __m128i;
+  static constexpr size_t WIDTH = 2;
+  static constexpr Scalar NULL_VALUE = BUSTUB_INT64_NULL;
+  static Vector Load(const Scalar *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+  static Vector Set1(Scalar v) { return _mm_set1_epi64x(v); }
+  static uint32_t Bits(Vector v) { return _mm_movemask_pd(_mm_castsi128_pd(v)); }
+  static uint32_t Mask(Vector a, Vector b, ComparisonType comp_type) {
+    return IntegerMask(Bits(_mm_cmpeq_epi64(a, b)), Bits(_mm_cmpgt_epi64(a, b)), Bits(_mm_cmpgt_epi64(b, a)), 0x3,
+                       comp_type);
+  }
+};
+
+struct DoubleLanes {
+  using Scalar = double;
+  using Vector = __m128d;
+  static constexpr size_t WIDTH = 2;
+  static constexpr Scalar NULL_VALUE = BUSTUB_DECIMAL_NULL;
+  static Vector Load(const Scalar *p) { return _mm_loadu_pd(p); }
+  static Vector Set1(Scalar v) { return _mm_set1_pd(v); }
+  static uint32_t Mask(Vector a, Vector b, ComparisonType comp_type) {
+    switch (comp_type) {
+      case ComparisonType::Equal:
+        return _mm_movemask_pd(_mm_cmpeq_pd(a, b));
+      case ComparisonType::NotEqual:
+        // unlike cmpneq, true only for ordered operands
+        return _mm_movemask_pd(_mm_or_pd(_mm_cmplt_pd(a, b), _mm_cmpgt_pd(a, b)));
+      case ComparisonType::LessThan:
+        return _mm_movemask_pd(_mm_cmplt_pd(a, b));
+      case ComparisonType::LessThanOrEqual:
+        return _mm_movemask_pd(_mm_cmple_pd(a, b));
+      case ComparisonType::GreaterThan:
+        return _mm_movemask_pd(_mm_cmpgt_pd(a, b));
+      case ComparisonType::GreaterThanOrEqual:
+        return _mm_movemask_pd(_mm_cmpge_pd(a, b));
+    }
+    return 0;
+  }
+};
+
+#endif
+
+/** @return the comparison with its operands swapped, e.g. `5 < col` is `col > 5` */
+ComparisonType Flip(ComparisonType comp_type) {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+bool IsIntegral(TypeId type) {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+}
+
+}  // namespace
+
+void VectorizedFilter::CompareInt32(const int32_t *values, size_t n, ComparisonType comp_type, int32_t constant,
+                                    uint64_t *bits) {
+  size_t done = 0;
+#if defined(__AVX2__) || defined(__SSE4_2__)
+  done = CompareLanes<Int32Lanes>(values, n, comp_type, constant, bits);
+#endif
+  CompareScalar(values, done, n, comp_type, constant, BUSTUB_INT32_NULL, bits);
+}
+
+void VectorizedFilter::CompareInt64(const int64_t *values, size_t n, ComparisonType comp_type, int64_t constant,
+                                    uint64_t *bits) {
+  size_t done = 0;
+#if defined(__AVX2__) || defined(__SSE4_2__)
+  done = CompareLanes<Int64Lanes>(values, n, comp_type, constant, bits);
+#endif
+  CompareScalar(values, done, n, comp_type, constant, BUSTUB_INT64_NULL, bits);
+}
+
+void VectorizedFilter::CompareDouble(const double *values, size_t n, ComparisonType comp_type, double constant,
+                                     uint64_t *bits) {
+  size_t done = 0;
+#if defined(__AVX2__) || defined(__SSE4_2__)
+  done = CompareLanes<DoubleLanes>(values, n, comp_type, constant, bits);
+#endif
+  CompareScalar(values, done, n, comp_type, constant, BUSTUB_DECIMAL_NULL, bits);
+}
+
+bool VectorizedFilter::Decompose(const AbstractExpression *predicate, uint32_t *col_idx, TypeId *col_type,
+                                 ComparisonType *comp_type, Value *constant) {
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(predicate);
+  if (comparison == nullptr) {
+    return false;
+  }
+  *comp_type = comparison->GetComparisonType();
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+  const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1));
+  if (column == nullptr && constant_expr == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+    constant_expr = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0));
+    *comp_type = Flip(*comp_type);
+  }
+  if (column == nullptr || constant_expr == nullptr || column->GetTupleIdx() != 0 ||
+      constant_expr->GetValue().IsNull()) {
+    return false;
+  }
+  *col_idx = column->GetColIdx();
+  *col_type = column->GetReturnType();
+  *constant = constant_expr->GetValue();
+  TypeId constant_type = constant->GetTypeId();
+  switch (*col_type) {
+    case TypeId::INTEGER: {
+      if (!IsIntegral(constant_type)) {
+        return false;
+      }
+      // a constant out of range would need the comparison folded; leave that to the row path
+      int64_t wide = constant->CastAs(TypeId::BIGINT).GetAs<int64_t>();
+      return wide > BUSTUB_INT32_NULL && wide <= BUSTUB_INT32_MAX;
+    }
+    case TypeId::BIGINT:
+      return IsIntegral(constant_type);
+    case TypeId::DECIMAL:
+      return IsIntegral(constant_type) || constant_type == TypeId::DECIMAL;
+    default:
+      return false;
+  }
+}
+
+bool VectorizedFilter::CanVectorize(const AbstractExpression *predicate) {
+  uint32_t col_idx;
+  TypeId col_type;
+  ComparisonType comp_type;
+  Value constant;
+  return predicate != nullptr && Decompose(predicate, &col_idx, &col_type, &comp_type, &constant);
+}
+
+void VectorizedFilter::Filter(const AbstractExpression *predicate, const TupleBatch &batch,
+                              SelectionBitmap *selection) {
+  const size_t num_rows = batch.Size();
+  selection->Reset(num_rows);
+  if (predicate == nullptr) {
+    selection->SelectAll();
+    return;
+  }
+  uint32_t col_idx;
+  TypeId col_type;
+  ComparisonType comp_type;
+  Value constant;
+  // the plan could disagree with the batch's schema, in which case the row path reports it
+  if (Decompose(predicate, &col_idx, &col_type, &comp_type, &constant) &&
+      col_idx < batch.GetSchema()->GetColumnCount() && batch.GetColumn(col_idx).GetType() == col_type) {
+    const ColumnVector &column = batch.GetColumn(col_idx);
+    switch (col_type) {
+      case TypeId::INTEGER:
+        CompareInt32(reinterpret_cast<const int32_t *>(column.GetData()), num_rows, comp_type,
+                     constant.CastAs(TypeId::INTEGER).GetAs<int32_t>(), selection->GetWords());
+        return;
+      case TypeId::BIGINT:
+        CompareInt64(reinterpret_cast<const int64_t *>(column.GetData()), num_rows, comp_type,
+                     constant.CastAs(TypeId::BIGINT).GetAs<int64_t>(), selection->GetWords());
+        return;
+      case TypeId::DECIMAL:
+        CompareDouble(reinterpret_cast<const double *>(column.GetData()), num_rows, comp_type,
+                      constant.CastAs(TypeId::DECIMAL).GetAs<double>(), selection->GetWords());
+        return;
+      default:
+        break;
+    }
+  }
+  for (size_t row = 0; row < num_rows; row++) {
+    if (predicate->EvaluateRow(&batch, row).GetAs<bool>()) {
+      selection->Select(row);
+    }
+  }
+}
+
+}  // namespace bustub
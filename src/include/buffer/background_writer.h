@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// background_writer.h
+//
+// Identification: src/include/buffer/background_writer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <thread>              // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+class BufferPoolManagerInstance;
+
+/**
+ * BackgroundWriter keeps a number of frames in each buffer pool instance clean, so that evictions rarely have to
+ * write a dirty page back on the critical path of a fetch.
+ *
+ * Every BACKGROUND_WRITER_INTERVAL the writer checks how many frames of each instance could be reused without a
+ * write. If that is below the target it takes unpinned dirty frames,
+ * sorts them by page id across all instances, and writes runs of adjacent pages with a single write.
+ */
+class BackgroundWriter {
+ public:
+  /**
+   * Creates a new BackgroundWriter. The thread is not started until Run() is called.
+   * @param instances the buffer pool instances to keep clean; a page id p belongs to instances[p % instances.size()]
+   * @param disk_manager the disk manager shared by the instances
+   * @param clean_frame_target number of clean frames to keep ready in each instance
+   */
+  BackgroundWriter(std::vector<BufferPoolManagerInstance *> instances, DiskManager *disk_manager,
+                   size_t clean_frame_target);
+
+  /** Stops the writer thread if it is running. */
+  ~BackgroundWriter();
+
+  /** Start the writer thread. */
+  void Run();
+
+  /** Stop the writer thread and wait for the current round to finish. */
+  void Stop();
+
+  /**
+   * Run one round of the writer in the calling thread.
+   * @return the number of pages written
+   */
+  size_t FlushRound();
+
+  /** @return the number of pages written so far */
+  size_t GetNumPagesWritten() const { return num_pages_written_; }
+
+  /** @return the number of write calls issued so far; adjacent pages share one call */
+  size_t GetNumWrites() const { return num_writes_; }
+
+ private:
+  std::vector<BufferPoolManagerInstance *> instances_;
+  DiskManager *disk_manager_;
+  const size_t clean_frame_target_;
+
+  std::atomic<bool> enable_ = false;
+  std::thread writer_thread_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+
+  std::atomic<size_t> num_pages_written_ = 0;
+  std::atomic<size_t> num_writes_ = 0;
+};
+
+}  // namespace bustub
@@ -16,6 +16,7 @@
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
@@ -90,6 +91,19 @@ class BufferPoolManager {
   /** @return size of the buffer pool */
   virtual size_t GetPoolSize() = 0;
 
+  /**
+   * Hint that the given pages will be fetched soon. A buffer pool that supports it starts reading them in the
+   * background; the default implementation ignores the hint.
+   * @param page_ids the pages that are about to be fetched
+   */
+  virtual void PrefetchPages(__attribute__((unused)) const std::vector<page_id_t> &page_ids) {}
+
+  /**
+   * @return how many pages the buffer pool reads ahead of a sequential reader, 0 if it does not read ahead, e.g. on
+   * top of a synchronous disk manager, where a prefetch would block the caller for the whole read
+   */
+  virtual size_t GetReadAheadWindow() { return 0; }
+
  protected:
   /**
    * Grading function. Do not modify!
@@ -12,12 +12,16 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
 #include <list>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
+#include "buffer/background_writer.h"
 #include "buffer/buffer_pool_manager.h"
-#include "buffer/lru_replacer.h"
+#include "buffer/replacer.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -34,8 +38,10 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy used to pick victim frames
    */
-  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU);
   /**
    * Creates a new BufferPoolManagerInstance.
    * @param pool_size the size of the buffer pool
@@ -43,9 +49,11 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param instance_index index of this BPI in the parallel BPM
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy used to pick victim frames
    */
   BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
-                            DiskManager *disk_manager, LogManager *log_manager = nullptr);
+                            DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU);
 
   /**
    * Destroys an existing BufferPoolManagerInstance.
@@ -58,6 +66,45 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @return pointer to all the pages in the buffer pool */
   Page *GetPages() { return pages_; }
 
+  /** @return the number of frames that can be handed out without writing anything back */
+  size_t GetCleanFrameCount();
+
+  /**
+   * Pin up to max_pages unpinned dirty pages on behalf of the background writer and mark them clean. The pins bypass
+   * the replacer, so a page keeps its place in the eviction order; release them with ReleaseColdPage.
+   * @param max_pages the maximum number of pages to pin
+   * @param[out] pages the pinned pages are appended here
+   */
+  void PinColdDirtyPages(size_t max_pages, std::vector<Page *> *pages);
+
+  /**
+   * Release a pin taken by PinColdDirtyPages. Writing the page back is not a use of it, so unlike UnpinPage this does
+   * not make the page look recently used.
+   * @param page a page pinned by PinColdDirtyPages
+   */
+  void ReleaseColdPage(Page *page);
+
+  /**
+   * Start a background writer that keeps clean_frame_target frames of this instance clean.
+   * @param clean_frame_target number of clean frames to keep ready
+   */
+  void StartBackgroundWriter(size_t clean_frame_target);
+
+  /** Stop the background writer started by StartBackgroundWriter, if any. */
+  void StopBackgroundWriter();
+
+  /**
+   * Start reading the given pages into the buffer pool without waiting for them. Pages that are already resident are
+   * skipped, and prefetching stops early once every frame is pinned. All the reads, together with the write-backs of
+   * the dirty pages they evict, are handed to the disk manager as a single batch; with an AsyncDiskManager they
+   * complete in the background, and a later fetch of a page waits only for that page's read.
+   * @param page_ids the pages to read, all of which must belong to this instance
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids) override;
+
+  /** @return the number of pages read ahead of a sequential pattern, 0 if read-ahead is disabled */
+  size_t GetReadAheadWindow() override { return read_ahead_window_; }
+
  protected:
   /**
    * Fetch the requested page from the buffer pool.
@@ -127,6 +174,83 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   void ValidatePageId(page_id_t page_id) const;
 
+  /** A slice of the page table with its own latch, so that lookups of unrelated pages do not contend. */
+  struct PageTableStripe {
+    std::mutex latch_;
+    std::unordered_map<page_id_t, frame_id_t> table_;
+  };
+
+  /** @return the page table stripe that page_id belongs to */
+  PageTableStripe &GetStripe(page_id_t page_id) {
+    return page_table_[static_cast<uint32_t>(page_id) / num_instances_ % PAGE_TABLE_STRIPES];
+  }
+
+  /**
+   * Pin a resident page without taking latch_. The pin count is raised while the stripe latch is held, which is
+   * what keeps the frame from being evicted (see FindFreeFrame).
+   * @param page_id page to pin
+   * @param[out] frame_id frame holding the page
+   * @param[out] first_pin true if the page was unpinned before this call
+   * @return the pinned page, or nullptr if it is not resident
+   */
+  Page *PinResident(page_id_t page_id, frame_id_t *frame_id, bool *first_pin);
+
+  /** Block until the pending I/O on a frame the caller has pinned completes. */
+  void WaitForIo(frame_id_t frame_id);
+
+  /**
+   * Take a frame for a new resident page, from the free list first and then from the replacer. The replacer is only
+   * a hint on the hit path, so a victim that turns out to be pinned again is skipped. The evicted page is removed
+   * from the page table. The caller must hold latch_.
+   * @param[out] frame_id id of the frame that was taken
+   * @return false if every frame is pinned
+   */
+  bool FindFreeFrame(frame_id_t *frame_id);
+
+  /**
+   * Install page_id in the given frame, pinned once, and mark the frame as having I/O in flight. If the previous page
+   * of the frame was dirty it is registered in evicting_pages_ until its write-back finishes. Installing is not a use
+   * of the page: a fetch records its access itself, and a prefetch none at all, so that read-ahead does not make the
+   * pages of a scan look hot to the replacer.
+   * The caller must hold latch_.
+   * @param frame_id frame to install the page in
+   * @param page_id page to install
+   * @param[out] victim_page_id the page that must be written back, INVALID_PAGE_ID if none
+   */
+  void InstallPage(frame_id_t frame_id, page_id_t page_id, page_id_t *victim_page_id);
+
+  /**
+   * Clear the pending I/O state of a frame installed by InstallPage and wake up everyone waiting on it.
+   * @param lock the caller's (unlocked) lock on latch_, it is re-acquired and released again
+   * @param frame_id frame whose I/O finished
+   * @param victim_page_id the page that was written back, INVALID_PAGE_ID if none
+   */
+  void FinishIo(std::unique_lock<std::mutex> *lock, frame_id_t frame_id, page_id_t victim_page_id);
+
+  /**
+   * Feed a page fetch to the sequential access detector. Once READ_AHEAD_TRIGGER fetches in a row have asked for this
+   * instance's consecutive page ids, the pages following them are prefetched, read_ahead_window_ pages ahead of the
+   * reader. Only enabled on top of an asynchronous disk manager, where the prefetch does not block the fetch.
+   * @param page_id the page being fetched
+   */
+  void DetectSequentialAccess(page_id_t page_id);
+
+  /**
+   * Perform a batch of disk requests and wait until all of them have completed. A synchronous disk manager performs
+   * them as they are submitted; only an asynchronous one gets callbacks to wait on.
+   * @param requests the requests, without callbacks
+   */
+  void PerformIo(std::vector<DiskRequest> *requests);
+
+  /** Completion of the write-back of a page evicted by PrefetchPages. */
+  void FinishPrefetchWrite(frame_id_t frame_id, page_id_t victim_page_id);
+
+  /** Completion of a read issued by PrefetchPages: clears the pending I/O and drops the prefetch's pin. */
+  void FinishPrefetchRead(frame_id_t frame_id);
+
+  /** The last step of the completion of any prefetch request, once it is done with the frame and the replacer. */
+  void FinishPrefetchRequest();
+
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
   /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
@@ -142,13 +266,45 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  /** Page table for keeping track of buffer pool pages, split into PAGE_TABLE_STRIPES stripes. */
+  PageTableStripe page_table_[PAGE_TABLE_STRIPES];
   /** Replacer to find unpinned pages for replacement. */
   Replacer *replacer_;
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** Background writer started by StartBackgroundWriter, nullptr if there is none. */
+  std::unique_ptr<BackgroundWriter> background_writer_;
+  /** Frame at which the next PinColdDirtyPages sweep starts. */
+  size_t writer_hand_ = 0;
+  /** Pages whose dirty contents are being written back, mapped to the frame that still holds them. */
+  std::unordered_map<page_id_t, frame_id_t> evicting_pages_;
+  /** One condition variable per frame, notified when the pending I/O on that frame completes. */
+  std::condition_variable *io_cvs_;
+  /** One sequential access pattern followed by the read-ahead detector. */
+  struct ReadAheadStream {
+    /** The page that continues the pattern. */
+    std::atomic<page_id_t> next_expected_{INVALID_PAGE_ID};
+    /** The number of consecutive pages fetched so far. */
+    std::atomic<uint32_t> run_length_{0};
+    /** Pages below this one have already been prefetched. */
+    std::atomic<page_id_t> prefetched_until_{INVALID_PAGE_ID};
+  };
+
+  /** Number of pages read ahead of a sequential pattern, 0 to disable read-ahead. */
+  size_t read_ahead_window_;
+  /** The sequential patterns being followed. */
+  ReadAheadStream read_ahead_streams_[READ_AHEAD_STREAMS];
+  /** Round-robin cursor picking the stream that a new pattern replaces. */
+  std::atomic<uint32_t> next_read_ahead_stream_{0};
+  /** Number of disk requests issued by PrefetchPages that have not completed yet. */
+  size_t pending_prefetch_io_ = 0;
+  /** Notified whenever a prefetch request completes. */
+  std::condition_variable prefetch_cv_;
+  /**
+   * This latch serializes misses, new pages and deletions: it protects evicting_pages_, the free list, the choice of
+   * victims and changes to a frame's page id. Hits only take a page table stripe latch. The latch is never held
+   * across disk I/O: frames with I/O in flight are marked io_pending_ instead.
+   */
   std::mutex latch_;
 };
 }  // namespace bustub
@@ -12,8 +12,7 @@
 
 #pragma once
 
-#include <list>
-#include <mutex>  // NOLINT
+#include <atomic>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -23,6 +22,8 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ * Every frame has a reference bit and an in-clock bit, so Pin and Unpin are single atomic bit flips; only Victim
+ * sweeps, advancing a shared atomic clock hand.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -43,10 +44,25 @@ class ClockReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void Release(frame_id_t frame_id) override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
   size_t Size() override;
 
  private:
-  // TODO(student): implement me!
+  /** Number of frames the clock covers. */
+  const size_t num_pages_;
+  /** True if the frame may be victimized, i.e. it is currently in the clock. */
+  std::vector<std::atomic<bool>> in_clock_;
+  /** Reference bit of each frame, set on Unpin and cleared by the sweeping hand. */
+  std::vector<std::atomic<bool>> ref_bits_;
+  /** Position of the clock hand; taken modulo num_pages_. */
+  std::atomic<size_t> hand_ = 0;
+  /** Number of frames in the clock. */
+  std::atomic<size_t> size_ = 0;
 };
 
 }  // namespace bustub
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <mutex>  // NOLINT
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * The victim is the evictable frame whose K-th most recent access lies furthest in the past (its backward K-distance
+ * is the largest). Frames with fewer than K recorded accesses have an infinite backward K-distance and go first, in
+ * the order of their earliest access. A page touched once by a sequential scan therefore never pushes out a page that
+ * is looked up repeatedly.
+ *
+ * Accesses are recorded through RecordAccess(), apart from pinning. A frame unpinned without any access, such as a
+ * prefetched page, is treated as accessed fewer than K times from the moment it was unpinned, without an access being
+ * recorded. The history of a frame is forgotten when it is removed, which the buffer pool does once it places another
+ * page in the frame; a victim it gives back because the page was pinned in the meantime keeps its history.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of accesses remembered per frame
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = 2);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void Release(frame_id_t frame_id) override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+ private:
+  /** Eviction order of a frame: (has K accesses, oldest remembered access, frame id), smallest first. */
+  using EvictionKey = std::tuple<bool, uint64_t, frame_id_t>;
+
+  /** @return the eviction order of a frame; the caller must hold latch_ */
+  EvictionKey GetEvictionKey(frame_id_t frame_id) const;
+
+  /** Append an access at the current time to a frame's history; the caller must hold latch_. */
+  void AppendAccess(frame_id_t frame_id);
+
+  std::mutex latch_;
+  /** Number of accesses remembered per frame. */
+  const size_t k_;
+  /** Logical clock, advanced on every recorded access. */
+  uint64_t current_timestamp_ = 0;
+  /** The last (at most) k_ access times of each frame, oldest first. */
+  std::vector<std::deque<uint64_t>> history_;
+  /** When each frame without recorded accesses was unpinned, standing in for its oldest access. */
+  std::vector<uint64_t> unpinned_at_;
+  /** True if the frame may be victimized. */
+  std::vector<bool> evictable_;
+  /** Evictable frames ordered by their eviction key. */
+  std::set<EvictionKey> eviction_order_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,10 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
+#include "buffer/background_writer.h"
 #include "buffer/buffer_pool_manager.h"
 #include "buffer/buffer_pool_manager_instance.h"
 #include "recovery/log_manager.h"
@@ -28,9 +32,10 @@ class ParallelBufferPoolManager : public BufferPoolManager {
    * @param pool_size the pool size of each BufferPoolManagerInstance
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of every BufferPoolManagerInstance
    */
   ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRU);
 
   /**
    * Destroys an existing ParallelBufferPoolManager.
@@ -40,6 +45,25 @@ class ParallelBufferPoolManager : public BufferPoolManager {
   /** @return size of the buffer pool */
   size_t GetPoolSize() override;
 
+  /**
+   * Start one background writer shared by all instances. Sharing it lets runs of adjacent page ids, which are spread
+   * round-robin over the instances, be written with a single write.
+   * @param clean_frame_target number of clean frames to keep ready in each instance
+   */
+  void StartBackgroundWriter(size_t clean_frame_target);
+
+  /** Stop the background writer started by StartBackgroundWriter, if any. */
+  void StopBackgroundWriter();
+
+  /**
+   * Prefetch the given pages, each from the instance responsible for it.
+   * @param page_ids the pages that are about to be fetched
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids) override;
+
+  /** @return the read-ahead window of each instance, 0 if read-ahead is disabled */
+  size_t GetReadAheadWindow() override;
+
  protected:
   /**
    * @param page_id id of page
@@ -98,5 +122,8 @@ class ParallelBufferPoolManager : public BufferPoolManager {
   size_t start_index_ = 0;
   uint32_t num_instances_ = 1;
   size_t pool_size_;
+  DiskManager *disk_manager_;
+  /** Background writer shared by all instances, nullptr if there is none. */
+  std::unique_ptr<BackgroundWriter> background_writer_;
 };
 }  // namespace bustub
@@ -16,6 +16,9 @@
 
 namespace bustub {
 
+/** Replacement policies a buffer pool can be configured with. */
+enum class ReplacerType { LRU, CLOCK, LRU_K };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -32,7 +35,8 @@ class Replacer {
   virtual bool Victim(frame_id_t *frame_id) = 0;
 
   /**
-   * Pins a frame, indicating that it should not be victimized until it is unpinned.
+   * Pins a frame, indicating that it should not be victimized until it is unpinned. Pinning does not count as a use of
+   * the page in the frame; see RecordAccess().
    * @param frame_id the id of the frame to pin
    */
   virtual void Pin(frame_id_t frame_id) = 0;
@@ -43,6 +47,28 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Hands back a frame that was held without pinning it in the replacer and without using its page, e.g. to write
+   * the page back. A frame the replacer still tracks keeps its place, rather than counting as just used as it would
+   * with Unpin; one that was pinned in the meantime, by a user or by Victim, is unpinned as usual.
+   * @param frame_id the id of the frame to release
+   */
+  virtual void Release(frame_id_t frame_id) = 0;
+
+  /**
+   * Records a use of the page in a frame, for policies that keep a history of uses. Policies that only order frames
+   * by when they were unpinned ignore it.
+   * @param frame_id the id of the frame whose page was used
+   */
+  virtual void RecordAccess(frame_id_t frame_id) = 0;
+
+  /**
+   * Removes a frame whose page is gone, e.g. deleted: the frame is not victimized, and whatever is remembered about
+   * its page is forgotten, so that the next page placed in the frame starts afresh.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) = 0;
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
@@ -21,8 +21,10 @@
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "container/hash/hash_function.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/page/header_page.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -192,18 +194,7 @@ class Catalog {
   IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
                          std::size_t keysize, HashFunction<KeyType> hash_function) {
-    // Reject the creation request for nonexistent table
-    if (table_names_.find(table_name) == table_names_.end()) {
-      return NULL_INDEX_INFO;
-    }
-
-    // If the table exists, an entry for the table should already be present in index_names_
-    BUSTUB_ASSERT((index_names_.find(table_name) != index_names_.end()), "Broken Invariant");
-
-    // Determine if the requested index already exists for this table
-    auto &table_indexes = index_names_.find(table_name)->second;
-    if (table_indexes.find(index_name) != table_indexes.end()) {
-      // The requested index already exists for this table
+    if (!IsNewIndex(index_name, table_name)) {
       return NULL_INDEX_INFO;
     }
 
@@ -216,27 +207,33 @@ class Catalog {
     // just the key, value, and comparator types
     auto index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
                                                                                                hash_function);
+    return AddIndex(txn, std::move(index), index_name, table_name, schema, key_schema, key_attrs, keysize);
+  }
 
-    // Populate the index with all tuples in table heap
-    auto *table_meta = GetTable(table_name);
-    auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+  /**
+   * Create a new B+ tree index, populate existing data of the table and return its metadata.
+   * Unlike a hash index, a B+ tree index also serves range predicates, see IndexScanExecutor.
+   * @param txn The transaction in which the table is being created
+   * @param index_name The name of the new index
+   * @param table_name The name of the table
+   * @param schema The schema of the table
+   * @param key_schema The schema of the key
+   * @param key_attrs Key attributes
+   * @param keysize Size of the key
+   * @return A (non-owning) pointer to the metadata of the new index
+   */
+  template <class KeyType, class ValueType, class KeyComparator>
+  IndexInfo *CreateBPlusTreeIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                                  const Schema &schema, const Schema &key_schema,
+                                  const std::vector<uint32_t> &key_attrs, std::size_t keysize) {
+    if (!IsNewIndex(index_name, table_name)) {
+      return NULL_INDEX_INFO;
     }
 
-    // Get the next OID for the new index
-    const auto index_oid = next_index_oid_.fetch_add(1);
-
-    // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
-    auto *tmp = index_info.get();
-
-    // Update internal tracking
-    indexes_.emplace(index_oid, std::move(index_info));
-    table_indexes.emplace(index_name, index_oid);
-
-    return tmp;
+    auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
+    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                     GetHeaderPageId());
+    return AddIndex(txn, std::move(index), index_name, table_name, schema, key_schema, key_attrs, keysize);
   }
 
   /**
@@ -323,6 +320,62 @@ class Catalog {
   }
 
  private:
+  /** @return true if the table exists and has no index of that name yet */
+  bool IsNewIndex(const std::string &index_name, const std::string &table_name) {
+    // Reject the creation request for nonexistent table
+    if (table_names_.find(table_name) == table_names_.end()) {
+      return false;
+    }
+
+    // If the table exists, an entry for the table should already be present in index_names_
+    BUSTUB_ASSERT((index_names_.find(table_name) != index_names_.end()), "Broken Invariant");
+
+    // Determine if the requested index already exists for this table
+    auto &table_indexes = index_names_.find(table_name)->second;
+    return table_indexes.find(index_name) == table_indexes.end();
+  }
+
+  /** Populate a new index with all tuples in the table heap and start tracking it. */
+  IndexInfo *AddIndex(Transaction *txn, std::unique_ptr<Index> &&index, const std::string &index_name,
+                      const std::string &table_name, const Schema &schema, const Schema &key_schema,
+                      const std::vector<uint32_t> &key_attrs, std::size_t keysize) {
+    // Populate the index with all tuples in table heap
+    auto *table_meta = GetTable(table_name);
+    auto *heap = table_meta->table_.get();
+    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
+      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+    }
+
+    // Get the next OID for the new index
+    const auto index_oid = next_index_oid_.fetch_add(1);
+
+    // Construct index information; IndexInfo takes ownership of the Index itself
+    auto index_info =
+        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto *tmp = index_info.get();
+
+    // Update internal tracking
+    indexes_.emplace(index_oid, std::move(index_info));
+    index_names_.find(table_name)->second.emplace(index_name, index_oid);
+
+    return tmp;
+  }
+
+  /**
+   * B+ trees record their root page ids in a header page. The catalog allocates its own on first use rather than
+   * assuming page 0, which may already hold a table.
+   * @return the id of the header page shared by the B+ tree indexes of this catalog
+   */
+  page_id_t GetHeaderPageId() {
+    if (header_page_id_ == INVALID_PAGE_ID) {
+      auto *header_page = reinterpret_cast<HeaderPage *>(bpm_->NewPage(&header_page_id_));
+      BUSTUB_ASSERT(header_page != nullptr, "no free frame for the catalog header page");
+      header_page->Init();
+      bpm_->UnpinPage(header_page_id_, true);
+    }
+    return header_page_id_;
+  }
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
@@ -352,6 +405,9 @@ class Catalog {
 
   /** The next index identifier to be used. */
   std::atomic<index_oid_t> next_index_oid_{0};
+
+  /** The header page of the B+ tree indexes, allocated by GetHeaderPageId. */
+  page_id_t header_page_id_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena.h
+//
+// Identification: src/include/common/arena.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * Arena hands out memory from large chunks, for data structures that allocate many small objects and free them all
+ * at once, such as the entries of a hash table. An allocation is a pointer bump; nothing is freed before Clear().
+ */
+class Arena {
+ public:
+  /** The default size of a chunk in bytes */
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+  /** @param chunk_size the size of a chunk in bytes; larger allocations get a chunk of their own */
+  explicit Arena(size_t chunk_size = DEFAULT_CHUNK_SIZE) : chunk_size_(chunk_size) {}
+
+  DISALLOW_COPY_AND_MOVE(Arena);
+
+  /**
+   * @param size the number of bytes to allocate
+   * @param alignment the alignment of the allocation, a power of two of at most alignof(std::max_align_t)
+   * @return uninitialized memory that stays valid until Clear()
+   */
+  char *Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    size_t padding = (alignment - reinterpret_cast<uintptr_t>(cursor_) % alignment) % alignment;
+    if (cursor_ == nullptr || padding + size > remaining_) {
+      size_t new_chunk_size = std::max(chunk_size_, size);
+      chunks_.push_back(std::make_unique<char[]>(new_chunk_size));
+      memory_usage_ += new_chunk_size;
+      cursor_ = chunks_.back().get();
+      remaining_ = new_chunk_size;
+      padding = 0;
+    }
+    char *result = cursor_ + padding;
+    cursor_ += padding + size;
+    remaining_ -= padding + size;
+    return result;
+  }
+
+  /** Free everything allocated so far. */
+  void Clear() {
+    chunks_.clear();
+    cursor_ = nullptr;
+    remaining_ = 0;
+    memory_usage_ = 0;
+  }
+
+  /** @return the number of bytes held in chunks */
+  size_t MemoryUsage() const { return memory_usage_; }
+
+ private:
+  const size_t chunk_size_;
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  /** The free part of the last chunk */
+  char *cursor_{nullptr};
+  size_t remaining_{0};
+  size_t memory_usage_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bounded_queue.h
+//
+// Identification: src/include/common/bounded_queue.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * BoundedQueue is a fixed-capacity, lock-free queue for any number of producer and consumer threads.
+ *
+ * This is the array-based design by Dmitry Vyukov: every cell carries a sequence number, which tells a producer
+ * whether the cell is free for the current lap around the ring and a consumer whether it has been filled. A thread
+ * claims a cell with one compare-and-swap on the shared position, so threads never wait on each other; the Try
+ * operations fail instead when the queue is full or empty, and callers decide how to wait.
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  /** @param capacity the most items the queue holds; rounded up to a power of two */
+  explicit BoundedQueue(size_t capacity) {
+    capacity_ = 1;
+    while (capacity_ < capacity) {
+      capacity_ <<= 1;
+    }
+    mask_ = capacity_ - 1;
+    cells_ = std::make_unique<Cell[]>(capacity_);
+    for (size_t i = 0; i < capacity_; i++) {
+      cells_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(BoundedQueue);
+
+  /** @return the most items the queue holds */
+  size_t Capacity() const { return capacity_; }
+
+  /**
+   * Add an item at the tail.
+   * @param item the item, moved from only if it was added
+   * @return false if the queue is full
+   */
+  bool TryPush(T *item) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell &cell = cells_[pos & mask_];
+      size_t sequence = cell.sequence_.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell.data_ = std::move(*item);
+          cell.sequence_.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // the cell still holds the item of the previous lap
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * Remove the item at the head.
+   * @param[out] item the item removed
+   * @return false if the queue is empty
+   */
+  bool TryPop(T *item) {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell &cell = cells_[pos & mask_];
+      size_t sequence = cell.sequence_.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          *item = std::move(cell.data_);
+          cell.sequence_.store(pos + capacity_, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // the cell has not been filled in this lap
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence_;
+    T data_;
+  };
+
+  /** The positions live on cache lines of their own, so that producers and consumers do not false-share. */
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
+  size_t capacity_;
+  size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_{0};
+};
+
+}  // namespace bustub
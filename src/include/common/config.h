@@ -27,14 +27,29 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** A running background page writer looks for cold dirty frames every BACKGROUND_WRITER_INTERVAL milliseconds. */
+extern std::chrono::milliseconds background_writer_interval;
+
 static constexpr int INVALID_PAGE_ID = -1;                                    // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                     // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                      // the header page id
 static constexpr int PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int DIRECT_IO_ALIGNMENT = 512;                               // buffer alignment required by O_DIRECT
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int PAGE_TABLE_STRIPES = 16;                                 // latched stripes per page table
+static constexpr int BACKGROUND_WRITE_MAX_PAGES = 32;  // most adjacent pages the background writer writes at once
+static constexpr int READ_AHEAD_WINDOW = 16;           // pages prefetched ahead of a sequential access pattern
+static constexpr int ASYNC_IO_THREADS = 4;             // worker threads serving the requests of an AsyncDiskManager
+static constexpr int IO_URING_ENTRIES = 32;            // submissions the io_uring ring of an AsyncDiskManager holds
+static constexpr int READ_AHEAD_TRIGGER = 4;           // consecutive page fetches that make a pattern sequential
+static constexpr int READ_AHEAD_STREAMS = 4;           // sequential patterns tracked at once by a buffer pool
+static constexpr int BATCH_SIZE = 1024;                // rows in a batch passed between executors
+static constexpr int MORSEL_SIZE = 16;                 // pages a parallel scan worker takes at a time
+static constexpr int EXCHANGE_QUEUE_BATCHES = 8;       // batches queued between the threads of a parallel plan
+static constexpr int QUERY_MEMORY_LIMIT = 256 << 20;   // bytes of memory the operators of a query hold at most
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// thread_pool.h
+//
+// Identification: src/include/common/thread_pool.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ThreadPool runs tasks on a set of reusable worker threads.
+ *
+ * A task always starts right away: it goes to an idle worker, or to a new one when every worker is busy. Tasks of a
+ * parallel query wait on each other through queues, so making a task wait for a worker to free up could deadlock.
+ * Workers stay around once created, so the pool is as large as the most tasks that ever ran at once.
+ */
+class ThreadPool {
+ public:
+  ThreadPool() = default;
+
+  /** Waits for the running tasks and stops the workers. */
+  ~ThreadPool();
+
+  DISALLOW_COPY_AND_MOVE(ThreadPool);
+
+  /** Run a task on a worker thread. */
+  void Submit(std::function<void()> task);
+
+  /** @return the number of worker threads */
+  size_t Size();
+
+ private:
+  /** Body of a worker thread. */
+  void WorkerLoop();
+
+  /** Protects all of the members below. */
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  size_t idle_workers_{0};
+  bool stopping_{false};
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -38,6 +39,33 @@ class HashUtil {
     return hash;
   }
 
+  /**
+   * Hash bytes eight at a time, finishing with the MurmurHash3 finalizer so that every bit of the input affects the
+   * low bits of the hash. Open-addressed hash tables index by those bits, which HashBytes() leaves poorly mixed.
+   */
+  static inline hash_t HashBytesMixed(const char *bytes, size_t length) {
+    constexpr uint64_t multiplier = 0x9e3779b97f4a7c15ULL;
+    uint64_t hash = length * multiplier;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, bytes + i, sizeof(uint64_t));
+      hash = (hash ^ word) * multiplier;
+      hash ^= hash >> 32;
+    }
+    if (i < length) {
+      uint64_t word = 0;
+      memcpy(&word, bytes + i, length - i);
+      hash = (hash ^ word) * multiplier;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return static_cast<hash_t>(hash);
+  }
+
   static inline hash_t CombineHashes(hash_t l, hash_t r) {
     hash_t both[2] = {};
     both[0] = l;
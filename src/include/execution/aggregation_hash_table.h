@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table.h
+//
+// Identification: src/include/execution/aggregation_hash_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/tuple_batch.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * AggregationHashTable groups the rows of batches by their group-by keys and keeps COUNT, SUM, MIN and MAX for each
+ * group, without creating a Value per row for inputs that are plain columns.
+ *
+ * A group is a fixed-width record of 64-bit words, stored back to back with the others in the order the groups were
+ * created: a word of NULL flags and a word per key column, then a word of flags for which aggregates have a value and
+ * a word per aggregate. Key columns are packed into their word as int64 for integral types and as the bits of a double
+ * for DECIMAL; VARCHAR keys are replaced by an index into a dictionary of the strings seen. Aggregate states are kept
+ * as raw int64 or double. A linear-probing table of (hash, group) slots, at most half full, finds the group of a key.
+ * A VARCHAR key is hashed by its string rather than its index, so a key has the same hash in every table, and the
+ * groups of tables filled by different threads can be split by hash and merged with MergeGroup().
+ *
+ * Rows with NULL keys form groups of their own. COUNT counts every row; SUM, MIN and MAX skip NULL inputs and are NULL
+ * for a group without other inputs. Results have the types AggregationExecutor has always produced: COUNT is INTEGER,
+ * SUM of an integral type narrower than BIGINT is INTEGER, and MIN and MAX have the type of their input.
+ */
+class AggregationHashTable {
+ public:
+  /**
+   * Create an empty table.
+   * @param group_bys the group-by expressions, over the batches that will be inserted
+   * @param aggregates the expressions to aggregate
+   * @param agg_types the aggregation of each aggregate expression
+   */
+  AggregationHashTable(const std::vector<const AbstractExpression *> &group_bys,
+                       const std::vector<const AbstractExpression *> &aggregates,
+                       const std::vector<AggregationType> &agg_types);
+
+  /**
+   * Add every row of a batch to its group.
+   * @param batch the rows to add
+   * @param[out] created if given, gets the rows that created a group, i.e. the first row of each new key
+   */
+  void InsertBatch(const TupleBatch &batch, std::vector<size_t> *created = nullptr);
+
+  /**
+   * Add the rows of a batch whose group exists to it, without creating groups for the other rows.
+   * @param batch the rows to add
+   * @param[out] rejected the rows whose group does not exist, with the hash of their key
+   */
+  void UpdateBatch(const TupleBatch &batch, std::vector<std::pair<size_t, hash_t>> *rejected);
+
+  /** @return the number of groups */
+  size_t NumGroups() const { return groups_.size() / group_words_; }
+
+  /**
+   * Read a group out of the table.
+   * @param group the index of the group, in the order groups were created
+   * @param[out] group_bys the keys of the group
+   * @param[out] aggregates the aggregates of the group
+   */
+  void GetGroup(size_t group, std::vector<Value> *group_bys, std::vector<Value> *aggregates) const;
+
+  /** @return the hash of the key of a group, equal to the hash of the same key in any other table */
+  hash_t GetGroupHash(size_t group) const { return group_hashes_[group]; }
+
+  /**
+   * Fold a group of another table over the same group-bys and aggregates into this one, as if the rows of the group
+   * had been inserted here.
+   * @param other the table that holds the group
+   * @param group the index of the group in the other table
+   */
+  void MergeGroup(const AggregationHashTable &other, size_t group);
+
+  /** @return the bytes the table takes */
+  size_t MemoryUsage() const;
+
+  /** Remove all groups, giving back the memory they took. */
+  void Clear();
+
+ private:
+  /** Where a group-by or aggregate input comes from: straight from a column of the batch, or from its expression */
+  struct Input {
+    const AbstractExpression *expr_;
+    /** The column of the batch the expression reads, or -1 if it is not a plain column */
+    int64_t col_idx_;
+    TypeId type_;
+  };
+
+  struct Slot {
+    hash_t hash_;
+    /** One more than the index of the group; 0 for an empty slot */
+    uint64_t group_;
+  };
+
+  static constexpr size_t INITIAL_SLOTS = 64;
+  static constexpr size_t NO_GROUP = static_cast<size_t>(-1);
+
+  /** Add the rows of a batch to their groups, creating the missing groups or else rejecting their rows. */
+  template <bool CreateGroups>
+  void AddBatch(const TupleBatch &batch, std::vector<size_t> *created,
+                std::vector<std::pair<size_t, hash_t>> *rejected);
+
+  /**
+   * Read an input for every row of a batch into words[row * stride] in packed form, or set null_bit in
+   * null_flags[row * stride] for the rows where it is NULL.
+   */
+  void ReadInput(const Input &input, const TupleBatch &batch, uint64_t *words, uint64_t *null_flags, uint64_t null_bit,
+                 size_t stride, bool is_key);
+
+  /** @return the packed form of a non-NULL value of the input's type */
+  uint64_t PackValue(const Input &input, const Value &value, bool is_key);
+
+  /** @return the index of a string in the dictionary, added if it is new */
+  uint64_t InternString(std::string string);
+
+  /** @return the hash of a packed key, computed over the hashes of its strings in place of their indexes */
+  hash_t HashKey(const uint64_t *key);
+
+  /** @return the value of a packed word of the given type */
+  Value UnpackValue(TypeId type, uint64_t word) const;
+
+  /** @return the index of the group of a packed key; if the key is new, a group created for it or NO_GROUP */
+  template <bool CreateGroups>
+  size_t FindGroup(const uint64_t *key, hash_t hash);
+
+  /** Double the number of slots. */
+  void Grow();
+
+  std::vector<Input> keys_;
+  std::vector<Input> aggregates_;
+  std::vector<AggregationType> agg_types_;
+  /** The key columns of type VARCHAR */
+  std::vector<size_t> varchar_keys_;
+  /** Words in a packed key, the offset of the aggregates in a group, and words in a group */
+  size_t key_words_;
+  size_t agg_offset_;
+  size_t group_words_;
+
+  std::vector<uint64_t> groups_;
+  std::vector<hash_t> group_hashes_;
+  std::vector<Slot> slots_;
+  size_t mask_;
+  /** The VARCHAR keys seen, the hash of each, and the index of each */
+  std::vector<std::string> strings_;
+  std::vector<hash_t> string_hashes_;
+  std::unordered_map<std::string, uint64_t> string_ids_;
+
+  /** Scratch space for InsertBatch(): the packed keys and hashes of a batch, the group of each row, an input column */
+  std::vector<uint64_t> batch_keys_;
+  std::vector<hash_t> batch_hashes_;
+  std::vector<size_t> batch_groups_;
+  std::vector<uint64_t> batch_values_;
+  std::vector<uint64_t> batch_nulls_;
+  /** Scratch space for HashKey() */
+  std::vector<uint64_t> hash_key_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_channel.h
+//
+// Identification: src/include/execution/batch_channel.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <memory>
+#include <mutex>  // NOLINT
+
+#include "common/bounded_queue.h"
+#include "common/config.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * BatchChannel carries the batches of a parallel plan from the threads that produce them to the one executor that
+ * consumes them.
+ *
+ * The batches pass through a lock-free BoundedQueue, so a producer that gets ahead of the consumer waits for room
+ * instead of buffering its whole output. A waiting thread spins briefly, then yields, which keeps the hand off cheap
+ * while both sides are busy, and then blocks until the other side pushes, pops, closes the channel or reports done.
+ * Each producer reports that it is done, optionally with the error that stopped it; the consumer sees the end of the
+ * stream once all of them are done, or gets the error rethrown.
+ */
+class BatchChannel {
+ public:
+  /**
+   * @param capacity the most batches in flight
+   * @param num_producers the number of producers that report ProducerDone()
+   */
+  BatchChannel(size_t capacity, size_t num_producers);
+
+  DISALLOW_COPY_AND_MOVE(BatchChannel);
+
+  /**
+   * Hand a batch to the consumer, waiting while the channel is full; producer side.
+   * @return false if the consumer closed the channel, in which case the producer should stop
+   */
+  bool Push(std::unique_ptr<TupleBatch> batch);
+
+  /**
+   * Report that a producer will push no more batches; the last access of a producer to the channel.
+   * @param error the error that stopped the producer, rethrown to the consumer; nullptr if it finished normally
+   */
+  void ProducerDone(std::exception_ptr error = nullptr);
+
+  /**
+   * Fill a batch with the next rows pushed by the producers; consumer side. Waits for rows only while the batch is
+   * empty, so that a batch is handed out as soon as it has rows.
+   * @param[out] batch the batch to fill, with the same column types as the pushed batches
+   * @return false if all producers are done and every row has been handed out
+   */
+  bool NextBatch(TupleBatch *batch);
+
+  /** Tell the producers to stop, dropping whatever they push from now on; consumer side. */
+  void Close() {
+    closed_ = true;
+    Notify();
+  }
+
+  /** Wait until every producer has reported ProducerDone(); call Close() first unless the input has been drained. */
+  void WaitForProducers();
+
+ private:
+  /**
+   * Wait a little longer on each round: spin, then yield, then block until the state of the channel changes.
+   * @param round the number of rounds waited so far, incremented
+   * @param seen the value of events_ read before checking the state that the caller waits to change
+   */
+  void Wait(size_t *round, uint64_t seen);
+
+  /** Count a change of the state of the channel, and wake up the threads blocked in Wait(). */
+  void Notify();
+
+  /** Take the next pushed batch into pending_, waiting for one unless dont_wait is set. */
+  bool NextPending(bool dont_wait);
+
+  BoundedQueue<std::unique_ptr<TupleBatch>> queue_;
+  const size_t num_producers_;
+  std::atomic<size_t> done_producers_{0};
+  std::atomic<bool> closed_{false};
+  /** Set once error_ holds the first error of a producer */
+  std::atomic<bool> failed_{false};
+  std::mutex error_latch_;
+  std::exception_ptr error_;
+  /** The number of changes of the state so far, and the number of threads blocked until the next one */
+  std::atomic<uint64_t> events_{0};
+  std::atomic<size_t> num_waiters_{0};
+  std::mutex wait_latch_;
+  std::condition_variable wait_cv_;
+  /** The batch the consumer is copying rows from, and its next row */
+  std::unique_ptr<TupleBatch> pending_;
+  size_t pending_row_{0};
+};
+
+}  // namespace bustub
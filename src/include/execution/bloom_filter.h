@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.h
+//
+// Identification: src/include/execution/bloom_filter.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/util/hash_util.h"
+
+namespace bustub {
+
+/**
+ * BloomFilter is a blocked Bloom filter over key hashes: it answers whether a hash may have been inserted, with no
+ * false negatives and a small rate of false positives.
+ *
+ * Each key sets one bit in each of the eight words of a single 64-byte block, so a lookup touches one cache line.
+ * The low bits of the hash pick the block and a multiplied copy of the hash picks the bits. At BITS_PER_KEY bits per
+ * key the false positive rate is under one percent. Inserting more keys than the filter was sized for raises the rate
+ * but never causes false negatives; inserting fewer leaves room that ShrinkToFit() gives back.
+ */
+class BloomFilter {
+ public:
+  /** Bits of filter per key it is sized for */
+  static constexpr size_t BITS_PER_KEY = 16;
+
+  /** @param num_keys the number of keys to size the filter for */
+  explicit BloomFilter(size_t num_keys) {
+    size_t num_blocks = NumBlocks(num_keys);
+    blocks_.assign(num_blocks, Block{});
+    mask_ = num_blocks - 1;
+  }
+
+  /** @return the bytes a filter sized for num_keys keys takes */
+  static size_t MemoryUsage(size_t num_keys) { return NumBlocks(num_keys) * sizeof(Block); }
+
+  /** Add a hash to the filter. */
+  void Insert(hash_t hash) {
+    num_inserted_++;
+    Block &block = blocks_[hash & mask_];
+    uint64_t bits = BitSource(hash);
+    for (size_t i = 0; i < WORDS_PER_BLOCK; i++) {
+      block.words_[i] |= uint64_t{1} << ((bits >> (BIT_INDEX_WIDTH * i)) & (WORD_BITS - 1));
+    }
+  }
+
+  /** @return false if the hash was certainly not inserted */
+  bool MayContain(hash_t hash) const {
+    const Block &block = blocks_[hash & mask_];
+    uint64_t bits = BitSource(hash);
+    uint64_t missing = 0;
+    for (size_t i = 0; i < WORDS_PER_BLOCK; i++) {
+      missing |= ~block.words_[i] & (uint64_t{1} << ((bits >> (BIT_INDEX_WIDTH * i)) & (WORD_BITS - 1)));
+    }
+    return missing == 0;
+  }
+
+  /** Start loading the block of a hash into the cache, ahead of MayContain(). */
+  void Prefetch(hash_t hash) const { __builtin_prefetch(&blocks_[hash & mask_]); }
+
+  /** @return the bytes the filter takes */
+  size_t MemoryUsage() const { return blocks_.size() * sizeof(Block); }
+
+  /**
+   * Shrink the filter to the size for the number of hashes inserted so far, keeping them all. Blocks are picked by
+   * the low bits of the hash, so halving the filter merges each block of the upper half into the block of the lower
+   * half that the hashes in it now map to.
+   */
+  void ShrinkToFit() {
+    size_t num_blocks = blocks_.size();
+    while (num_blocks > NumBlocks(num_inserted_)) {
+      num_blocks /= 2;
+      for (size_t i = 0; i < num_blocks; i++) {
+        for (size_t j = 0; j < WORDS_PER_BLOCK; j++) {
+          blocks_[i].words_[j] |= blocks_[num_blocks + i].words_[j];
+        }
+      }
+    }
+    blocks_.resize(num_blocks);
+    blocks_.shrink_to_fit();
+    mask_ = num_blocks - 1;
+  }
+
+ private:
+  static constexpr size_t WORD_BITS = 64;
+  static constexpr size_t WORDS_PER_BLOCK = 8;
+  static constexpr size_t BLOCK_BITS = WORD_BITS * WORDS_PER_BLOCK;
+  static constexpr size_t BIT_INDEX_WIDTH = 6;
+
+  struct alignas(64) Block {
+    uint64_t words_[WORDS_PER_BLOCK];
+  };
+
+  /** @return the number of blocks, a power of two, of a filter sized for num_keys keys */
+  static size_t NumBlocks(size_t num_keys) {
+    size_t num_blocks = 1;
+    while (num_blocks * BLOCK_BITS < num_keys * BITS_PER_KEY) {
+      num_blocks *= 2;
+    }
+    return num_blocks;
+  }
+
+  /** @return bits of the hash independent of those that pick the block, six for each word */
+  static uint64_t BitSource(hash_t hash) { return (hash * 0x9e3779b97f4a7c15ULL) >> 16; }
+
+  std::vector<Block> blocks_;
+  size_t mask_;
+  /** The number of hashes inserted, counting repeated ones */
+  size_t num_inserted_{0};
+};
+
+}  // namespace bustub
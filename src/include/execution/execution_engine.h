@@ -12,21 +12,28 @@
 
 #pragma once
 
-#include <istream>
-#include <string>
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/catalog.h"
+#include "common/thread_pool.h"
 #include "concurrency/transaction_manager.h"
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/result_cursor.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 namespace bustub {
 
 /**
- * The ExecutionEngine class executes query plans.
+ * The ExecutionEngine class executes query plans. Results are streamed: Open() returns a cursor the client pulls rows
+ * from, Stream() pushes batches into a callback, and Execute() collects them in a vector on top of that.
+ *
+ * Executors that work in parallel, such as Gather and Exchange, run their tasks on a thread pool owned by the engine,
+ * so that queries reuse its threads.
  */
 class ExecutionEngine {
  public:
@@ -41,43 +48,60 @@ class ExecutionEngine {
 
   DISALLOW_COPY_AND_MOVE(ExecutionEngine);
 
+  /**
+   * Start executing a query plan, and stream its result through a cursor. The plan runs as the client pulls rows,
+   * which holds no more than a batch of the result in memory at a time.
+   * @param plan The query plan to execute, which must outlive the cursor
+   * @param txn The transaction context in which the query executes
+   * @param exec_ctx The executor context in which the query executes, which must outlive the cursor
+   * @return The cursor over the result of the plan
+   */
+  std::unique_ptr<ResultCursor> Open(const AbstractPlanNode *plan, Transaction *txn, ExecutorContext *exec_ctx) {
+    // Run the threads of parallel executors on the engine's pool
+    exec_ctx->SetThreadPool(&thread_pool_);
+    return std::make_unique<ResultCursor>(exec_ctx, ExecutorFactory::CreateExecutor(exec_ctx, plan));
+  }
+
+  /**
+   * Execute a query plan, handing its result to a sink one batch at a time.
+   * @param plan The query plan to execute
+   * @param sink Called with each batch of the result; returns `false` to stop the query early
+   * @param txn The transaction context in which the query executes
+   * @param exec_ctx The executor context in which the query executes
+   * @return `true` if execution of the query plan succeeds, `false` if the plan failed or the transaction was aborted
+   */
+  bool Stream(const AbstractPlanNode *plan, const std::function<bool(const TupleBatch &)> &sink, Transaction *txn,
+              ExecutorContext *exec_ctx) {
+    auto cursor = Open(plan, txn, exec_ctx);
+    for (const TupleBatch *batch = cursor->NextBatch(); batch != nullptr; batch = cursor->NextBatch()) {
+      if (!sink(*batch)) {
+        break;
+      }
+    }
+    return cursor->GetError() == nullptr && !cursor->IsAborted();
+  }
+
   /**
    * Execute a query plan.
    * @param plan The query plan to execute
    * @param result_set The set of tuples produced by executing the plan
    * @param txn The transaction context in which the query executes
    * @param exec_ctx The executor context in which the query executes
-   * @return `true` if execution of the query plan succeeds, `false` otherwise
+   * @return `true` if execution of the query plan succeeds, `false` if the plan failed or the transaction was aborted
    */
   bool Execute(const AbstractPlanNode *plan, std::vector<Tuple> *result_set, Transaction *txn,
                ExecutorContext *exec_ctx) {
-    // Construct and executor for the plan
-    auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
-
-    // Prepare the root executor
-    executor->Init();
-    std::ifstream file("/autograder/bustub/test/concurrency/grading_transaction_test");
-    std::string str;
-    while (file.good()) {
-      std::getline(file, str);
-      std::cout << str << std::endl;
-    }
-    // Execute the query plan
-    try {
-      Tuple tuple;
-      RID rid;
-      while (executor->Next(&tuple, &rid)) {
-        if (result_set != nullptr) {
-          result_set->push_back(tuple);
-        }
-      }
-    } catch (TransactionAbortException &e) {
-      std::cout << e.GetInfo();
-      exec_ctx->GetTransactionManager()->Abort(TransactionManager::GetTransaction(e.GetTransactionId()));
-    } catch (Exception &e) {
-      // TODO(student): handle exceptions
-    }
-    return true;
+    return Stream(
+        plan,
+        [result_set](const TupleBatch &batch) {
+          if (result_set != nullptr) {
+            for (size_t row = 0; row < batch.Size(); row++) {
+              result_set->push_back(batch.GetTuple(row));
+            }
+          }
+          return true;
+        },
+        txn, exec_ctx);
   }
 
  private:
@@ -87,6 +111,8 @@ class ExecutionEngine {
   [[maybe_unused]] TransactionManager *txn_mgr_;
   /** The catalog used during query execution */
   [[maybe_unused]] Catalog *catalog_;
+  /** The worker threads shared by the parallel executors of all queries */
+  ThreadPool thread_pool_;
 };
 
 }  // namespace bustub
@@ -12,12 +12,19 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "catalog/catalog.h"
+#include "common/thread_pool.h"
 #include "concurrency/transaction.h"
+#include "execution/memory_budget.h"
+#include "execution/operator_state_registry.h"
+#include "execution/runtime_filter.h"
 #include "storage/page/tmp_tuple_page.h"
 
 namespace bustub {
@@ -36,7 +43,33 @@ class ExecutorContext {
    */
   ExecutorContext(Transaction *transaction, Catalog *catalog, BufferPoolManager *bpm, TransactionManager *txn_mgr,
                   LockManager *lock_mgr)
-      : transaction_(transaction), catalog_{catalog}, bpm_{bpm}, txn_mgr_(txn_mgr), lock_mgr_(lock_mgr) {}
+      : transaction_(transaction),
+        catalog_{catalog},
+        bpm_{bpm},
+        txn_mgr_(txn_mgr),
+        lock_mgr_(lock_mgr),
+        memory_budget_(std::make_shared<MemoryBudget>(QUERY_MEMORY_LIMIT)) {}
+
+  /**
+   * Creates the context of one copy of a plan fragment that runs on several threads.
+   * @param parent The context of the executor that runs the fragment
+   * @param worker_idx Which of the copies this is
+   * @param num_workers The number of copies
+   * @param operator_states The state shared by the copies
+   */
+  ExecutorContext(ExecutorContext *parent, size_t worker_idx, size_t num_workers,
+                  std::shared_ptr<OperatorStateRegistry> operator_states)
+      : transaction_(parent->transaction_),
+        catalog_{parent->catalog_},
+        bpm_{parent->bpm_},
+        txn_mgr_(parent->txn_mgr_),
+        lock_mgr_(parent->lock_mgr_),
+        thread_pool_(parent->GetThreadPool()),
+        txn_latch_(parent->txn_latch_),
+        worker_idx_(worker_idx),
+        num_workers_(num_workers),
+        operator_states_(std::move(operator_states)),
+        memory_budget_(parent->memory_budget_) {}
 
   ~ExecutorContext() = default;
 
@@ -60,6 +93,65 @@ class ExecutorContext {
   /** @return the transaction manager */
   TransactionManager *GetTransactionManager() { return txn_mgr_; }
 
+  /** @return the most threads an executor may use */
+  size_t GetParallelism() const { return parallelism_; }
+
+  /**
+   * Let the executors that can work in parallel, such as sequential scans, use up to this many threads. With the
+   * default of 1 every executor runs on the calling thread and produces its tuples in a deterministic order.
+   */
+  void SetParallelism(size_t parallelism) { parallelism_ = parallelism; }
+
+  /** @return the pool that runs the threads of parallel executors; a context creates its own if none was set */
+  ThreadPool *GetThreadPool() {
+    if (thread_pool_ == nullptr) {
+      own_thread_pool_ = std::make_unique<ThreadPool>();
+      thread_pool_ = own_thread_pool_.get();
+    }
+    return thread_pool_;
+  }
+
+  /** Run the threads of parallel executors on the given pool, e.g. the one owned by the execution engine. */
+  void SetThreadPool(ThreadPool *thread_pool) { thread_pool_ = thread_pool; }
+
+  /**
+   * @return the latch that the threads working for the transaction hold while they call into the lock manager, which
+   * does not expect calls for one transaction from several threads at once
+   */
+  std::mutex *GetTransactionLatch() { return txn_latch_; }
+
+  /** @return which copy of a plan fragment this context belongs to */
+  size_t GetWorkerIndex() const { return worker_idx_; }
+
+  /** @return the number of copies of the plan fragment; 1 unless it runs on several threads */
+  size_t GetNumWorkers() const { return num_workers_; }
+
+  /** @return the state shared by the copies of a plan fragment; nullptr unless it runs on several threads */
+  OperatorStateRegistry *GetOperatorStates() const { return operator_states_.get(); }
+
+  /**
+   * @return the memory the operators of the query may hold, QUERY_MEMORY_LIMIT unless changed; the copies of a plan
+   * fragment share the budget of the context they came from
+   */
+  MemoryBudget *GetMemoryBudget() const { return memory_budget_.get(); }
+
+  /** @return the memory budget, for state that may outlive this context, such as that shared by the copies */
+  std::shared_ptr<MemoryBudget> ShareMemoryBudget() const { return memory_budget_; }
+
+  /**
+   * Push a filter down to the scan of the given plan node, replacing any earlier one. The scan picks it up when it
+   * is next initialized, so an executor pushes a filter before it initializes the child that contains the scan.
+   */
+  void SetRuntimeFilter(const AbstractPlanNode *scan_plan, std::shared_ptr<RuntimeFilter> filter) {
+    runtime_filters_[scan_plan] = std::move(filter);
+  }
+
+  /** @return the filter pushed down to the scan of the given plan node, or nullptr if there is none */
+  std::shared_ptr<RuntimeFilter> GetRuntimeFilter(const AbstractPlanNode *scan_plan) const {
+    auto iter = runtime_filters_.find(scan_plan);
+    return iter == runtime_filters_.end() ? nullptr : iter->second;
+  }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +163,19 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The most threads an executor may use */
+  size_t parallelism_{1};
+  /** The pool that runs the threads of parallel executors */
+  ThreadPool *thread_pool_{nullptr};
+  std::unique_ptr<ThreadPool> own_thread_pool_;
+  /** Serializes calls into the lock manager; the copies of a fragment share the one of the context they came from */
+  std::mutex own_txn_latch_;
+  std::mutex *txn_latch_{&own_txn_latch_};
+  size_t worker_idx_{0};
+  size_t num_workers_{1};
+  std::shared_ptr<OperatorStateRegistry> operator_states_;
+  std::shared_ptr<MemoryBudget> memory_budget_;
+  std::unordered_map<const AbstractPlanNode *, std::shared_ptr<RuntimeFilter>> runtime_filters_;
 };
 
 }  // namespace bustub
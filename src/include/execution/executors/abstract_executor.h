@@ -12,7 +12,10 @@
 
 #pragma once
 
+#include <memory>
+
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -20,6 +23,10 @@ namespace bustub {
  * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
+ *
+ * Executors may also hand out their tuples a batch at a time through NextBatch(). An executor implements at least one
+ * of the two natively: the default NextBatch() is built on Next(), and an executor that produces batches can build
+ * Next() on NextFromBatch(). A caller uses either Next() or NextBatch() between two calls to Init(), not both.
  */
 class AbstractExecutor {
  public:
@@ -46,6 +53,21 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple, RID *rid) = 0;
 
+  /**
+   * Yield the next batch of tuples from this executor. The default implementation collects them from Next().
+   * @param[out] batch Cleared, then filled with up to batch->Capacity() tuples of the output schema
+   * @return `true` if at least one tuple was produced, `false` if there are no more tuples
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    batch->Clear();
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      batch->AppendTuple(tuple, rid);
+    }
+    return !batch->IsEmpty();
+  }
+
   /** @return The schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
@@ -53,7 +75,42 @@ class AbstractExecutor {
   ExecutorContext *GetExecutorContext() { return exec_ctx_; }
 
  protected:
+  /**
+   * Yield the next tuple of the batches produced by NextBatch(), for executors that implement Next() on top of it.
+   * @param[out] tuple The next tuple produced by this executor
+   * @param[out] rid The next tuple RID produced by this executor
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextFromBatch(Tuple *tuple, RID *rid) {
+    if (row_batch_ == nullptr) {
+      row_batch_ = std::make_unique<TupleBatch>(GetOutputSchema());
+    }
+    if (row_batch_pos_ >= row_batch_->Size()) {
+      if (!NextBatch(row_batch_.get())) {
+        return false;
+      }
+      row_batch_pos_ = 0;
+    }
+    *tuple = row_batch_->GetTuple(row_batch_pos_);
+    *rid = row_batch_->GetRid(row_batch_pos_);
+    row_batch_pos_++;
+    return true;
+  }
+
+  /** Drop the tuples NextFromBatch() has buffered; called when the executor is initialized again. */
+  void ResetNextFromBatch() {
+    if (row_batch_ != nullptr) {
+      row_batch_->Clear();
+    }
+    row_batch_pos_ = 0;
+  }
+
   /** The executor context in which the executor runs */
   ExecutorContext *exec_ctx_;
+
+ private:
+  /** The batch NextFromBatch() hands out tuples from */
+  std::unique_ptr<TupleBatch> row_batch_;
+  size_t row_batch_pos_{0};
 };
 }  // namespace bustub
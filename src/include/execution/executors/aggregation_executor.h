@@ -19,9 +19,11 @@
 
 #include "common/util/hash_util.h"
 #include "container/hash/hash_function.h"
+#include "execution/aggregation_hash_table.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/hybrid_hash_aggregation.h"
 #include "execution/plans/aggregation_plan.h"
 #include "storage/table/tuple.h"
 #include "type/value_factory.h"
@@ -29,7 +31,8 @@
 namespace bustub {
 
 /**
- * A simplified hash table that has all the necessary functionality for aggregations.
+ * A simplified hash table that has all the necessary functionality for aggregations. AggregationExecutor uses the
+ * faster AggregationHashTable instead.
  */
 class SimpleAggregationHashTable {
  public:
@@ -154,7 +157,19 @@ class SimpleAggregationHashTable {
 
 /**
  * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX)
- * over the tuples produced by a child executor.
+ * over the tuples produced by a child executor, grouping them in an AggregationHashTable.
+ *
+ * On one thread, the groups are held within the memory budget of the query by a HybridHashAggregation, which spills
+ * the rows of the groups that do not fit to temporary pages and aggregates them once the groups in memory are output.
+ *
+ * Run in parallel, either as the copies of a plan fragment or on its own when the context allows more than one
+ * thread, the aggregation has two phases. Every copy first aggregates the rows of its part of the input into a table
+ * of its own, without any latching. The groups of all those tables are then split by the hash of their keys into
+ * partitions, and the copies take turns merging a whole partition into its final table, so that no two threads ever
+ * update the same table. The tables of the copies reserve their memory from the budget of the query. Once one of
+ * them does not fit, no copy adds groups to its table anymore: the rows of new keys are spilled to temporary pages by
+ * partition, and each partition adds them once its groups are merged, in a HybridHashAggregation that spills again
+ * what does not fit.
  */
 class AggregationExecutor : public AbstractExecutor {
  public:
@@ -178,41 +193,42 @@ class AggregationExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /**
+   * Yield the next batch of aggregation results.
+   * @param[out] batch The next batch produced by the aggregation
+   * @return `true` if at least one tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return The output schema for the aggregation */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
   /** Do not use or remove this function, otherwise you will get zero points. */
   const AbstractExecutor *GetChildExecutor() const;
 
- private:
-  /** @return The tuple as an AggregateKey */
-  AggregateKey MakeAggregateKey(const Tuple *tuple) {
-    std::vector<Value> keys;
-    for (const auto &expr : plan_->GetGroupBys()) {
-      keys.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
-    }
-    return {keys};
-  }
+  /** @return The number of partitions spilled to disk so far */
+  size_t NumSpilledPartitions() const;
 
-  /** @return The tuple as an AggregateValue */
-  AggregateValue MakeAggregateValue(const Tuple *tuple) {
-    std::vector<Value> vals;
-    for (const auto &expr : plan_->GetAggregates()) {
-      vals.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
-    }
-    return {vals};
-  }
+  /** @return The bytes of rows spilled to disk so far */
+  size_t GetSpilledBytes() const;
 
  private:
+  /** The partial and merged tables shared by the copies of a parallel aggregation */
+  class SharedState;
+
+  /** Aggregate the child plan on several threads of its own, each running a copy of it. */
+  void InitParallel(size_t num_workers);
+
   /** The aggregation plan node */
   const AggregationPlanNode *plan_;
   /** The child executor that produces tuples over which the aggregation is computed */
   std::unique_ptr<AbstractExecutor> child_;
-  /** Simple aggregation hash table */
-  // TODO(Student): Uncomment SimpleAggregationHashTable aht_;
-  SimpleAggregationHashTable aht_;
-  /** Simple aggregation hash table iterator */
-  // TODO(Student): Uncomment SimpleAggregationHashTable::Iterator aht_iterator_;
-  SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** The groups and their aggregates, when the aggregation runs on one thread */
+  HybridHashAggregation aggregation_;
+  std::shared_ptr<SharedState> state_;
+  /** The aggregations whose groups this executor outputs, with those of their spilled partitions, and the next group */
+  std::vector<HybridHashAggregation *> aggregations_;
+  size_t next_aggregation_{0};
+  size_t next_group_{0};
 };
 }  // namespace bustub
@@ -13,80 +13,24 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include "common/util/hash_util.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/hybrid_hash_aggregation.h"
 #include "execution/plans/distinct_plan.h"
 
-struct DistinctKey {
-  std::vector<bustub::Value> distinct_key_;
-
-  bool operator==(const DistinctKey &other) const {
-    for (uint32_t i = 0; i < other.distinct_key_.size(); i++) {
-      if (distinct_key_[i].CompareEquals(other.distinct_key_[i]) != bustub::CmpBool::CmpTrue) {
-        return false;
-      }
-    }
-    return true;
-  }
-};
-namespace std {
-
-/** Implements std::hash on AggregateKey */
-template <>
-struct hash<DistinctKey> {
-  std::size_t operator()(const DistinctKey &distinctKey) const {
-    size_t curr_hash = 0;
-    for (const auto &key : distinctKey.distinct_key_) {
-      if (!key.IsNull()) {
-        curr_hash = bustub::HashUtil::CombineHashes(curr_hash, bustub::HashUtil::HashValue(&key));
-      }
-    }
-    return curr_hash;
-  }
-};
-
-}  // namespace std
 namespace bustub {
-class DistinctHashTable {
- public:
-  void Insert(const DistinctKey &key) {
-    if (ht_.count(key) == 0) {
-      ht_[key] = true;
-    }
-  }
-  class Iterator {
-   public:
-    explicit Iterator(std::unordered_map<DistinctKey, bool>::const_iterator iter) : iter_{iter} {}
-
-    const DistinctKey &Key() { return iter_->first; }
-
-    Iterator &operator++() {
-      ++iter_;
-      return *this;
-    }
-
-    bool operator==(const Iterator &other) { return this->iter_ == other.iter_; }
-
-    bool operator!=(const Iterator &other) { return this->iter_ != other.iter_; }
-
-   private:
-    /** Aggregates map */
-    std::unordered_map<DistinctKey, bool>::const_iterator iter_;
-  };
 
-  Iterator Begin() { return Iterator{ht_.cbegin()}; }
-
-  Iterator End() { return Iterator{ht_.cend()}; }
-
- private:
-  std::unordered_map<DistinctKey, bool> ht_;
-};
 /**
  * DistinctExecutor removes duplicate rows from child ouput.
+ *
+ * The rows are grouped by all of their columns, without aggregates, in a HybridHashAggregation, which keeps each key
+ * packed into a few fixed-width words within the memory budget of the query. The distinct is pipelined: a row is
+ * output as soon as it is the first of its key, so that a parent that stops pulling, such as a satisfied limit, stops
+ * the distinct from reading the rest of its child. Rows of keys that did not fit into memory are spilled to temporary
+ * pages and output once the child is done.
  */
 class DistinctExecutor : public AbstractExecutor {
  public:
@@ -110,23 +54,40 @@ class DistinctExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /**
+   * Yield the next batch of distinct tuples.
+   * @param[out] batch The next batch produced by the distinct
+   * @return `true` if at least one tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return The output schema for the distinct */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
+  /** @return The number of partitions spilled to disk so far */
+  size_t NumSpilledPartitions() const { return distinct_.NumSpilledPartitions(); }
+
+  /** @return The bytes of rows spilled to disk so far */
+  size_t GetSpilledBytes() const { return distinct_.GetSpilledBytes(); }
+
  private:
-  DistinctKey MakeDistinctKey(const Tuple *tuple) {
-    std::vector<Value> keys;
-    for (size_t i = 0; i < child_executor_->GetOutputSchema()->GetColumnCount(); i++) {
-      keys.push_back(tuple->GetValue(child_executor_->GetOutputSchema(), i));
-    }
-    return {keys};
-  }
+  /** @return an expression for each column of the child's output, to group by */
+  static std::vector<std::unique_ptr<ColumnValueExpression>> MakeColumns(const Schema *schema);
+
   /** The distinct plan node to be executed */
   const DistinctPlanNode *plan_;
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
-  DistinctHashTable dht_;
-  DistinctHashTable::Iterator iterator_;
+  std::vector<std::unique_ptr<ColumnValueExpression>> columns_;
+  /** The keys seen, as the groups of an aggregation without aggregates */
+  HybridHashAggregation distinct_;
+  /** The batch of the child being looked at, and the rows of it that are the first of their key */
+  std::unique_ptr<TupleBatch> child_batch_;
+  std::vector<size_t> first_rows_;
+  /** Whether the child is done, after which the groups of the spilled partitions are output */
+  bool child_done_{false};
+  /** The next group of the spilled partition in memory to output */
+  size_t next_group_{0};
 };
 
 }  // namespace bustub
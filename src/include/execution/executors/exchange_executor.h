@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_executor.h
+//
+// Identification: src/include/execution/executors/exchange_executor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+
+#include "execution/batch_channel.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/exchange_plan.h"
+
+namespace bustub {
+
+/**
+ * ExchangeExecutor hands out one partition of the output of its child plan.
+ *
+ * The copies of an exchange in a plan fragment share one set of producers: the copy that is initialized first starts
+ * them on the thread pool, each running the child plan on its part of the input and sending every tuple through a
+ * BatchChannel to the copy that owns its partition.
+ */
+class ExchangeExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new ExchangeExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The exchange plan to be executed
+   */
+  ExchangeExecutor(ExecutorContext *exec_ctx, const ExchangePlanNode *plan);
+
+  /** Stops taking tuples from the producers. */
+  ~ExchangeExecutor() override;
+
+  /** Initialize the exchange, starting the producers if no other copy has */
+  void Init() override;
+
+  /**
+   * Yield the next tuple of this copy's partition.
+   * @param[out] tuple The next tuple produced by the exchange
+   * @param[out] rid The next tuple RID produced by the exchange
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Yield the next batch of this copy's partition.
+   * @param[out] batch The next batch produced by the exchange
+   * @return `true` if at least one tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return The output schema for the exchange */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+ private:
+  /** The producers and partitions shared by the copies of the exchange */
+  class SharedState;
+
+  /** The exchange plan node to be executed */
+  const ExchangePlanNode *plan_;
+  std::shared_ptr<SharedState> state_;
+  /** The channel of this copy's partition */
+  BatchChannel *channel_{nullptr};
+};
+}  // namespace bustub
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.h
+//
+// Identification: src/include/execution/executors/gather_executor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "execution/batch_channel.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/gather_plan.h"
+
+namespace bustub {
+
+/**
+ * GatherExecutor runs copies of its child plan fragment on the thread pool of the executor context and hands out
+ * their batches as they arrive.
+ */
+class GatherExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new GatherExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The gather plan to be executed
+   */
+  GatherExecutor(ExecutorContext *exec_ctx, const GatherPlanNode *plan);
+
+  /** Stops the copies of the fragment. */
+  ~GatherExecutor() override;
+
+  /** Initialize the gather, starting the copies of the fragment */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the gather.
+   * @param[out] tuple The next tuple produced by the fragment
+   * @param[out] rid The next tuple RID produced by the fragment
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Yield the next batch produced by any copy of the fragment.
+   * @param[out] batch The next batch produced by the gather
+   * @return `true` if at least one tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return The output schema for the gather */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+ private:
+  /** Body of the task that runs a copy of the fragment. */
+  void RunFragment(size_t worker_idx);
+
+  /** Stop the copies of the fragment, if running, and wait for them; idempotent. */
+  void StopFragments();
+
+  /** The gather plan node to be executed */
+  const GatherPlanNode *plan_;
+  /** The contexts of the copies of the fragment, which share one OperatorStateRegistry */
+  std::vector<std::unique_ptr<ExecutorContext>> fragment_ctxs_;
+  /** The copies of the fragment; a copy is released by its task as soon as it is done */
+  std::vector<std::unique_ptr<AbstractExecutor>> fragments_;
+  /** Carries the batches of all copies to NextBatch() */
+  std::unique_ptr<BatchChannel> channel_;
+};
+}  // namespace bustub
@@ -13,20 +13,36 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/join_hash_table.h"
 #include "execution/plans/hash_join_plan.h"
+#include "execution/runtime_filter.h"
+#include "storage/table/tmp_tuple_file.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ * HashJoinExecutor executes an equi-JOIN on two tables by building a JoinHashTable over the right child and
+ * probing it with the tuples of the left child. Keys may have several columns of any type; NULL keys join nothing.
+ *
+ * The build side is held within the memory budget of the query. If it outgrows the budget, the join turns into a
+ * hybrid hash join: the build rows are split into partitions by the hash of their key, and the largest partitions are
+ * spilled to temporary pages until the rest fits. Probe rows of a spilled partition are spilled alongside it instead
+ * of probing. Once the left child is done, each spilled partition is joined the same way, partitioned by other bits
+ * of the hash if it is still too large. A partition that repartitioning does not split, such as one of a single key,
+ * is joined a budget-sized chunk of its build side at a time, reading its probe side once per chunk.
+ *
+ * If the left child is a sequential scan and the left keys are columns of it, the join pushes a RuntimeFilter down to
+ * the scan: a Bloom filter over the keys of the build side, which drops most rows that cannot join before the scan
+ * materializes them. The size of the build side is not known up front, so the filter is sized for as many keys as a
+ * share of the budget allows, filled as the build side is read, and shrunk to fit once it is done. Its memory counts
+ * against the budget too; if the budget has no room for it, the join goes without.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -40,6 +56,8 @@ class HashJoinExecutor : public AbstractExecutor {
   HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                    std::unique_ptr<AbstractExecutor> &&left_child, std::unique_ptr<AbstractExecutor> &&right_child);
 
+  ~HashJoinExecutor() override;
+
   /** Initialize the join */
   void Init() override;
 
@@ -51,20 +69,128 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /**
+   * Yield the next batch of joined tuples, probing the hash table with batches of the left child.
+   * @param[out] batch The next batch produced by the join
+   * @return `true` if at least one tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return The output schema for the join */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
-  Tuple CombineTuple(Tuple *left, Tuple *right);
+  /** @return The filter pushed down to the left child, or nullptr if the join could not push one down */
+  const RuntimeFilter *GetRuntimeFilter() const { return runtime_filter_.get(); }
+
+  /** @return The number of partitions spilled to disk so far, counting those spilled again while being joined */
+  size_t NumSpilledPartitions() const { return num_spilled_partitions_; }
 
  private:
+  /** Partitions split the hash of a key PARTITION_BITS at a time, from the top bits down */
+  static constexpr size_t PARTITION_BITS = 3;
+  static constexpr size_t NUM_PARTITIONS = 1 << PARTITION_BITS;
+  static constexpr size_t MAX_PARTITION_LEVELS = 4;
+  /** The Bloom filter pushed down to the left child takes at most 1/FILTER_BUDGET_SHARE of the budget left */
+  static constexpr size_t FILTER_BUDGET_SHARE = 8;
+  static constexpr size_t MAX_FILTER_BYTES = 1 << 20;
+
+  /** A partition of the build side being built: its rows in memory, or its rows and probe rows spilled to files */
+  struct Partition {
+    std::vector<std::unique_ptr<TupleBatch>> batches_;
+    size_t memory_{0};
+    std::unique_ptr<TmpTupleFile> build_file_;
+    std::unique_ptr<TmpTupleFile> probe_file_;
+  };
+
+  /** A spilled partition yet to be joined */
+  struct SpilledPartition {
+    std::unique_ptr<TmpTupleFile> build_file_;
+    std::unique_ptr<TmpTupleFile> probe_file_;
+    /** The level at which its rows get partitioned */
+    size_t level_;
+    /** Whether partitioning its rows again would keep them together, so that it is joined a chunk at a time */
+    bool skewed_;
+  };
+
+  /** @return The partition of a key hash at the given level */
+  static size_t PartitionOf(hash_t hash, size_t level) {
+    return (hash >> (8 * sizeof(hash_t) - PARTITION_BITS * (level + 1))) & (NUM_PARTITIONS - 1);
+  }
+
+  /**
+   * Build the hash table from the build side: the right child, or the spilled partition being joined. In a chunk of
+   * a skewed partition, stops once the budget is used up.
+   */
+  void Build();
+
+  /** Add the rows of a build batch to the hash table and keep the batch; adds the key hashes to filter if given. */
+  void InsertBatch(std::unique_ptr<TupleBatch> &&batch, BloomFilter *filter = nullptr);
+
+  /** @return false if no filter can be pushed down to the left child; else the left keys over the scanned table */
+  bool PushdownKeys(std::vector<const AbstractExpression *> *scan_keys) const;
+
+  /** Reserve memory for a Bloom filter over the build keys, and create build_filter_ if the budget has room. */
+  void ReserveBuildFilter();
+
+  /** Split the rows built so far into partitions and spill until the rest fits into the budget. */
+  void StartPartitioning();
+
+  /** Add a build row to its partition, or to its partition's file if that is spilled. */
+  void AddToPartition(const TupleBatch &batch, size_t row, const std::vector<char> &key, hash_t hash);
+
+  /** Reserve memory for the resident build rows, spilling partitions while the budget does not allow it. */
+  void FitPartitionsInBudget();
+
+  /** Release the memory reserved for the build side. */
+  void ReleaseMemory();
+
+  /** Move on once the probe side is done: to the next chunk of a skewed partition, or to the next spilled partition. */
+  bool NextPhase();
+
+  /** Read the next batch of the build or probe side */
+  bool NextBuildBatch(TupleBatch *batch);
+  bool NextProbeBatch(TupleBatch *batch);
+
+  /** Serialize and hash the join keys of left_batch_, and prefetch their buckets; rows of spilled partitions spill. */
+  void PrepareProbe();
+
   /** The NestedLoopJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> left_child_;
   std::unique_ptr<AbstractExecutor> right_child_;
-  std::unordered_map<int32_t, std::vector<Tuple>> right_ht_;
-  Tuple left_tuple_;
-  RID left_rid_;
-  uint32_t idx_;
+  /** The tuples of the build side in memory */
+  std::vector<std::unique_ptr<TupleBatch>> right_batches_;
+  /** Maps the join keys of the right child to its rows in right_batches_ */
+  JoinHashTable right_ht_;
+  /** The serialized join keys of left_batch_ back to back; the key of row i spans left_key_offsets_[i, i + 1) */
+  std::vector<char> left_keys_;
+  std::vector<size_t> left_key_offsets_;
+  /** The hashes of the join keys of left_batch_; a row whose key has a NULL gets an empty key, which never matches */
+  std::vector<hash_t> left_hashes_;
+  /** The batch of the left child being probed, and the row of it being joined */
+  std::unique_ptr<TupleBatch> left_batch_;
+  size_t left_row_;
+  bool left_done_;
+  /** Whether the current left row has been looked up, and the next matching build row to emit */
+  bool probed_;
+  const JoinHashTable::RowEntry *match_;
+  /** The partitions of the build side; empty while it fits into memory as a whole */
+  std::vector<Partition> partitions_;
+  /** The bytes the build side in memory takes, and how many of them are reserved from the budget */
+  size_t memory_;
+  size_t reserved_{0};
+  /** The spilled partition being joined, nullptr while joining the children, and the ones still to join */
+  std::unique_ptr<SpilledPartition> current_;
+  std::vector<SpilledPartition> pending_;
+  /** The level at which build rows are partitioned, whether a skewed partition is joined, and if its build is read */
+  size_t level_;
+  bool chunked_;
+  bool build_done_;
+  size_t num_spilled_partitions_{0};
+  /** The filter for the left child while it is built, nullptr otherwise, the filter, and the bytes reserved for it */
+  std::unique_ptr<BloomFilter> build_filter_;
+  std::shared_ptr<RuntimeFilter> runtime_filter_;
+  size_t filter_reserved_{0};
 };
 
 }  // namespace bustub
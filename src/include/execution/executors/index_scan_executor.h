@@ -12,18 +12,26 @@
 
 #pragma once
 
+#include <functional>
+#include <optional>
 #include <vector>
 
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/index_scan_plan.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * IndexScanExecutor executes an index scan over a table.
+ * IndexScanExecutor executes an index scan over a table through one of its B+ tree indexes.
+ *
+ * When the predicate compares the first key column against a constant, only the matching key range is scanned, so a
+ * range query costs O(log n + k) page accesses. Otherwise the scan walks the whole index, returning tuples in key
+ * order.
+ * Either way, every tuple is still checked against the full predicate.
  */
 
 class IndexScanExecutor : public AbstractExecutor {
@@ -42,7 +50,27 @@ class IndexScanExecutor : public AbstractExecutor {
   bool Next(Tuple *tuple, RID *rid) override;
 
  private:
+  /** Derive the key range to scan from the predicate. */
+  void ComputeBounds();
+
+  /** Position a new iterator over the B+ tree with GenericKey<KeySize> keys at the lower bound. */
+  template <size_t KeySize>
+  void OpenScan();
+
+  void LockShared(const RID &rid);
+  void UnLock(const RID &rid);
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+  const IndexInfo *index_info_;
+  const TableInfo *table_info_;
+  /** The first key column value to start at, if the predicate bounds the scan from below. */
+  std::optional<Value> lower_bound_;
+  /** The first key column value to stop at, if the predicate bounds the scan from above. */
+  std::optional<Value> upper_bound_;
+  /** Whether a key equal to upper_bound_ is still in range. */
+  bool upper_inclusive_{false};
+  /** Produces the RIDs of the key range in order; returns false at the end of the range. */
+  std::function<bool(RID *)> next_rid_;
 };
 }  // namespace bustub
@@ -12,17 +12,30 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
+#include "execution/batch_channel.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/morsel_dispenser.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/runtime_filter.h"
+#include "execution/selection_bitmap.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
+ *
+ * When the executor context allows more than one thread, the scan runs morsel-driven: tasks on the context's thread
+ * pool take runs of pages from the table's page directory, filter and project them, and pass the resulting batches
+ * through a BatchChannel. In a plan fragment that runs as several copies, the copies take morsels from one shared
+ * dispenser instead, each on its own thread. Either way tuples come out in no particular order.
+ *
+ * A RuntimeFilter pushed down to the scan through the executor context, such as the Bloom filter of a hash join
+ * above it, is applied after the predicate and before the rows are projected.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -33,6 +46,9 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan);
 
+  /** Stops the tasks of a parallel scan. */
+  ~SeqScanExecutor() override;
+
   /** Initialize the sequential scan */
   void Init() override;
 
@@ -44,6 +60,13 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /**
+   * Yield the next batch of tuples that satisfy the predicate, projected to the output schema.
+   * @param[out] batch The next batch produced by the scan
+   * @return `true` if at least one tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return The output schema for the sequential scan */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
@@ -52,6 +75,53 @@ class SeqScanExecutor : public AbstractExecutor {
   const SeqScanPlanNode *plan_;
   TableIterator table_iterator_ = TableIterator(nullptr, RID(INVALID_PAGE_ID, 0), nullptr);
   const TableInfo *table_info_;
+  /** The tuples read from the table for the batch being produced, before filtering and projection */
+  std::unique_ptr<TupleBatch> scan_batch_;
+  /** The tuples of scan_batch_ that satisfy the predicate */
+  SelectionBitmap selection_;
+  /** The filter pushed down to the scan, or nullptr */
+  std::shared_ptr<RuntimeFilter> runtime_filter_;
+
+  /** Where a morsel-driven scan is in its current morsel. */
+  struct MorselCursor {
+    /** The tuples of the page being scanned, and those that satisfy the predicate */
+    std::unique_ptr<TupleBatch> page_batch_;
+    SelectionBitmap selection_;
+    /** The selected tuples of the page projected to the output schema, and the next one to hand out */
+    std::unique_ptr<TupleBatch> page_output_;
+    size_t next_row_{0};
+    /** The next page of the morsel, and one past its last page */
+    size_t next_page_{0};
+    size_t morsel_end_{0};
+  };
+
+  /** Select the tuples of a batch that satisfy the predicate and pass the runtime filter, if any. */
+  void Filter(const TupleBatch &batch, SelectionBitmap *selection);
+
+  /** Append the tuples of scan_batch that are selected, projected to the output schema, to out. */
+  void ProjectSelected(const TupleBatch &scan_batch, const SelectionBitmap &selection, TupleBatch *out);
+
+  /** Lock and, depending on the isolation level, unlock again every row of a batch. */
+  void LockRows(const TupleBatch &batch);
+
+  /** Read every tuple of a table page into batch, and lock them. */
+  void ScanPage(page_id_t page_id, TupleBatch *batch);
+
+  /** Fill batch with the next tuples of the morsels taken from dispenser_. */
+  bool NextMorselBatch(MorselCursor *cursor, TupleBatch *batch);
+
+  /** Body of a task of a parallel scan. */
+  void ScanMorsels();
+
+  /** Stop the tasks, if any, and drop what they produced; idempotent. */
+  void StopWorkers();
+
+  /** Hands out the pages of a parallel scan; nullptr if the scan is sequential */
+  std::shared_ptr<MorselDispenser> dispenser_;
+  /** The morsel this copy of a plan fragment is scanning */
+  MorselCursor cursor_;
+  /** Carries the batches of the tasks of a parallel scan to NextBatch(); nullptr unless the scan started tasks */
+  std::unique_ptr<BatchChannel> channel_;
 
   void LockShared(const RID &rid);
   void UnLock(const RID &rid);
@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.h
+//
+// Identification: src/include/execution/executors/sort_executor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/table/tmp_tuple_file.h"
+
+namespace bustub {
+
+/**
+ * SortExecutor orders the output of its child by the keys of a sort plan. Ties keep the order of the child.
+ *
+ * The key of each row is normalized into a byte string that compares with memcmp in the order of the sort, so that
+ * rows are ordered without looking at a Value. The child's batches are kept, with the keys, within the memory budget
+ * of the query, and sorted in memory if they all fit. Otherwise each time the rows held outgrow the budget they are
+ * sorted and written to temporary pages as a run, and the runs are then merged, as many at a time as the budget has
+ * room for a page of each, until one merge outputs the rows in order.
+ */
+class SortExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new SortExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The sort plan to be executed
+   * @param child_executor The child executor from which tuples are pulled
+   */
+  SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  /** Releases the memory reserved for the rows held. */
+  ~SortExecutor() override;
+
+  /** Initialize the sort, sorting the output of the child. */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the sort.
+   * @param[out] tuple The next tuple produced by the sort
+   * @param[out] rid The next tuple RID produced by the sort
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Yield the next batch of sorted tuples.
+   * @param[out] batch The next batch produced by the sort
+   * @return `true` if at least one tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return The output schema for the sort */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+  /** @return The number of sorted runs written to disk, counting those written by intermediate merges */
+  size_t NumRuns() const { return num_runs_; }
+
+  /** @return The number of merges of all runs into fewer, longer ones before the final merge */
+  size_t NumMergePasses() const { return num_merge_passes_; }
+
+  /** @return The bytes of rows written to disk */
+  size_t GetSpilledBytes() const { return spilled_bytes_; }
+
+ private:
+  /** The most runs merged at once, however large the budget */
+  static constexpr size_t MAX_MERGE_FAN_IN = 128;
+
+  /** A row held in memory and its normalized key */
+  struct SortEntry {
+    /** The first bytes of the key, big-endian, so that most comparisons are of one integer */
+    uint64_t prefix_;
+    uint32_t key_offset_;
+    uint32_t key_length_;
+    uint32_t batch_;
+    uint32_t row_;
+  };
+
+  /** A run being merged, and its next row */
+  struct MergeInput {
+    std::unique_ptr<TmpTupleFile> file_;
+    Tuple tuple_;
+    std::string key_;
+  };
+
+  /**
+   * Append the normalized key of a value to a key.
+   * @param value the value of a sort key
+   * @param descending whether the key orders the rows in descending order
+   * @param[out] key the key to append to
+   */
+  static void NormalizeValue(const Value &value, bool descending, std::string *key);
+
+  /** @return less than, equal to, or greater than zero as the first key orders before, with, or after the second */
+  static int CompareKeys(const char *left, size_t left_length, const char *right, size_t right_length);
+
+  /** Append the normalized key of a row of a batch to keys_, and an entry for it to entries_. */
+  void AddRow(const TupleBatch &batch, uint32_t batch_idx, size_t row);
+
+  /** Normalize the key of a tuple of the child's output. */
+  void MakeKey(const Tuple &tuple, std::string *key) const;
+
+  /** Sort the entries of the rows held. */
+  void SortEntries();
+
+  /** Write the rows held to a new run, in order, and drop them. */
+  void SpillRun();
+
+  /** Merge the runs, as many at a time as the budget allows, until they are few enough to merge at once. */
+  void MergeRuns();
+
+  /** Start merging the given runs. */
+  void StartMerge(std::vector<std::unique_ptr<TmpTupleFile>> &&runs);
+
+  /** Read the next row of a run being merged; @return false if the run is done */
+  bool AdvanceInput(size_t input);
+
+  /** @return whether the next row of the first run being merged comes after that of the second */
+  bool MergesAfter(size_t left, size_t right) const;
+
+  /**
+   * Take the least row of the runs being merged.
+   * @param[out] tuple the row
+   * @return false if the runs are done
+   */
+  bool NextMerged(Tuple *tuple);
+
+  /** @return the number of runs to merge at once, reserving a page of memory for each */
+  size_t ReserveMergeFanIn();
+
+  /** Release the memory reserved for the rows held or for merging, and drop the rows held. */
+  void ReleaseMemory();
+
+  /** The sort plan node to be executed */
+  const SortPlanNode *plan_;
+  /** The child executor from which tuples are obtained */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The rows held in memory, their normalized keys back to back, and an entry per row in the order of the sort */
+  std::vector<std::unique_ptr<TupleBatch>> batches_;
+  std::string keys_;
+  std::vector<SortEntry> entries_;
+  /** The bytes the rows held take, and the bytes reserved from the budget for them or for the pages of a merge */
+  size_t memory_{0};
+  size_t reserved_{0};
+  /** The next entry to output, when sorting in memory */
+  size_t next_entry_{0};
+  /** The sorted runs on disk, in the order they were written */
+  std::vector<std::unique_ptr<TmpTupleFile>> runs_;
+  /** The runs being merged, and a min-heap of the indexes of those with rows left */
+  std::vector<MergeInput> merge_inputs_;
+  std::vector<size_t> merge_heap_;
+  /** Whether the rows are output from a merge of runs rather than from memory */
+  bool merging_{false};
+  /** Scratch space for normalizing the key of a row */
+  std::string key_;
+  size_t num_runs_{0};
+  size_t num_merge_passes_{0};
+  size_t spilled_bytes_{0};
+};
+
+}  // namespace bustub
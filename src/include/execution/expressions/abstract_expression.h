@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -50,6 +51,25 @@ class AbstractExpression {
   virtual Value EvaluateJoin(const Tuple *left_tuple, const Schema *left_schema, const Tuple *right_tuple,
                              const Schema *right_schema) const = 0;
 
+  /**
+   * Returns the value obtained by evaluating one row of a batch.
+   * @param batch The batch, whose schema the expression refers to
+   * @param row The row of the batch
+   * @return The value obtained by evaluating the row
+   */
+  virtual Value EvaluateRow(const TupleBatch *batch, size_t row) const = 0;
+
+  /**
+   * Returns the value obtained by evaluating a JOIN of two batch rows.
+   * @param left_batch The batch of the left side
+   * @param left_row The row of the left batch
+   * @param right_batch The batch of the right side
+   * @param right_row The row of the right batch
+   * @return The value obtained by evaluating a JOIN on the left and right rows
+   */
+  virtual Value EvaluateJoinRow(const TupleBatch *left_batch, size_t left_row, const TupleBatch *right_batch,
+                                size_t right_row) const = 0;
+
   /**
    * Returns the value obtained by evaluating the aggregates.
    * @param group_bys The group by values
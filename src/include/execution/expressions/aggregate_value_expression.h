@@ -44,6 +44,17 @@ class AggregateValueExpression : public AbstractExpression {
     UNREACHABLE("Aggregation should only refer to group-by and aggregates.");
   }
 
+  /** Invalid operation for `AggregateValueExpression` */
+  Value EvaluateRow(const TupleBatch *batch, size_t row) const override {
+    UNREACHABLE("Aggregation should only refer to group-by and aggregates.");
+  }
+
+  /** Invalid operation for `AggregateValueExpression` */
+  Value EvaluateJoinRow(const TupleBatch *left_batch, size_t left_row, const TupleBatch *right_batch,
+                        size_t right_row) const override {
+    UNREACHABLE("Aggregation should only refer to group-by and aggregates.");
+  }
+
   /**
    * Returns the value obtained by evaluating the aggregates.
    * @param group_bys The group by values
@@ -41,6 +41,13 @@ class ColumnValueExpression : public AbstractExpression {
                            : right_tuple->GetValue(right_schema, col_idx_);
   }
 
+  Value EvaluateRow(const TupleBatch *batch, size_t row) const override { return batch->GetValue(row, col_idx_); }
+
+  Value EvaluateJoinRow(const TupleBatch *left_batch, size_t left_row, const TupleBatch *right_batch,
+                        size_t right_row) const override {
+    return tuple_idx_ == 0 ? left_batch->GetValue(left_row, col_idx_) : right_batch->GetValue(right_row, col_idx_);
+  }
+
   Value EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const override {
     BUSTUB_ASSERT(false, "Aggregation should only refer to group-by and aggregates.");
   }
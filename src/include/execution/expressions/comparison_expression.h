@@ -34,6 +34,9 @@ class ComparisonExpression : public AbstractExpression {
   ComparisonExpression(const AbstractExpression *left, const AbstractExpression *right, ComparisonType comp_type)
       : AbstractExpression({left, right}, TypeId::BOOLEAN), comp_type_{comp_type} {}
 
+  /** @return the comparison this expression performs */
+  ComparisonType GetComparisonType() const { return comp_type_; }
+
   Value Evaluate(const Tuple *tuple, const Schema *schema) const override {
     Value lhs = GetChildAt(0)->Evaluate(tuple, schema);
     // int left = lhs.GetAs<int32_t>();
@@ -53,6 +56,19 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  Value EvaluateRow(const TupleBatch *batch, size_t row) const override {
+    Value lhs = GetChildAt(0)->EvaluateRow(batch, row);
+    Value rhs = GetChildAt(1)->EvaluateRow(batch, row);
+    return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
+  }
+
+  Value EvaluateJoinRow(const TupleBatch *left_batch, size_t left_row, const TupleBatch *right_batch,
+                        size_t right_row) const override {
+    Value lhs = GetChildAt(0)->EvaluateJoinRow(left_batch, left_row, right_batch, right_row);
+    Value rhs = GetChildAt(1)->EvaluateJoinRow(left_batch, left_row, right_batch, right_row);
+    return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
+  }
+
   Value EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const override {
     Value lhs = GetChildAt(0)->EvaluateAggregate(group_bys, aggregates);
     Value rhs = GetChildAt(1)->EvaluateAggregate(group_bys, aggregates);
@@ -25,6 +25,9 @@ class ConstantValueExpression : public AbstractExpression {
   /** Creates a new constant value expression wrapping the given value. */
   explicit ConstantValueExpression(const Value &val) : AbstractExpression({}, val.GetTypeId()), val_(val) {}
 
+  /** @return the constant */
+  const Value &GetValue() const { return val_; }
+
   Value Evaluate(const Tuple *tuple, const Schema *schema) const override { return val_; }
 
   Value EvaluateJoin(const Tuple *left_tuple, const Schema *left_schema, const Tuple *right_tuple,
@@ -32,6 +35,13 @@ class ConstantValueExpression : public AbstractExpression {
     return val_;
   }
 
+  Value EvaluateRow(const TupleBatch *batch, size_t row) const override { return val_; }
+
+  Value EvaluateJoinRow(const TupleBatch *left_batch, size_t left_row, const TupleBatch *right_batch,
+                        size_t right_row) const override {
+    return val_;
+  }
+
   Value EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const override {
     return val_;
   }
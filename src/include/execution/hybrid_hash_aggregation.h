@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hybrid_hash_aggregation.h
+//
+// Identification: src/include/execution/hybrid_hash_aggregation.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "execution/aggregation_hash_table.h"
+#include "execution/executor_context.h"
+#include "storage/table/tmp_tuple_file.h"
+
+namespace bustub {
+
+/**
+ * HybridHashAggregation groups rows in an AggregationHashTable held within the memory budget of the query.
+ *
+ * Once the table outgrows the budget, rows keep updating the groups already in the table, but the rows of new keys
+ * are split into partitions by the hash of their key and spilled to temporary pages. Every key thus has all of its
+ * rows either in the table or in one partition. When the input is done and the groups in the table have been read,
+ * each spilled partition is aggregated in turn the same way, partitioned by other bits of the hash where it still
+ * does not fit.
+ */
+class HybridHashAggregation {
+ public:
+  /**
+   * Create an empty aggregation.
+   * @param exec_ctx the context of the executor, for its memory budget and buffer pool; the aggregation may outlive it
+   * @param group_bys the group-by expressions, over the rows that will be inserted
+   * @param aggregates the expressions to aggregate
+   * @param agg_types the aggregation of each aggregate expression
+   * @param hash_bits the top bits of the hash that all keys share, e.g. as the keys of one partition of a parallel
+   * aggregation; partitions split the bits below them
+   */
+  HybridHashAggregation(ExecutorContext *exec_ctx, const std::vector<const AbstractExpression *> &group_bys,
+                        const std::vector<const AbstractExpression *> &aggregates,
+                        const std::vector<AggregationType> &agg_types, size_t hash_bits = 0);
+
+  /** Releases the memory reserved for the table. */
+  ~HybridHashAggregation();
+
+  DISALLOW_COPY_AND_MOVE(HybridHashAggregation);
+
+  /**
+   * Add the rows of a batch of the input, spilling the rows of new keys once the table does not fit.
+   * @param batch the rows to add
+   * @param[out] created if given, gets the rows that created a group in memory; rows that were spilled are left out
+   */
+  void InsertBatch(const TupleBatch &batch, std::vector<size_t> *created = nullptr);
+
+  /**
+   * Merge groups of another table, with the same aggregates, into the groups in memory; nothing may have been spilled.
+   * The groups are partial aggregates, which cannot be spilled as rows, so they take their memory even beyond the
+   * budget.
+   * @param other the table that holds the groups
+   * @param groups the indexes of the groups in the other table
+   */
+  void MergeGroups(const AggregationHashTable &other, const std::vector<size_t> &groups);
+
+  /** End the input, unpinning the pages being spilled to; NextPartition() ends it as well. */
+  void FinishInput() { FinishSpilling(); }
+
+  /** @return the groups in memory: those of the input, or of the spilled partition last aggregated */
+  const AggregationHashTable &GetTable() const { return table_; }
+
+  /**
+   * Replace the groups in memory by those of the next spilled partition; the input must be done.
+   * @return false, leaving no groups in memory, if no spilled partitions are left
+   */
+  bool NextPartition();
+
+  /** Drop all groups and spilled partitions, to start over with new input. */
+  void Clear();
+
+  /** @return the number of partitions spilled so far, counting those spilled again while being aggregated */
+  size_t NumSpilledPartitions() const { return num_spilled_partitions_; }
+
+  /** @return the bytes of rows spilled so far */
+  size_t GetSpilledBytes() const { return spilled_bytes_; }
+
+ private:
+  /** Partitions split the hash of a key PARTITION_BITS at a time, from the top bits down */
+  static constexpr size_t PARTITION_BITS = 3;
+  static constexpr size_t NUM_PARTITIONS = 1 << PARTITION_BITS;
+  static constexpr size_t MAX_PARTITION_LEVELS = 4;
+
+  /** A spilled partition yet to be aggregated */
+  struct SpilledPartition {
+    std::unique_ptr<TmpTupleFile> file_;
+    /** The level at which its rows get partitioned */
+    size_t level_;
+  };
+
+  /** @return The partition of a key hash at the given level */
+  size_t PartitionOf(hash_t hash, size_t level) const {
+    return (hash >> (8 * sizeof(hash_t) - hash_bits_ - PARTITION_BITS * (level + 1))) & (NUM_PARTITIONS - 1);
+  }
+
+  /** Reserve memory for the table as it grows; @return false if the budget does not allow it */
+  bool FitInBudget();
+
+  /** Queue the partitions spilled while aggregating the input or the last partition. */
+  void FinishSpilling();
+
+  /** Release the memory reserved for the table. */
+  void ReleaseMemory();
+
+  BufferPoolManager *bpm_;
+  std::shared_ptr<MemoryBudget> budget_;
+  /** The top bits of the hash that all keys share */
+  size_t hash_bits_;
+  AggregationHashTable table_;
+  /** The bytes reserved from the budget for the table */
+  size_t reserved_{0};
+  /** The level at which the rows of new keys get partitioned, and whether they are being spilled */
+  size_t level_{0};
+  bool spilling_{false};
+  /** The schema of the input, for reading spilled rows back */
+  const Schema *input_schema_{nullptr};
+  /** The file of each partition being spilled to; nullptr for partitions without spilled rows */
+  std::vector<std::unique_ptr<TmpTupleFile>> files_;
+  std::vector<SpilledPartition> pending_;
+  /** Scratch space for InsertBatch(): the rows of new keys */
+  std::vector<std::pair<size_t, hash_t>> rejected_;
+  size_t num_spilled_partitions_{0};
+  size_t spilled_bytes_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table.h
+//
+// Identification: src/include/execution/join_hash_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "common/arena.h"
+#include "common/util/hash_util.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/tuple_batch.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * JoinHashTable maps join keys to the build-side rows that have them, for keys of any number and type of columns.
+ *
+ * A key is serialized into bytes, one fixed-size or length-prefixed field per column, in a form under which equal
+ * values have equal bytes. All numbers share one form, so keys of different numeric types match when their values
+ * are equal: integral values and whole DECIMALs become a 64-bit integer, and other DECIMALs a tagged double.
+ * The table is open-addressed over cache-line-sized buckets of four slots, each holding the cached hash of a key next
+ * to a pointer to it, so a probe mostly touches one cache line and compares key bytes only on a hash match. It is kept
+ * at most half full, which ends nearly every probe in its first bucket. Keys and the row lists hanging off them live
+ * in an arena rather than in a node allocation per key, and growing the table reuses the cached hashes.
+ */
+class JoinHashTable {
+ public:
+  /** A build-side row: the index of its batch and its row in that batch. Rows with one key form a list. */
+  struct RowEntry {
+    const RowEntry *next_;
+    uint32_t batch_idx_;
+    uint32_t row_;
+  };
+
+  /** Create an empty table. */
+  JoinHashTable();
+
+  /**
+   * Append the serialized form of one key column to a key.
+   * @return false if the value is NULL, which never joins
+   */
+  static bool SerializeKeyColumn(const Value &value, std::vector<char> *key);
+
+  /**
+   * Append the key of a row of a batch, one column per key expression, to the keys serialized so far.
+   * @return false, leaving keys as it was, if a column of the key is NULL
+   */
+  static bool SerializeKey(const std::vector<const AbstractExpression *> &key_exprs, const TupleBatch *batch,
+                           size_t row, std::vector<char> *keys);
+
+  /** @return the hash of a serialized key */
+  static hash_t HashKey(const char *key, size_t size) { return HashUtil::HashBytesMixed(key, size); }
+
+  /** Add a row under a serialized key with the given hash. */
+  void Insert(const char *key, size_t size, hash_t hash, uint32_t batch_idx, uint32_t row);
+
+  /**
+   * Start loading the bucket of a hash into the cache. Probing a batch of keys goes faster if all their buckets are
+   * prefetched before the first Find(), so that the cache misses overlap.
+   */
+  void Prefetch(hash_t hash) const { __builtin_prefetch(&buckets_[hash & mask_]); }
+
+  /** @return the first of the rows with a serialized key and hash, in the order they were added; nullptr if none */
+  const RowEntry *Find(const char *key, size_t size, hash_t hash) const {
+    for (size_t b = hash & mask_;; b = (b + 1) & mask_) {
+      const Bucket &bucket = buckets_[b];
+      for (size_t slot = 0; slot < SLOTS_PER_BUCKET; slot++) {
+        const KeyEntry *entry = bucket.keys_[slot];
+        if (entry == nullptr) {
+          return nullptr;
+        }
+        if (bucket.hashes_[slot] == hash && KeyEquals(entry, key, size)) {
+          return entry->head_;
+        }
+      }
+    }
+  }
+
+  /** @return the number of distinct keys */
+  size_t NumKeys() const { return num_keys_; }
+
+  /** @return the number of rows */
+  size_t NumRows() const { return num_rows_; }
+
+  /** @return the bytes the table takes */
+  size_t MemoryUsage() const { return buckets_.size() * sizeof(Bucket) + arena_.MemoryUsage(); }
+
+  /** @return at most the bytes that a row with a key of the given size adds to a table */
+  static size_t EstimateMemoryUsage(size_t key_size) {
+    // a key has up to four slots to itself: the table is at most half full, and just grown it is a quarter full
+    return sizeof(RowEntry) + sizeof(KeyEntry) + key_size + 4 * (sizeof(hash_t) + sizeof(KeyEntry *));
+  }
+
+  /** Remove all keys and rows. */
+  void Clear();
+
+ private:
+  /** A distinct key, followed in memory by its size_ bytes. */
+  struct KeyEntry {
+    RowEntry *head_;
+    RowEntry *tail_;
+    uint32_t size_;
+  };
+
+  static constexpr size_t SLOTS_PER_BUCKET = 4;
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+  static constexpr size_t INITIAL_BUCKETS = 16;
+
+  /** Slots fill from the front and are never emptied, so an empty slot ends a probe. */
+  struct alignas(CACHE_LINE_SIZE) Bucket {
+    hash_t hashes_[SLOTS_PER_BUCKET];
+    KeyEntry *keys_[SLOTS_PER_BUCKET];
+  };
+  static_assert(sizeof(Bucket) == CACHE_LINE_SIZE, "a bucket should fill one cache line");
+
+  static const char *KeyData(const KeyEntry *entry) { return reinterpret_cast<const char *>(entry + 1); }
+
+  static bool KeyEquals(const KeyEntry *entry, const char *key, size_t size) {
+    return entry->size_ == size && memcmp(KeyData(entry), key, size) == 0;
+  }
+
+  /** Double the number of buckets, placing the keys by their cached hashes. */
+  void Grow();
+
+  std::vector<Bucket> buckets_;
+  size_t mask_;
+  size_t num_keys_{0};
+  size_t num_rows_{0};
+  Arena arena_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_budget.h
+//
+// Identification: src/include/execution/memory_budget.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * MemoryBudget accounts for the memory that the operators of a query hold, such as the build side of a hash join,
+ * against a limit. An operator reserves memory before it grows and releases it when done; when a reservation fails,
+ * the operator is expected to spill to disk instead. Thread safe, so that the copies of a parallel plan can share it.
+ */
+class MemoryBudget {
+ public:
+  /** @param limit the most bytes that may be reserved at once */
+  explicit MemoryBudget(size_t limit) : limit_(limit) {}
+
+  DISALLOW_COPY_AND_MOVE(MemoryBudget);
+
+  /** @return the most bytes that may be reserved at once */
+  size_t GetLimit() const { return limit_; }
+
+  /** Change the limit; reservations already made are kept. */
+  void SetLimit(size_t limit) { limit_ = limit; }
+
+  /** @return the number of bytes reserved */
+  size_t GetReserved() const { return reserved_.load(); }
+
+  /**
+   * Reserve memory if that stays within the limit.
+   * @return false, reserving nothing, if it does not
+   */
+  bool TryReserve(size_t bytes) {
+    size_t reserved = reserved_.load();
+    do {
+      if (reserved + bytes > limit_) {
+        return false;
+      }
+    } while (!reserved_.compare_exchange_weak(reserved, reserved + bytes));
+    return true;
+  }
+
+  /** Reserve memory even beyond the limit, for what an operator needs to make progress at all. */
+  void Reserve(size_t bytes) { reserved_ += bytes; }
+
+  /** Return reserved memory. */
+  void Release(size_t bytes) { reserved_ -= bytes; }
+
+ private:
+  std::atomic<size_t> limit_;
+  std::atomic<size_t> reserved_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_dispenser.h
+//
+// Identification: src/include/execution/morsel_dispenser.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * MorselDispenser hands out the pages of a table in morsels, runs of consecutive pages from its page directory, to
+ * the worker threads of a parallel scan. Workers pull a new morsel whenever they finish one, so faster workers simply
+ * take more of them.
+ */
+class MorselDispenser {
+ public:
+  /**
+   * @param page_ids the pages to hand out, e.g. TableHeap::GetPageDirectory()
+   * @param morsel_size the number of pages in a morsel
+   */
+  explicit MorselDispenser(std::vector<page_id_t> page_ids, size_t morsel_size = MORSEL_SIZE)
+      : page_ids_(std::move(page_ids)), morsel_size_(std::max<size_t>(morsel_size, 1)) {}
+
+  /**
+   * Take the next morsel; thread safe.
+   * @param[out] begin the index of the first page of the morsel
+   * @param[out] end one past the index of the last page of the morsel
+   * @return false if every page has been handed out
+   */
+  bool Next(size_t *begin, size_t *end) {
+    size_t start = next_.fetch_add(morsel_size_);
+    if (start >= page_ids_.size()) {
+      return false;
+    }
+    *begin = start;
+    *end = std::min(start + morsel_size_, page_ids_.size());
+    return true;
+  }
+
+  /** @return the id of the page at the given index */
+  page_id_t GetPageId(size_t index) const { return page_ids_[index]; }
+
+ private:
+  const std::vector<page_id_t> page_ids_;
+  const size_t morsel_size_;
+  std::atomic<size_t> next_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// operator_state_registry.h
+//
+// Identification: src/include/execution/operator_state_registry.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * OperatorStateRegistry holds the state that the copies of one executor share when a plan fragment runs on several
+ * threads, such as the morsel dispenser of a parallel scan. The state of an operator is keyed by its plan node, which
+ * all copies have in common; whichever copy asks first creates it.
+ */
+class OperatorStateRegistry {
+ public:
+  /**
+   * Get the state shared by the copies of an operator, creating it if this is the first copy to ask; thread safe.
+   * @param plan the plan node of the operator
+   * @param factory returns a std::shared_ptr<State> to a new state; called while the registry is latched
+   */
+  template <typename State, typename Factory>
+  std::shared_ptr<State> GetOrCreate(const AbstractPlanNode *plan, Factory &&factory) {
+    std::scoped_lock lock(latch_);
+    std::shared_ptr<void> &state = states_[plan];
+    if (state == nullptr) {
+      state = factory();
+    }
+    return std::static_pointer_cast<State>(state);
+  }
+
+ private:
+  std::mutex latch_;
+  std::unordered_map<const AbstractPlanNode *, std::shared_ptr<void>> states_;
+};
+
+}  // namespace bustub
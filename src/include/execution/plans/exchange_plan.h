@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_plan.h
+//
+// Identification: src/include/execution/plans/exchange_plan.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * Exchange repartitions the output of its child plan between the copies of the plan fragment it is in.
+ *
+ * Its child runs as one producer per copy on worker threads, each on part of the input. The producers hash the
+ * partition columns of every tuple and send it to the copy that owns that hash, so that equal keys meet in the same
+ * copy. Without partition columns the producers deal out their batches round robin instead. Outside a Gather the
+ * exchange has a single partition, and just runs its child on another thread.
+ *
+ * An exchange runs its input once; it must not be initialized again, e.g. on the inner side of a nested loop join.
+ */
+class ExchangePlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new ExchangePlanNode instance.
+   * @param output_schema The output schema, the same as that of the child plan
+   * @param child The child plan from which tuples are obtained
+   * @param partition_by The expressions, over the child's output, that choose the partition of a tuple
+   */
+  ExchangePlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+                   std::vector<const AbstractExpression *> &&partition_by)
+      : AbstractPlanNode(output_schema, {child}), partition_by_{std::move(partition_by)} {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::Exchange; }
+
+  /** @return The expressions that choose the partition of a tuple */
+  const std::vector<const AbstractExpression *> &GetPartitionBy() const { return partition_by_; }
+
+  /** @return The child plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Exchange should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+ private:
+  /** The expressions that choose the partition of a tuple */
+  std::vector<const AbstractExpression *> partition_by_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_plan.h
+//
+// Identification: src/include/execution/plans/gather_plan.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * Gather runs its child plan, a plan fragment, as several copies on worker threads and merges their output in no
+ * particular order.
+ *
+ * Each copy sees part of the input: the scans of the fragment split the pages of their table between the copies, and
+ * an Exchange in the fragment hands copy i partition i of its input. A fragment therefore computes the right result
+ * only if its operators work partition by partition, e.g. a hash join whose inputs are both exchanged on the join
+ * key, or an aggregation whose input is exchanged on the group by columns. The inner side of a nested loop join,
+ * which is scanned again for every outer tuple, must not be in a fragment.
+ */
+class GatherPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new GatherPlanNode instance.
+   * @param output_schema The output schema, the same as that of the child plan
+   * @param child The plan fragment to run in parallel
+   * @param num_workers The number of copies of the fragment
+   */
+  GatherPlanNode(const Schema *output_schema, const AbstractPlanNode *child, size_t num_workers)
+      : AbstractPlanNode(output_schema, {child}), num_workers_{num_workers} {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::Gather; }
+
+  /** @return The number of copies of the fragment */
+  size_t GetNumWorkers() const { return num_workers_; }
+
+  /** @return The child plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Gather should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+ private:
+  /** The number of copies of the fragment */
+  size_t num_workers_;
+};
+
+}  // namespace bustub
@@ -34,17 +34,40 @@ class HashJoinPlanNode : public AbstractPlanNode {
   HashJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
                    const AbstractExpression *left_key_expression, const AbstractExpression *right_key_expression)
       : AbstractPlanNode(output_schema, std::move(children)),
-        left_key_expression_{left_key_expression},
-        right_key_expression_{right_key_expression} {}
+        left_key_expressions_{left_key_expression},
+        right_key_expressions_{right_key_expression} {}
+
+  /**
+   * Construct a new HashJoinPlanNode instance that joins on several columns.
+   * @param output_schema The output schema for the JOIN
+   * @param children The child plans from which tuples are obtained
+   * @param left_key_expressions The expressions for the left JOIN key
+   * @param right_key_expressions The expressions for the right JOIN key, one per left key expression
+   */
+  HashJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                   std::vector<const AbstractExpression *> &&left_key_expressions,
+                   std::vector<const AbstractExpression *> &&right_key_expressions)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        left_key_expressions_{std::move(left_key_expressions)},
+        right_key_expressions_{std::move(right_key_expressions)} {
+    BUSTUB_ASSERT(left_key_expressions_.size() == right_key_expressions_.size(),
+                  "Both sides of a hash join should have the same number of key expressions.");
+  }
 
   /** @return The type of the plan node */
   PlanType GetType() const override { return PlanType::HashJoin; }
 
-  /** @return The expression to compute the left join key */
-  const AbstractExpression *LeftJoinKeyExpression() const { return left_key_expression_; }
+  /** @return The expression to compute the left join key, or its first column if it has several */
+  const AbstractExpression *LeftJoinKeyExpression() const { return left_key_expressions_[0]; }
+
+  /** @return The expression to compute the right join key, or its first column if it has several */
+  const AbstractExpression *RightJoinKeyExpression() const { return right_key_expressions_[0]; }
+
+  /** @return The expressions to compute the columns of the left join key */
+  const std::vector<const AbstractExpression *> &LeftJoinKeyExpressions() const { return left_key_expressions_; }
 
-  /** @return The expression to compute the right join key */
-  const AbstractExpression *RightJoinKeyExpression() const { return right_key_expression_; }
+  /** @return The expressions to compute the columns of the right join key */
+  const std::vector<const AbstractExpression *> &RightJoinKeyExpressions() const { return right_key_expressions_; }
 
   /** @return The left plan node of the hash join */
   const AbstractPlanNode *GetLeftPlan() const {
@@ -59,10 +82,10 @@ class HashJoinPlanNode : public AbstractPlanNode {
   }
 
  private:
-  /** The expression to compute the left JOIN key */
-  const AbstractExpression *left_key_expression_;
-  /** The expression to compute the right JOIN key */
-  const AbstractExpression *right_key_expression_;
+  /** The expressions to compute the left JOIN key */
+  std::vector<const AbstractExpression *> left_key_expressions_;
+  /** The expressions to compute the right JOIN key */
+  std::vector<const AbstractExpression *> right_key_expressions_;
 };
 
 }  // namespace bustub
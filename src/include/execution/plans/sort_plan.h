@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_plan.h
+//
+// Identification: src/include/execution/plans/sort_plan.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** OrderByType is the direction in which a sort key orders the rows */
+enum class OrderByType { ASC, DESC };
+
+/**
+ * Sort orders the output of its child by a list of keys, e.g. for ORDER BY. Each key is an expression over the child's
+ * output and a direction; later keys break the ties of earlier ones. NULLs come before all other values of a key in
+ * ascending order, and after them in descending order.
+ */
+class SortPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new SortPlanNode instance.
+   * @param output_schema The output schema, the same as that of the child plan
+   * @param child The child plan from which tuples are obtained
+   * @param order_bys The sort keys, each an expression over the child's output and its direction
+   */
+  SortPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+               std::vector<std::pair<const AbstractExpression *, OrderByType>> &&order_bys)
+      : AbstractPlanNode(output_schema, {child}), order_bys_{std::move(order_bys)} {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::Sort; }
+
+  /** @return The sort keys */
+  const std::vector<std::pair<const AbstractExpression *, OrderByType>> &GetOrderBys() const { return order_bys_; }
+
+  /** @return The child plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Sort should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+ private:
+  /** The sort keys, in order of precedence */
+  std::vector<std::pair<const AbstractExpression *, OrderByType>> order_bys_;
+};
+
+}  // namespace bustub
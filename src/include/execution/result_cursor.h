@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// result_cursor.h
+//
+// Identification: src/include/execution/result_cursor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include "common/exception.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * ResultCursor streams the result of a query to the client, one batch at a time, so that the client sees the first
+ * rows as soon as the plan produces them and never holds more than a batch of the result.
+ *
+ * The plan is initialized on the first pull. If the transaction gets aborted along the way, the cursor aborts it
+ * through the transaction manager and ends the result early. If an executor fails with an Exception, such as running
+ * out of buffer pool frames, the result ends early as well, and the cursor keeps the exception for GetError().
+ */
+class ResultCursor {
+ public:
+  /**
+   * Construct a new ResultCursor instance.
+   * @param exec_ctx The executor context in which the query executes
+   * @param executor The root executor of the query plan, not yet initialized
+   */
+  ResultCursor(ExecutorContext *exec_ctx, std::unique_ptr<AbstractExecutor> &&executor);
+
+  DISALLOW_COPY_AND_MOVE(ResultCursor);
+
+  /** @return The schema of the result */
+  const Schema *GetOutputSchema() const { return batch_.GetSchema(); }
+
+  /**
+   * Yield the next row of the result.
+   * @param[out] tuple The next row
+   * @return `true` if a row was produced, `false` if there are no more rows
+   */
+  bool Next(Tuple *tuple);
+
+  /**
+   * Yield the next rows of the result as a batch, which stays valid until the next call. Rows already handed out by
+   * Next() are not repeated.
+   * @return The next rows, or nullptr if there are no more rows
+   */
+  const TupleBatch *NextBatch();
+
+  /** @return `true` if the result ended early because the transaction was aborted */
+  bool IsAborted() const { return aborted_; }
+
+  /** @return The exception that ended the result early, or nullptr if the plan has not failed */
+  const Exception *GetError() const { return error_.has_value() ? &*error_ : nullptr; }
+
+  /** Stop executing the query, e.g. because the client has seen enough rows; releases its threads and memory. */
+  void Close();
+
+ private:
+  /** Pull the next batch from the plan into batch_; false once the plan is exhausted or failed. */
+  bool Fetch();
+
+  /** The executor context in which the query executes */
+  ExecutorContext *exec_ctx_;
+  /** The root executor of the query plan; nullptr once closed */
+  std::unique_ptr<AbstractExecutor> executor_;
+  /** The batch being handed out, and the next row Next() hands out from it */
+  TupleBatch batch_;
+  size_t next_row_{0};
+  bool initialized_{false};
+  bool done_{false};
+  bool aborted_{false};
+  std::optional<Exception> error_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter.h
+//
+// Identification: src/include/execution/runtime_filter.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "common/macros.h"
+#include "execution/bloom_filter.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/selection_bitmap.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * RuntimeFilter is a filter that an executor builds while the query runs and pushes down to a scan below it, such as
+ * the Bloom filter over the build keys of a hash join, which lets the probe-side scan drop rows that cannot join
+ * before it materializes them.
+ *
+ * A row passes if its key, serialized and hashed as JoinHashTable does, may be in the Bloom filter; rows with a NULL
+ * key never pass. Apply() is thread safe, so the tasks of a parallel scan can share a filter, and counts the rows it
+ * checks and eliminates.
+ */
+class RuntimeFilter {
+ public:
+  /**
+   * @param key_exprs the key of a row, as expressions over the batches the filter is applied to
+   * @param bloom_filter a filter over the hashes of the keys that pass
+   */
+  RuntimeFilter(std::vector<const AbstractExpression *> key_exprs, BloomFilter &&bloom_filter);
+
+  DISALLOW_COPY_AND_MOVE(RuntimeFilter);
+
+  /** Deselect the selected rows of a batch that do not pass the filter. */
+  void Apply(const TupleBatch &batch, SelectionBitmap *selection);
+
+  /** @return the number of rows checked against the filter */
+  size_t NumRowsChecked() const { return rows_checked_.load(); }
+
+  /** @return the number of rows the filter eliminated */
+  size_t NumRowsEliminated() const { return rows_eliminated_.load(); }
+
+  /** @return the bytes the filter takes */
+  size_t MemoryUsage() const { return bloom_filter_.MemoryUsage(); }
+
+ private:
+  std::vector<const AbstractExpression *> key_exprs_;
+  BloomFilter bloom_filter_;
+  std::atomic<size_t> rows_checked_{0};
+  std::atomic<size_t> rows_eliminated_{0};
+};
+
+}  // namespace bustub
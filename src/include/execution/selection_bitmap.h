@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// selection_bitmap.h
+//
+// Identification: src/include/execution/selection_bitmap.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * SelectionBitmap marks which rows of a TupleBatch pass a filter, one bit per row, 64 rows to a word. Bits past the
+ * last row are always zero.
+ */
+class SelectionBitmap {
+ public:
+  /** Number of rows covered by one word */
+  static constexpr size_t WORD_BITS = 64;
+
+  /** Cover num_rows rows, none of them selected. */
+  void Reset(size_t num_rows) {
+    num_rows_ = num_rows;
+    words_.assign((num_rows + WORD_BITS - 1) / WORD_BITS, 0);
+  }
+
+  /** Select every row. */
+  void SelectAll() {
+    words_.assign(words_.size(), ~uint64_t{0});
+    if (num_rows_ % WORD_BITS != 0) {
+      words_.back() = (uint64_t{1} << (num_rows_ % WORD_BITS)) - 1;
+    }
+  }
+
+  /** @return the number of rows covered */
+  size_t Size() const { return num_rows_; }
+
+  /** @return true if the row is selected */
+  bool IsSelected(size_t row) const { return ((words_[row / WORD_BITS] >> (row % WORD_BITS)) & 1) != 0; }
+
+  /** Select the row. */
+  void Select(size_t row) { words_[row / WORD_BITS] |= uint64_t{1} << (row % WORD_BITS); }
+
+  /** Deselect the row. */
+  void Deselect(size_t row) { words_[row / WORD_BITS] &= ~(uint64_t{1} << (row % WORD_BITS)); }
+
+  /** @return the number of selected rows */
+  size_t CountSelected() const {
+    size_t count = 0;
+    for (uint64_t word : words_) {
+      count += __builtin_popcountll(word);
+    }
+    return count;
+  }
+
+  /** Deselect every row that is not selected in other, which covers the same rows. */
+  void Intersect(const SelectionBitmap &other) {
+    for (size_t i = 0; i < words_.size(); i++) {
+      words_[i] &= other.words_[i];
+    }
+  }
+
+  /** @return the words of the bitmap; row i is bit i % 64 of word i / 64 */
+  uint64_t *GetWords() { return words_.data(); }
+  const uint64_t *GetWords() const { return words_.data(); }
+
+ private:
+  size_t num_rows_{0};
+  std::vector<uint64_t> words_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * ColumnVector holds the values of one column for every row of a TupleBatch.
+ *
+ * Inlined (fixed-width) columns are stored back to back in their serialized form, so that e.g. an INTEGER column is
+ * an array of int32_t that a kernel can run over directly; nulls are the type's null sentinel, as in a tuple.
+ * VARCHAR columns are kept as Values.
+ */
+class ColumnVector {
+ public:
+  /**
+   * Create an empty column.
+   * @param type the type of the column
+   * @param capacity the number of rows to reserve space for
+   */
+  explicit ColumnVector(TypeId type, size_t capacity = BATCH_SIZE);
+
+  /** @return the type of the column */
+  TypeId GetType() const { return type_; }
+
+  /** @return true if the values are stored in their fixed-width serialized form */
+  bool IsInlined() const { return type_ != TypeId::VARCHAR; }
+
+  /** @return the number of values in the column */
+  size_t Size() const { return size_; }
+
+  /** @return the serialized values of an inlined column, Type::GetTypeSize(GetType()) bytes each */
+  const char *GetData() const { return data_.data(); }
+
+  /** @return the value at the given row */
+  Value GetValue(size_t row) const;
+
+  /** Append a value of the column's type. */
+  void Append(const Value &value);
+
+  /** Append the value of an inlined column from its serialized form, e.g. straight from tuple storage. */
+  void AppendRaw(const char *storage);
+
+  /** Append the value at a row of another column of the same type. */
+  void AppendFrom(const ColumnVector &other, size_t row);
+
+  /** Drop every value from the given row on. */
+  void Truncate(size_t size);
+
+  /** @return the bytes the values of the column take */
+  size_t MemoryUsage() const;
+
+  /** @return the bytes the value at the given row takes */
+  size_t MemoryUsage(size_t row) const;
+
+ private:
+  TypeId type_;
+  /** Bytes per value of an inlined column */
+  uint32_t width_;
+  size_t size_{0};
+  std::vector<char> data_;
+  std::vector<Value> values_;
+};
+
+/**
+ * TupleBatch is a block of up to Capacity() rows in column-oriented form, the unit of work that
+ * AbstractExecutor::NextBatch passes between executors. Every row also carries the RID it came from, which is only
+ * valid for rows read from a table.
+ */
+class TupleBatch {
+ public:
+  /**
+   * Create an empty batch.
+   * @param schema the schema of the rows, which must outlive the batch; nullptr for rows without columns
+   * @param capacity the most rows the batch holds
+   */
+  explicit TupleBatch(const Schema *schema, size_t capacity = BATCH_SIZE);
+
+  /** @return the schema of the rows in the batch */
+  const Schema *GetSchema() const { return schema_; }
+
+  /** @return the number of rows in the batch */
+  size_t Size() const { return rids_.size(); }
+
+  /** @return the most rows the batch holds */
+  size_t Capacity() const { return capacity_; }
+
+  /** @return true if the batch has no rows */
+  bool IsEmpty() const { return rids_.empty(); }
+
+  /** @return true if no more rows fit in the batch */
+  bool IsFull() const { return rids_.size() >= capacity_; }
+
+  /** @return the column at the given index of the schema */
+  const ColumnVector &GetColumn(uint32_t col_idx) const { return columns_[col_idx]; }
+
+  /** @return the value of a column at the given row */
+  Value GetValue(size_t row, uint32_t col_idx) const { return columns_[col_idx].GetValue(row); }
+
+  /** @return the RID of the given row */
+  const RID &GetRid(size_t row) const { return rids_[row]; }
+
+  /** @return the given row as a tuple of the batch's schema */
+  Tuple GetTuple(size_t row) const;
+
+  /** Append a tuple laid out according to the batch's schema. */
+  void AppendTuple(const Tuple &tuple, const RID &rid);
+
+  /** Append a row given as one value per column. */
+  void AppendValues(const std::vector<Value> &values, const RID &rid = RID());
+
+  /** Append a row of another batch with the same column types. */
+  void AppendRow(const TupleBatch &other, size_t row);
+
+  /** Drop every row from the given row on. */
+  void Truncate(size_t size);
+
+  /** Drop all rows. */
+  void Clear() { Truncate(0); }
+
+  /** @return the bytes the rows of the batch take, for operators that account for the memory they hold */
+  size_t MemoryUsage() const;
+
+  /** @return the bytes the given row takes */
+  size_t MemoryUsage(size_t row) const;
+
+ private:
+  const Schema *schema_;
+  size_t capacity_;
+  std::vector<ColumnVector> columns_;
+  std::vector<RID> rids_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vectorized_filter.h
+//
+// Identification: src/include/execution/vectorized_filter.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/selection_bitmap.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * VectorizedFilter evaluates predicates over whole batches into a SelectionBitmap.
+ *
+ * A comparison of an INTEGER, BIGINT or DECIMAL column with a constant runs as a kernel over the column's packed
+ * values, using AVX2 or SSE4.2 when BusTub is compiled for a CPU that has them and plain loops otherwise. Rows where
+ * the column is null never pass such a comparison. Any other predicate is evaluated row by row.
+ */
+class VectorizedFilter {
+ public:
+  /**
+   * Select the rows of a batch that satisfy a predicate.
+   * @param predicate the predicate over the batch's schema, or nullptr to select every row
+   * @param batch the batch to filter
+   * @param[out] selection reset to cover the batch, with the passing rows selected
+   */
+  static void Filter(const AbstractExpression *predicate, const TupleBatch &batch, SelectionBitmap *selection);
+
+  /** @return true if Filter() runs the predicate as a kernel rather than row by row */
+  static bool CanVectorize(const AbstractExpression *predicate);
+
+  /**
+   * The kernels: set bit i of bits for every value i in [0, n) that is not null and compares to the constant as asked.
+   * The words covering the n bits must be zeroed by the caller.
+   */
+  static void CompareInt32(const int32_t *values, size_t n, ComparisonType comp_type, int32_t constant,
+                           uint64_t *bits);
+  static void CompareInt64(const int64_t *values, size_t n, ComparisonType comp_type, int64_t constant,
+                           uint64_t *bits);
+  static void CompareDouble(const double *values, size_t n, ComparisonType comp_type, double constant, uint64_t *bits);
+
+ private:
+  /**
+   * Take a predicate of the form `column op constant` or `constant op column` apart, turning the latter around.
+   * @return false if the predicate has another form, or a column or constant the kernels do not handle
+   */
+  static bool Decompose(const AbstractExpression *predicate, uint32_t *col_idx, TypeId *col_type,
+                        ComparisonType *comp_type, Value *constant);
+};
+
+}  // namespace bustub
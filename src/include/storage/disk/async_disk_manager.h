@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_manager.h
+//
+// Identification: src/include/storage/disk/async_disk_manager.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/io_uring.h"
+
+namespace bustub {
+
+/**
+ * AsyncDiskManager completes page requests in the background, so that a caller can keep many reads and writes in
+ * flight at once.
+ *
+ * When BusTub is built with BUSTUB_USE_IO_URING (the default on Linux), every SubmitRequests batch is prepared on an
+ * io_uring submission ring and handed to the kernel with a single system call; a reaper thread consumes the
+ * completions and runs the callbacks. Otherwise, or when the kernel refuses to set up a ring, every batch is queued at
+ * once and served by a small pool of worker threads doing positional reads and writes, which run the callbacks as the
+ * requests complete. The pool is kept small: the threads only wait on the disk, and a handful of them already keeps a
+ * device busy.
+ *
+ * The synchronous ReadPage/WritePage inherited from DiskManager stay available and may be mixed with submitted
+ * requests.
+ */
+class AsyncDiskManager : public DiskManager {
+ public:
+  /**
+   * Creates a new asynchronous disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param direct_io true to bypass the OS page cache with O_DIRECT, if the file system supports it
+   * @param num_threads the number of worker threads, and so of requests kept in flight, if there is no io_uring ring
+   * @param io_uring false to use the worker threads even where io_uring is available
+   */
+  explicit AsyncDiskManager(const std::string &db_file, bool direct_io = false, size_t num_threads = ASYNC_IO_THREADS,
+                            bool io_uring = true);
+
+  /** Waits for all submitted requests and stops the background threads. */
+  ~AsyncDiskManager() override;
+
+  /**
+   * Wait for all submitted requests, stop the background threads and close all the file resources.
+   */
+  void ShutDown() override;
+
+  /**
+   * Submit a batch of page requests. Returns once the batch has been queued; callbacks run on a background thread as
+   * the requests complete, and must not submit requests themselves.
+   * @param requests the requests to submit; they are moved from
+   */
+  void SubmitRequests(std::vector<DiskRequest> *requests) override;
+
+  bool IsAsynchronous() const override { return true; }
+
+  /** @return the number of worker threads, which is 0 if requests go through io_uring */
+  size_t GetNumThreads() const { return workers_.size(); }
+
+  /** @return true if requests are submitted through io_uring rather than to the worker threads */
+  bool UsesIoUring() const;
+
+ private:
+  /** Run the request synchronously with pread/pwrite, then its callback. */
+  void Perform(DiskRequest *request);
+  /** Body of a worker thread. */
+  void WorkerLoop();
+  /** Wait for in-flight requests and join the background threads; idempotent. */
+  void StopThreads();
+
+#ifdef BUSTUB_USE_IO_URING
+  /** A request handed to the ring, until its completion is reaped. */
+  struct RingRequest {
+    DiskRequest request_;
+    /** An aligned copy of the data, for direct I/O on an unaligned buffer; else empty */
+    std::unique_ptr<char, decltype(&free)> bounce_{nullptr, &free};
+  };
+
+  /**
+   * Prepare a request on the ring, submitting and waiting for room as needed.
+   * @param submit_lock the caller's lock on submit_latch_, let go of while waiting
+   */
+  void PrepareOnRing(std::unique_lock<std::mutex> *submit_lock, std::unique_ptr<RingRequest> ring_request);
+  /** Body of the thread consuming the completions of the ring. */
+  void ReapCompletions();
+
+  std::unique_ptr<IoUring> ring_;
+  /** Serializes preparing and submitting requests, and protects ring_in_flight_. */
+  std::mutex submit_latch_;
+  /** Signalled when a completion is reaped, making room for another request. */
+  std::condition_variable ring_space_cv_;
+  /** Requests on the ring whose completion has not been reaped; kept within the completion ring's size. */
+  size_t ring_in_flight_{0};
+  std::thread reaper_;
+#endif
+
+  /** Protects queue_, in_flight_ and stopped_. */
+  std::mutex latch_;
+  std::condition_variable queue_cv_;
+  std::condition_variable idle_cv_;
+  std::deque<DiskRequest> queue_;
+  size_t in_flight_{0};
+  bool stopped_{false};
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace bustub
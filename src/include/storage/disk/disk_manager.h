@@ -13,33 +13,57 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <fstream>
+#include <functional>
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 
 namespace bustub {
 
+/**
+ * DiskRequest is a single page read or write handed to DiskManager::SubmitRequests.
+ */
+struct DiskRequest {
+  /** True for a write, false for a read. */
+  bool is_write_;
+  /** The page to read or write. */
+  page_id_t page_id_;
+  /** PAGE_SIZE bytes to write from, or to read into. Must stay valid until the callback runs. */
+  char *data_;
+  /** Invoked once the request has completed, possibly on another thread. May be empty. */
+  std::function<void()> callback_;
+};
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * Pages are read and written with positional pread/pwrite on a single file descriptor, so I/O on different pages from
+ * different threads proceeds in parallel. In direct I/O mode the file is opened with O_DIRECT to bypass the OS page
+ * cache; buffers should then be aligned to DIRECT_IO_ALIGNMENT, as buffer pool frames are, otherwise the data is
+ * staged through an aligned bounce buffer.
  */
 class DiskManager {
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param direct_io true to bypass the OS page cache with O_DIRECT, if the file system supports it
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, bool direct_io = false);
 
-  ~DiskManager() = default;
+  /** Closes the database file if ShutDown was not called. */
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
    * Write a page to the database file.
@@ -48,6 +72,14 @@ class DiskManager {
    */
   void WritePage(page_id_t page_id, const char *page_data);
 
+  /**
+   * Write a run of consecutive pages to the database file with a single write.
+   * @param first_page_id id of the first page of the run
+   * @param num_pages number of pages in the run
+   * @param page_data raw data of all the pages, num_pages * PAGE_SIZE bytes
+   */
+  void WritePages(page_id_t first_page_id, size_t num_pages, const char *page_data);
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
@@ -55,6 +87,30 @@ class DiskManager {
    */
   void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Submit a batch of page reads and writes. Requests in one batch may complete in any order; each request's callback
+   * runs when it is done. This implementation performs the requests one by one before returning, AsyncDiskManager
+   * completes them in the background.
+   * @param requests the requests to submit; they are moved from
+   */
+  virtual void SubmitRequests(std::vector<DiskRequest> *requests);
+
+  /**
+   * Read a page through SubmitRequests.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, which must stay valid until the returned future is ready
+   * @return a future that becomes ready once the page has been read
+   */
+  std::future<void> ReadPageAsync(page_id_t page_id, char *page_data);
+
+  /**
+   * Write a page through SubmitRequests.
+   * @param page_id id of the page
+   * @param page_data raw page data, which must stay valid until the returned future is ready
+   * @return a future that becomes ready once the page has been written
+   */
+  std::future<void> WritePageAsync(page_id_t page_id, const char *page_data);
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -80,6 +136,12 @@ class DiskManager {
   /** @return the number of disk writes */
   int GetNumWrites() const;
 
+  /** @return true if SubmitRequests returns before the requests complete */
+  virtual bool IsAsynchronous() const { return false; }
+
+  /** @return true if page I/O bypasses the OS page cache */
+  bool IsDirectIO() const { return direct_io_; }
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -89,20 +151,38 @@ class DiskManager {
   /** Checks if the non-blocking flush future was set. */
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
+ protected:
+  /**
+   * Make sure the database file covers [0, end), preallocating whole extents so that the file is not extended one
+   * page at a time. Preallocated space reads back as zeros.
+   * @param end the offset one past the last byte about to be written
+   */
+  void EnsureAllocated(size_t end);
+  // descriptor of the db file, read and written with pread/pwrite
+  int db_fd_;
+  bool direct_io_;
+  std::atomic<int> num_writes_;
+
  private:
+  /** The database file grows by whole extents of this many bytes. */
+  static constexpr size_t EXTENT_SIZE = 64 * PAGE_SIZE;
+
   int GetFileSize(const std::string &file_name);
+  /** Write size bytes at offset, going through an aligned bounce buffer if direct I/O requires it. */
+  void WriteAt(size_t offset, const char *data, size_t size);
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
   std::string file_name_;
+  // bytes of the db file that are known to be allocated
+  std::atomic<size_t> allocated_size_;
+  // serializes growing the db file; page reads and writes take no latch
+  std::mutex allocation_latch_;
+  // cleared once the file system refused to preallocate
+  bool can_preallocate_;
   int num_flushes_;
-  int num_writes_;
   bool flush_log_;
   std::future<void> *flush_log_f_;
-  // With multiple buffer pool instances, need to protect file access
-  std::mutex db_io_latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_uring.h
+//
+// Identification: src/include/storage/disk/io_uring.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#ifdef BUSTUB_USE_IO_URING
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/macros.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace bustub {
+
+/**
+ * IoUring is a Linux io_uring instance, driven through the system calls directly so that nothing but the kernel
+ * headers is needed: a submission ring and a completion ring shared with the kernel.
+ *
+ * Requests are prepared into the submission ring and handed to the kernel together by Submit(); the kernel posts one
+ * completion per request, tagged with the request's user data. Preparing and submitting must be serialized by the
+ * caller, and completions consumed by a single thread; the two sides may run concurrently.
+ */
+class IoUring {
+ public:
+  IoUring() = default;
+
+  /** Tears down the ring; requests still in flight are abandoned. */
+  ~IoUring();
+
+  DISALLOW_COPY_AND_MOVE(IoUring);
+
+  /**
+   * Set up the rings.
+   * @param entries the number of submissions the ring holds; rounded up to a power of two by the kernel
+   * @return false if the kernel refuses to set up a ring, e.g. because it is too old or io_uring is disabled
+   */
+  bool Init(unsigned entries);
+
+  /** @return the number of completions the ring holds, which bounds the number of requests in flight */
+  unsigned GetCompletionEntries() const { return cq_entries_; }
+
+  /**
+   * Prepare a read or write of size bytes at offset of a file.
+   * @return false if the submission ring is full; Submit() empties it
+   */
+  bool PrepareReadWrite(bool is_write, int fd, char *data, unsigned size, uint64_t offset, uint64_t user_data);
+
+  /**
+   * Prepare a request that does nothing but complete.
+   * @return false if the submission ring is full; Submit() empties it
+   */
+  bool PrepareNop(uint64_t user_data);
+
+  /** Hand all prepared requests to the kernel with a single system call. */
+  void Submit();
+
+  /**
+   * Wait for the next completion and consume it.
+   * @param[out] user_data the user data of the completed request
+   * @return the result of the request: the number of bytes transferred, or a negative errno
+   */
+  int WaitCompletion(uint64_t *user_data);
+
+ private:
+  /** @return a cleared submission queue entry for the next request, or nullptr if the ring is full */
+  io_uring_sqe *NextSubmission();
+
+  int ring_fd_{-1};
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  /** Shared with the kernel, which advances the head of the submission ring and the tail of the completion ring */
+  unsigned *sq_head_{nullptr};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned sq_entries_{0};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  io_uring_cqe *cqes_{nullptr};
+  unsigned cq_mask_{0};
+  unsigned cq_entries_{0};
+  /** Requests prepared since the last Submit() */
+  unsigned num_prepared_{0};
+};
+
+}  // namespace bustub
+
+#endif
@@ -14,6 +14,7 @@
 #include <string>
 #include <vector>
 
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
@@ -32,6 +33,11 @@ namespace bustub {
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * Concurrent operations use latch crabbing: a thread latches a child before it lets go of the parent. Lookups release
+ * the parent right away. Inserts and removes keep write latches on every page that their change may propagate to, and
+ * release all of them as soon as they reach a page that is safe, i.e. one that will neither split nor underflow. The
+ * latches held so far, including root_latch_ which guards root_page_id_, are kept in the transaction's page set.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -39,8 +45,18 @@ class BPlusTree {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
+  /**
+   * Creates a new, empty B+ tree.
+   * @param name the name under which the root page id is recorded in the header page
+   * @param buffer_pool_manager the buffer pool manager
+   * @param comparator the key comparator
+   * @param leaf_max_size a leaf page splits once it holds this many entries
+   * @param internal_max_size an internal page splits once it would hold more than this many children
+   * @param header_page_id the header page recording the root page id, see UpdateRootPageId
+   */
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     page_id_t header_page_id = HEADER_PAGE_ID);
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -76,10 +92,39 @@ class BPlusTree {
 
   // read data from file and remove one by one
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
-  // expose for test purpose
+  // expose for test purpose: returns the leaf page pinned but not latched
   Page *FindLeafPage(const KeyType &key, bool leftMost = false);
 
+  /** @return the number of pages removed from the tree but not yet deleted, because an iterator still pins them */
+  size_t NumPendingDeletes() { return deletes_.NumPending(); }
+
  private:
+  /** The kind of operation a traversal is for, which decides what latches it takes and when a page is safe. */
+  enum class Operation { FIND, INSERT, DELETE };
+
+  /**
+   * Descend from the root to the leaf page that contains key, crabbing latches on the way.
+   * For FIND the leaf is returned read-latched and pinned, and the caller releases it. For INSERT and DELETE the leaf
+   * is returned write-latched; it and any unsafe ancestors are in the transaction's page set, to be released with
+   * ReleaseLatches. In that case the page set may also hold root_latch_, which is how an empty tree is reported to
+   * the caller: nullptr comes back with root_latch_ still write-latched.
+   * @return the leaf page, or nullptr if the tree is empty
+   */
+  Page *FindLeafPageLatched(const KeyType &key, Operation op, Transaction *transaction, bool left_most = false);
+
+  /** @return true if the operation cannot propagate from the page to its parent */
+  bool IsSafe(BPlusTreePage *node, Operation op) const;
+
+  /**
+   * Release every latch in the transaction's page set, unpinning the pages, then delete the pages in its deleted page
+   * set.
+   * @param is_dirty whether the released pages were modified
+   */
+  void ReleaseLatches(Transaction *transaction, bool is_dirty);
+
+  /** @return the page, pinned; throws if the buffer pool has no frame for it */
+  Page *FetchTreePage(page_id_t page_id);
+
   void StartNewTree(const KeyType &key, const ValueType &value);
 
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
@@ -112,10 +157,15 @@ class BPlusTree {
   // member variable
   std::string index_name_;
   page_id_t root_page_id_;
+  /** Protects root_page_id_. */
+  mutable ReaderWriterLatch root_latch_;
+  page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  /** The pages removed from the tree that wait for an iterator to unpin them */
+  PendingPageDeletes deletes_;
 };
 
 }  // namespace bustub
@@ -13,31 +13,65 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include "buffer/buffer_pool_manager.h"
+#include "storage/index/pending_page_deletes.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * IndexIterator walks the leaf pages of a B+ tree from left to right.
+ *
+ * The iterator keeps the current leaf pinned, but only read-latches it while it looks at it, so that it never blocks
+ * writers for longer than a single step. When a writer has moved entries around in the meantime, the iterator finds
+ * its place again by the key it last returned.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
  public:
-  // you may define your own constructor based on your member variables
-  IndexIterator();
+  /**
+   * @param bpm the buffer pool manager of the tree
+   * @param deletes the pages the tree deleted while they were pinned; the iterator unpins its leaves through it
+   * @param page the pinned leaf page to start on, or nullptr for the end iterator; the iterator takes over the pin
+   * @param index the position of the first entry within the leaf
+   * @param comparator the key comparator of the tree
+   */
+  IndexIterator(BufferPoolManager *bpm, PendingPageDeletes *deletes, Page *page, int index,
+                const KeyComparator &comparator);
   ~IndexIterator();
 
+  DISALLOW_COPY(IndexIterator);
+  IndexIterator(IndexIterator &&other) noexcept;
+
   bool IsEnd();
 
   const MappingType &operator*();
 
   IndexIterator &operator++();
 
-  bool operator==(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  bool operator==(const IndexIterator &itr) const { return page_ == itr.page_ && index_ == itr.index_; }
 
-  bool operator!=(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  bool operator!=(const IndexIterator &itr) const { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  /** Copy the entry at index_ out of the read-latched leaf, moving on to the next leaves while it is past the end. */
+  void SettleOnEntry();
+
+  /** Move the pin to the leaf page that follows the current one, or become the end iterator. */
+  void MoveToNextLeaf();
+
+  BufferPoolManager *bpm_;
+  PendingPageDeletes *deletes_;
+  /** The current leaf, pinned; nullptr once the iterator is at the end. */
+  Page *page_;
+  int index_;
+  /** The entry at index_, copied while the leaf was latched. */
+  MappingType item_;
+  KeyComparator comparator_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pending_page_deletes.h
+//
+// Identification: src/include/storage/index/pending_page_deletes.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <unordered_set>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PendingPageDeletes deletes the pages an index drops from its structure. The buffer pool does not delete a page that
+ * is pinned, e.g. the leaf an index iterator rests on, so such a page is remembered instead, and deleted when the one
+ * holding it unpins it through Unpin().
+ */
+class PendingPageDeletes {
+ public:
+  /** @param bpm the buffer pool manager of the index */
+  explicit PendingPageDeletes(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  DISALLOW_COPY_AND_MOVE(PendingPageDeletes);
+
+  /** Delete a page, or, while it is still pinned, once it is unpinned through Unpin(). */
+  void Delete(page_id_t page_id);
+
+  /** Unpin a page, deleting it if it was deleted while pinned and nobody pins it anymore. */
+  void Unpin(page_id_t page_id, bool is_dirty);
+
+  /** @return the number of deleted pages that are still pinned */
+  size_t NumPending();
+
+ private:
+  BufferPoolManager *bpm_;
+  /** Protects pending_; held while deleting, so that an unpin between a failed delete and its record is not missed */
+  std::mutex latch_;
+  std::unordered_set<page_id_t> pending_;
+};
+
+}  // namespace bustub
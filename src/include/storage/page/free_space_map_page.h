@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.h
+//
+// Identification: src/include/storage/page/free_space_map_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * A free space map page records roughly how many bytes are free in each page of a table heap, so that an insert can
+ * go straight to a page with room instead of trying every page in turn. A table heap keeps a chain of these pages,
+ * with one entry per table page, in the order of the table's page list.
+ *
+ * Entries are hints: they are refreshed whenever an insert finds a page too full or a delete frees space, but may
+ * overstate the free space of a page in between.
+ *
+ * Format (size in bytes):
+ *  ----------------------------------------------------------------------------------------------
+ *  | NextPageId (4) | EntryCount (4) | Entry_1 page_id (4) | Entry_1 free space (4) | ... |
+ *  ----------------------------------------------------------------------------------------------
+ */
+class FreeSpaceMapPage : public Page {
+ public:
+  /** The number of table pages a single map page covers. */
+  static constexpr uint32_t CAPACITY = (PAGE_SIZE - 8) / 8;
+
+  /** Initialize an empty map page that is the last one of its chain. */
+  void Init() {
+    SetNextPageId(INVALID_PAGE_ID);
+    SetEntryCount(0);
+  }
+
+  /** @return the page id of the next map page of the chain */
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  /** Set the page id of the next map page of the chain. */
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of table pages recorded in this map page */
+  uint32_t GetEntryCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_ENTRY_COUNT); }
+
+  /** @return the id of the table page at slot slot_num */
+  page_id_t GetPageIdAt(uint32_t slot_num) {
+    return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_ENTRIES + SIZE_ENTRY * slot_num);
+  }
+
+  /** @return the recorded free space of the table page at slot slot_num */
+  uint32_t GetFreeSpaceAt(uint32_t slot_num) {
+    return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_ENTRIES + SIZE_ENTRY * slot_num + sizeof(page_id_t));
+  }
+
+  /** Record the free space of the table page at slot slot_num. */
+  void SetFreeSpaceAt(uint32_t slot_num, uint32_t free_space) {
+    memcpy(GetData() + OFFSET_ENTRIES + SIZE_ENTRY * slot_num + sizeof(page_id_t), &free_space, sizeof(uint32_t));
+  }
+
+  /**
+   * Add a table page to the map.
+   * @return the slot of the new entry, or -1 if this map page is full
+   */
+  int Append(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Look for a table page with at least the given free space.
+   * @param free_space the number of bytes needed
+   * @param start_slot the slot to start looking at
+   * @return the first slot at or after start_slot with enough free space, or -1 if there is none
+   */
+  int FindFreeSpace(uint32_t free_space, uint32_t start_slot);
+
+ private:
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 0;
+  static constexpr size_t OFFSET_ENTRY_COUNT = 4;
+  static constexpr size_t OFFSET_ENTRIES = 8;
+  static constexpr size_t SIZE_ENTRY = 8;
+
+  void SetEntryCount(uint32_t entry_count) { memcpy(GetData() + OFFSET_ENTRY_COUNT, &entry_count, sizeof(uint32_t)); }
+};
+
+}  // namespace bustub
@@ -36,10 +36,12 @@ namespace bustub {
  *  ----------------------------------------------------------------------------
  *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) |
  *  ----------------------------------------------------------------------------
- *  ----------------------------------------------------------------
- *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
- *  ----------------------------------------------------------------
+ *  -------------------------------------------------------------------------------------------
+ *  | TupleCount (4) | FreeSpaceMapPageId (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
+ *  -------------------------------------------------------------------------------------------
  *
+ * FreeSpaceMapPageId is only used in the first page of a table, where it records the first page of the table's free
+ * space map (see TableHeap).
  */
 class TablePage : public Page {
  public:
@@ -72,6 +74,16 @@ class TablePage : public Page {
     memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
   }
 
+  /** @return the page id of the first page of the table's free space map, as recorded in the table's first page */
+  page_id_t GetFreeSpaceMapPageId() {
+    return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_FREE_SPACE_MAP_PAGE_ID);
+  }
+
+  /** Record the page id of the first page of the table's free space map; done in the table's first page. */
+  void SetFreeSpaceMapPageId(page_id_t free_space_map_page_id) {
+    memcpy(GetData() + OFFSET_FREE_SPACE_MAP_PAGE_ID, &free_space_map_page_id, sizeof(page_id_t));
+  }
+
   /**
    * Insert a tuple into the table.
    * @param tuple tuple to insert
@@ -122,6 +134,14 @@ class TablePage : public Page {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * Point a tuple at a tuple of this page, without copying it or taking any locks.
+   * @param rid rid of the tuple to view
+   * @param[out] tuple the tuple, which refers to the page data and is valid only as long as the data stays unchanged
+   * @return true if the tuple exists
+   */
+  bool GetTupleView(const RID &rid, Tuple *tuple);
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -137,17 +157,26 @@ class TablePage : public Page {
    */
   bool GetNextTupleRid(const RID &cur_rid, RID *next_rid);
 
+  /** The size of the header, which no tuple can use. */
+  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 28;
+  /** The size of a slot, i.e. the space a tuple takes up in addition to its own size. */
+  static constexpr size_t SIZE_TUPLE = 8;
+
+  /** @return the number of bytes left for new tuples and their slots */
+  uint32_t GetFreeSpaceRemaining() {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
  private:
   static_assert(sizeof(page_id_t) == 4);
 
-  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
-  static constexpr size_t SIZE_TUPLE = 8;
   static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
   static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
   static constexpr size_t OFFSET_FREE_SPACE = 16;
   static constexpr size_t OFFSET_TUPLE_COUNT = 20;
-  static constexpr size_t OFFSET_TUPLE_OFFSET = 24;  // Naming things is hard.
-  static constexpr size_t OFFSET_TUPLE_SIZE = 28;
+  static constexpr size_t OFFSET_FREE_SPACE_MAP_PAGE_ID = 24;
+  static constexpr size_t OFFSET_TUPLE_OFFSET = 28;  // Naming things is hard.
+  static constexpr size_t OFFSET_TUPLE_SIZE = 32;
 
   /** @return pointer to the end of the current free space, see header comment */
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
@@ -166,10 +195,6 @@ class TablePage : public Page {
   /** Set the number of tuples in this page. */
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  uint32_t GetFreeSpaceRemaining() {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
-
   /** @return tuple offset at slot slot_num */
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
@@ -1,32 +1,85 @@
 #pragma once
 
+#include <cstring>
+
 #include "storage/page/page.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
-// existing functions exactly as they are! It may be helpful to look at TablePage.
-// Remember that this task is optional, you get full credit if you finish the next task.
-
 /**
+ * TmpTuplePage holds tuples that an executor writes out and reads back during one query, such as the partitions a
+ * hash join spills. Tuples are only ever appended, from the end of the page towards its header, and never updated.
+ *
  * TmpTuplePage format:
  *
  * Sizes are in bytes.
  * | PageId (4) | LSN (4) | FreeSpace (4) | (free space) | TupleSize2 | TupleData2 | TupleSize1 | TupleData1 |
  *
- * We choose this format because DeserializeExpression expects to read Size followed by Data.
+ * We choose this format because DeserializeExpression expects to read Size followed by Data. FreeSpace is the offset
+ * at which the last inserted tuple starts.
  */
 class TmpTuplePage : public Page {
  public:
-  void Init(page_id_t page_id, uint32_t page_size) {}
+  /**
+   * Initialize the TmpTuplePage header.
+   * @param page_id the page ID of this page
+   * @param page_size the size of this page
+   */
+  void Init(page_id_t page_id, uint32_t page_size) {
+    memcpy(GetData(), &page_id, sizeof(page_id_t));
+    SetFreeSpacePointer(page_size);
+  }
+
+  /** @return the page ID of this page */
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
 
-  page_id_t GetTablePageId() { return INVALID_PAGE_ID; }
+  /** @return the offset at which the last inserted tuple starts; the page size if there is none */
+  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
-  bool Insert(const Tuple &tuple, TmpTuple *out) { return false; }
+  /**
+   * Insert a tuple into the page.
+   * @param tuple the tuple to insert
+   * @param[out] out where the tuple was stored
+   * @return false if the tuple does not fit into the page
+   */
+  bool Insert(const Tuple &tuple, TmpTuple *out) {
+    uint32_t size = sizeof(uint32_t) + tuple.GetLength();
+    uint32_t free_space_pointer = GetFreeSpacePointer();
+    if (free_space_pointer < SIZE_TMP_TUPLE_PAGE_HEADER + size) {
+      return false;
+    }
+    free_space_pointer -= size;
+    tuple.SerializeTo(GetData() + free_space_pointer);
+    SetFreeSpacePointer(free_space_pointer);
+    *out = TmpTuple(GetTablePageId(), free_space_pointer);
+    return true;
+  }
+
+  /**
+   * Read a tuple back from the page.
+   * @param offset the offset of the tuple, as returned by Insert()
+   * @param[out] tuple the tuple
+   * @return the offset of the tuple inserted before it; the page size if there is none
+   */
+  size_t Get(size_t offset, Tuple *tuple) {
+    tuple->DeserializeFrom(GetData() + offset);
+    return offset + sizeof(uint32_t) + tuple->GetLength();
+  }
+
+  /** The size of the header in bytes, and the largest tuple a page of the given size can hold */
+  static constexpr size_t SIZE_TMP_TUPLE_PAGE_HEADER = 12;
+  static constexpr size_t MaxTupleSize(size_t page_size) {
+    return page_size - SIZE_TMP_TUPLE_PAGE_HEADER - sizeof(uint32_t);
+  }
 
  private:
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
+
+  static constexpr size_t OFFSET_FREE_SPACE = 8;
   static_assert(sizeof(page_id_t) == 4);
 };
 
@@ -12,8 +12,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
+#include "storage/page/free_space_map_page.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
@@ -23,6 +29,11 @@ namespace bustub {
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * A free space map (see FreeSpaceMapPage) records how much room each page has, so an insert goes to the page the
+ * previous insert used, or else straight to the first page the map says has room, or else to a new page at the end.
+ * As pages enter the map in list order, the map doubles as a page directory that lets a scan start at any page.
+ * The first table page records where the map starts, so a reopened table reads the map it already has.
  */
 class TableHeap {
   friend class TableIterator;
@@ -36,6 +47,9 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param first_page_id the id of the first page
+   *
+   * The free space map is read from the pages the first page points to. If there is none, e.g. because the first page
+   * was written before the map existed, the map is rebuilt from the table pages.
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
             page_id_t first_page_id);
@@ -108,11 +122,67 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /** @return the id of the first page of the free space map of this table */
+  page_id_t GetFreeSpaceMapPageId() {
+    std::scoped_lock lock(fsm_latch_);
+    return fsm_page_ids_.front();
+  }
+
+  /** @return the ids of the pages of this table, in list order, as of now */
+  std::vector<page_id_t> GetPageDirectory() {
+    std::scoped_lock lock(fsm_latch_);
+    return page_directory_;
+  }
+
  private:
+  /**
+   * Insert the tuple into a page that already belongs to the table.
+   * @return false if the page had no room, or could not be fetched
+   */
+  bool InsertIntoPage(page_id_t page_id, const Tuple &tuple, RID *rid, Transaction *txn);
+
+  /** Append a new page to the table and insert the tuple into it. */
+  bool InsertIntoNewPage(const Tuple &tuple, RID *rid, Transaction *txn);
+
+  /**
+   * Look for a page that the free space map says has room.
+   * @param free_space the number of bytes needed
+   * @return the first such page, or INVALID_PAGE_ID if there is none
+   */
+  page_id_t FindPageWithFreeSpace(uint32_t free_space);
+
+  /** Record the free space of a table page in the map. */
+  void RecordFreeSpace(page_id_t page_id, uint32_t free_space);
+
+  /** Add a table page at the end of the map; the caller holds extend_latch_. */
+  void AppendToFreeSpaceMap(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Read the map, starting with its first page, into the in-memory bookkeeping.
+   * @return false if the pages do not hold a map of this table; the bookkeeping is then incomplete
+   */
+  bool LoadFreeSpaceMap(page_id_t free_space_map_page_id);
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+
+  /** Protects the in-memory bookkeeping of the free space map below. */
+  std::mutex fsm_latch_;
+  /** The pages of the free space map, in chain order. */
+  std::vector<page_id_t> fsm_page_ids_;
+  /** Table page id -> its slot in the map, counting across the map pages. */
+  std::unordered_map<page_id_t, size_t> fsm_slots_;
+  /** Slot in the map -> table page id, which is the list order of the pages. */
+  std::vector<page_id_t> page_directory_;
+  /** Every page in a slot before this one was found to be full; searches start here. */
+  size_t search_start_{0};
+  /** Serializes adding pages to the table, and protects last_page_id_. */
+  std::mutex extend_latch_;
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  /** The page the last insert went to, tried first by the next one. */
+  std::atomic<page_id_t> last_insert_page_id_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
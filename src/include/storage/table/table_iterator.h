@@ -13,9 +13,11 @@
 #pragma once
 
 #include <cassert>
+#include <memory>
 
 #include "common/rid.h"
 #include "concurrency/transaction.h"
+#include "storage/page/table_page.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -24,6 +26,14 @@ class TableHeap;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
+ *
+ * The iterator works a page at a time: when it moves to a page it copies the page out of the buffer pool under the
+ * page's read latch, and then walks the slots of that copy. The tuples it hands out are views into the copy, valid
+ * until the iterator moves on; copying a tuple materializes it. Moving to the next page is the only time the iterator
+ * touches the buffer pool, so a scan costs no latching, pinning or allocation per tuple.
+ *
+ * The copy is a snapshot: changes made to the page after the iterator got there are not seen. The iterator keeps no
+ * latch on the page it reads, since holding one while the caller waits for tuple locks could deadlock with writers.
  */
 class TableIterator {
   friend class Cursor;
@@ -31,12 +41,13 @@ class TableIterator {
  public:
   TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
 
-  TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+  TableIterator(const TableIterator &other);
 
-  ~TableIterator() { delete tuple_; }
+  TableIterator(TableIterator &&other) = default;
 
-  inline bool operator==(const TableIterator &itr) const { return tuple_->rid_.Get() == itr.tuple_->rid_.Get(); }
+  ~TableIterator() = default;
+
+  inline bool operator==(const TableIterator &itr) const { return tuple_.rid_.Get() == itr.tuple_.rid_.Get(); }
 
   inline bool operator!=(const TableIterator &itr) const { return !(*this == itr); }
 
@@ -48,17 +59,23 @@ class TableIterator {
 
   TableIterator operator++(int);
 
-  TableIterator &operator=(const TableIterator &other) {
-    table_heap_ = other.table_heap_;
-    *tuple_ = *other.tuple_;
-    txn_ = other.txn_;
-    return *this;
-  }
+  TableIterator &operator=(const TableIterator &other);
+
+  TableIterator &operator=(TableIterator &&other) = default;
 
  private:
+  /** Copy the page out of the buffer pool into page_. */
+  void LoadPage(page_id_t page_id);
+
+  /** Point tuple_ at the tuple with the given rid in page_, or make this the end iterator for an invalid rid. */
+  void SetTuple(const RID &rid);
+
   TableHeap *table_heap_;
-  Tuple *tuple_;
+  /** A view into page_. */
+  Tuple tuple_;
   Transaction *txn_;
+  /** The copy of the page the iterator is on; nullptr for the end iterator. */
+  std::unique_ptr<TablePage> page_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_file.h
+//
+// Identification: src/include/storage/table/tmp_tuple_file.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TmpTupleFile is a sequence of TmpTuplePages in the buffer pool that an executor writes tuples to and then reads them
+ * back from, in the order they were written, e.g. to spill what does not fit into its memory. The buffer pool writes
+ * the pages to disk if it needs their frames; they are deleted with the file.
+ *
+ * Only the page being written is kept pinned. A page being read is copied out and unpinned as soon as it is reached.
+ */
+class TmpTupleFile {
+ public:
+  /** @param bpm the buffer pool to hold the pages in */
+  explicit TmpTupleFile(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  ~TmpTupleFile();
+
+  DISALLOW_COPY_AND_MOVE(TmpTupleFile);
+
+  /**
+   * Append a tuple to the file. Throws OUT_OF_MEMORY if the buffer pool has no frame for a new page, and OUT_OF_RANGE
+   * if the tuple does not fit into a page.
+   */
+  void Append(const Tuple &tuple);
+
+  /** Start reading from the first tuple; this ends appending. */
+  void Rewind();
+
+  /**
+   * Read the next tuple.
+   * @param[out] tuple the next tuple
+   * @return false if all tuples have been read
+   */
+  bool Next(Tuple *tuple);
+
+  /** @return the number of tuples in the file */
+  size_t NumTuples() const { return num_tuples_; }
+
+  /** @return the number of pages in the file */
+  size_t NumPages() const { return page_ids_.size(); }
+
+ private:
+  /** Unpin the page being written, if any. */
+  void FinishPage();
+
+  BufferPoolManager *bpm_;
+  std::vector<page_id_t> page_ids_;
+  /** The last page, while it is being written */
+  TmpTuplePage *write_page_{nullptr};
+  size_t num_tuples_{0};
+  /** The tuples of the page being read, in the order they were written, and the next one to hand out */
+  std::vector<Tuple> read_tuples_;
+  size_t read_idx_{0};
+  /** The next page to read */
+  size_t read_page_idx_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,222 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_manager.cpp
+//
+// Identification: src/storage/disk/async_disk_manager.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/async_disk_manager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "common/logger.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+AsyncDiskManager::AsyncDiskManager(const std::string &db_file, bool direct_io, size_t num_threads, bool io_uring)
+    : DiskManager(db_file, direct_io) {
+#ifdef BUSTUB_USE_IO_URING
+  if (io_uring) {
+    ring_ = std::make_unique<IoUring>();
+    if (ring_->Init(IO_URING_ENTRIES)) {
+      reaper_ = std::thread(&AsyncDiskManager::ReapCompletions, this);
+      return;
+    }
+    // e.g. a kernel without io_uring, or one that forbids it
+    LOG_WARN("io_uring is unavailable, falling back to worker threads");
+    ring_.reset();
+  }
+#endif
+  for (size_t i = 0; i < std::max<size_t>(num_threads, 1); i++) {
+    workers_.emplace_back(&AsyncDiskManager::WorkerLoop, this);
+  }
+}
+
+AsyncDiskManager::~AsyncDiskManager() { StopThreads(); }
+
+void AsyncDiskManager::ShutDown() {
+  StopThreads();
+  DiskManager::ShutDown();
+}
+
+bool AsyncDiskManager::UsesIoUring() const {
+#ifdef BUSTUB_USE_IO_URING
+  return ring_ != nullptr;
+#else
+  return false;
+#endif
+}
+
+void AsyncDiskManager::SubmitRequests(std::vector<DiskRequest> *requests) {
+  if (requests->empty()) {
+    return;
+  }
+  {
+    std::scoped_lock lock(latch_);
+    BUSTUB_ASSERT(!stopped_, "requests submitted after shutdown");
+    in_flight_ += requests->size();
+  }
+#ifdef BUSTUB_USE_IO_URING
+  if (ring_ != nullptr) {
+    std::unique_lock submit_lock(submit_latch_);
+    for (auto &request : *requests) {
+      auto ring_request = std::make_unique<RingRequest>();
+      ring_request->request_ = std::move(request);
+      PrepareOnRing(&submit_lock, std::move(ring_request));
+    }
+    // one system call for the whole batch, unless it did not fit into the ring at once
+    ring_->Submit();
+    requests->clear();
+    return;
+  }
+#endif
+  {
+    std::scoped_lock lock(latch_);
+    for (auto &request : *requests) {
+      queue_.push_back(std::move(request));
+    }
+  }
+  // wake up only as many workers as there is work for
+  for (size_t i = 0; i < requests->size(); i++) {
+    queue_cv_.notify_one();
+  }
+  requests->clear();
+}
+
+void AsyncDiskManager::Perform(DiskRequest *request) {
+  if (request->is_write_) {
+    WritePage(request->page_id_, request->data_);
+  } else {
+    ReadPage(request->page_id_, request->data_);
+  }
+  if (request->callback_) {
+    request->callback_();
+  }
+  std::scoped_lock lock(latch_);
+  if (--in_flight_ == 0) {
+    idle_cv_.notify_all();
+  }
+}
+
+void AsyncDiskManager::WorkerLoop() {
+  std::unique_lock lock(latch_);
+  while (true) {
+    queue_cv_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    DiskRequest request = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    Perform(&request);
+    lock.lock();
+  }
+}
+
+#ifdef BUSTUB_USE_IO_URING
+void AsyncDiskManager::PrepareOnRing(std::unique_lock<std::mutex> *submit_lock,
+                                     std::unique_ptr<RingRequest> ring_request) {
+  DiskRequest &request = ring_request->request_;
+  char *data = request.data_;
+  // The kernel requires aligned buffers for O_DIRECT.
+  if (direct_io_ && reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT != 0) {
+    ring_request->bounce_.reset(static_cast<char *>(aligned_alloc(PAGE_SIZE, PAGE_SIZE)));
+    data = ring_request->bounce_.get();
+    if (request.is_write_) {
+      memcpy(data, request.data_, PAGE_SIZE);
+    }
+  }
+  size_t offset = static_cast<size_t>(request.page_id_) * PAGE_SIZE;
+  if (request.is_write_) {
+    EnsureAllocated(offset + PAGE_SIZE);
+    num_writes_ += 1;
+  }
+  // Requests beyond what the completion ring holds would have their completions held back by the kernel, so they wait
+  // for room instead. Whatever was prepared so far is submitted first, or no room might ever be made.
+  if (ring_in_flight_ == ring_->GetCompletionEntries()) {
+    ring_->Submit();
+    ring_space_cv_.wait(*submit_lock, [this] { return ring_in_flight_ < ring_->GetCompletionEntries(); });
+  }
+  auto user_data = reinterpret_cast<uint64_t>(ring_request.get());
+  while (!ring_->PrepareReadWrite(request.is_write_, db_fd_, data, PAGE_SIZE, offset, user_data)) {
+    // The submission ring is full: hand what it holds to the kernel and retry.
+    ring_->Submit();
+  }
+  ring_in_flight_++;
+  // The reaper owns the request from here on.
+  ring_request.release();
+}
+
+void AsyncDiskManager::ReapCompletions() {
+  while (true) {
+    uint64_t user_data;
+    int result = ring_->WaitCompletion(&user_data);
+    if (user_data == 0) {
+      // the shutdown sentinel
+      return;
+    }
+    std::unique_ptr<RingRequest> ring_request(reinterpret_cast<RingRequest *>(user_data));
+    {
+      std::scoped_lock submit_lock(submit_latch_);
+      ring_in_flight_--;
+    }
+    ring_space_cv_.notify_one();
+    DiskRequest &request = ring_request->request_;
+    if (result == PAGE_SIZE) {
+      if (!request.is_write_ && ring_request->bounce_ != nullptr) {
+        memcpy(request.data_, ring_request->bounce_.get(), PAGE_SIZE);
+      }
+    } else if (request.is_write_) {
+      // a short or failed write: finish it the synchronous way, which counts it again
+      num_writes_ -= 1;
+      WritePage(request.page_id_, request.data_);
+    } else {
+      // a short read, e.g. of a page past the end of the file, which the synchronous way reads as zeros
+      ReadPage(request.page_id_, request.data_);
+    }
+    if (request.callback_) {
+      request.callback_();
+    }
+    std::scoped_lock lock(latch_);
+    if (--in_flight_ == 0) {
+      idle_cv_.notify_all();
+    }
+  }
+}
+#endif
+
+void AsyncDiskManager::StopThreads() {
+  {
+    std::unique_lock lock(latch_);
+    if (stopped_) {
+      return;
+    }
+    idle_cv_.wait(lock, [this] { return in_flight_ == 0; });
+    stopped_ = true;
+  }
+  queue_cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+#ifdef BUSTUB_USE_IO_URING
+  if (ring_ != nullptr) {
+    {
+      // Nothing is in flight, so the sentinel is the last completion the reaper sees.
+      std::scoped_lock submit_lock(submit_latch_);
+      ring_->PrepareNop(0);
+      ring_->Submit();
+    }
+    reaper_.join();
+    ring_.reset();
+  }
+#endif
+}
+
+}  // namespace bustub
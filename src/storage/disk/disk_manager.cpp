@@ -10,13 +10,19 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <cassert>
+#include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -29,9 +35,18 @@ static char *buffer_used;
 /**
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
+ * @input direct_io: open the database file with O_DIRECT
  */
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io)
+    : db_fd_(-1),
+      direct_io_(direct_io),
+      num_writes_(0),
+      file_name_(db_file),
+      allocated_size_(0),
+      can_preallocate_(true),
+      num_flushes_(0),
+      flush_log_(false),
+      flush_log_f_(nullptr) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -53,30 +68,40 @@ DiskManager::DiskManager(const std::string &db_file)
     }
   }
 
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
+  int flags = O_RDWR | O_CREAT;
+  if (direct_io_) {
+    db_fd_ = open(db_file.c_str(), flags | O_DIRECT, 0644);
+    if (db_fd_ < 0 && errno == EINVAL) {
+      LOG_WARN("file system does not support O_DIRECT, falling back to buffered I/O");
+      direct_io_ = false;
     }
   }
+  if (db_fd_ < 0) {
+    db_fd_ = open(db_file.c_str(), flags, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  if (fstat(db_fd_, &stat_buf) == 0) {
+    allocated_size_ = stat_buf.st_size;
+  }
   buffer_used = nullptr;
 }
 
+DiskManager::~DiskManager() {
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
+}
+
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  {
-    std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.close();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
   }
   log_io_.close();
 }
@@ -85,47 +110,114 @@ void DiskManager::ShutDown() {
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
-  // set write cursor to offset
-  num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG_DEBUG("I/O error while writing");
-    return;
-  }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  WriteAt(static_cast<size_t>(page_id) * PAGE_SIZE, page_data, PAGE_SIZE);
+}
+
+/**
+ * Write the contents of consecutive pages into disk file with one write
+ */
+void DiskManager::WritePages(page_id_t first_page_id, size_t num_pages, const char *page_data) {
+  WriteAt(static_cast<size_t>(first_page_id) * PAGE_SIZE, page_data, num_pages * PAGE_SIZE);
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    if (db_io_.bad()) {
+  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+  std::unique_ptr<char, decltype(&free)> bounce(nullptr, &free);
+  char *target = page_data;
+  if (direct_io_ && reinterpret_cast<uintptr_t>(page_data) % DIRECT_IO_ALIGNMENT != 0) {
+    bounce.reset(static_cast<char *>(aligned_alloc(PAGE_SIZE, PAGE_SIZE)));
+    target = bounce.get();
+  }
+  size_t read_count = 0;
+  while (read_count < static_cast<size_t>(PAGE_SIZE)) {
+    ssize_t n = pread(db_fd_, target + read_count, PAGE_SIZE - read_count, offset + read_count);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
       LOG_DEBUG("I/O error while reading");
-      return;
+      break;
+    }
+    if (n == 0) {
+      break;
+    }
+    read_count += n;
+  }
+  // a page that was allocated but never written back, or lies past the end of the file, reads as zeros
+  if (read_count < static_cast<size_t>(PAGE_SIZE)) {
+    memset(target + read_count, 0, PAGE_SIZE - read_count);
+  }
+  if (target != page_data) {
+    memcpy(page_data, target, PAGE_SIZE);
+  }
+}
+
+/**
+ * Perform a batch of page requests synchronously, running each callback as its request completes
+ */
+void DiskManager::SubmitRequests(std::vector<DiskRequest> *requests) {
+  for (auto &request : *requests) {
+    if (request.is_write_) {
+      WritePage(request.page_id_, request.data_);
+    } else {
+      ReadPage(request.page_id_, request.data_);
+    }
+    if (request.callback_) {
+      request.callback_();
+    }
+  }
+  requests->clear();
+}
+
+/**
+ * Read a page through SubmitRequests, returning a future for its completion
+ */
+std::future<void> DiskManager::ReadPageAsync(page_id_t page_id, char *page_data) {
+  auto done = std::make_shared<std::promise<void>>();
+  std::future<void> future = done->get_future();
+  std::vector<DiskRequest> requests{{false, page_id, page_data, [done] { done->set_value(); }}};
+  SubmitRequests(&requests);
+  return future;
+}
+
+/**
+ * Write a page through SubmitRequests, returning a future for its completion
+ */
+std::future<void> DiskManager::WritePageAsync(page_id_t page_id, const char *page_data) {
+  auto done = std::make_shared<std::promise<void>>();
+  std::future<void> future = done->get_future();
+  // the data is only read from; DiskRequest uses one buffer type for both directions
+  std::vector<DiskRequest> requests{{true, page_id, const_cast<char *>(page_data), [done] { done->set_value(); }}};
+  SubmitRequests(&requests);
+  return future;
+}
+
+/**
+ * Private helper function to write at an offset of the db file
+ */
+void DiskManager::WriteAt(size_t offset, const char *data, size_t size) {
+  EnsureAllocated(offset + size);
+  std::unique_ptr<char, decltype(&free)> bounce(nullptr, &free);
+  if (direct_io_ && reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT != 0) {
+    bounce.reset(static_cast<char *>(aligned_alloc(PAGE_SIZE, size)));
+    memcpy(bounce.get(), data, size);
+    data = bounce.get();
+  }
+  num_writes_ += 1;
+  size_t written = 0;
+  while (written < size) {
+    ssize_t n = pwrite(db_fd_, data + written, size - written, offset + written);
+    if (n < 0 && errno == EINTR) {
+      continue;
     }
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+    if (n <= 0) {
+      LOG_DEBUG("I/O error while writing");
+      return;
     }
+    written += n;
   }
 }
 
@@ -206,6 +298,27 @@ int DiskManager::GetNumWrites() const { return num_writes_; }
  */
 bool DiskManager::GetFlushState() const { return flush_log_; }
 
+/**
+ * Private helper function to grow the db file by whole extents
+ */
+void DiskManager::EnsureAllocated(size_t end) {
+  if (end <= allocated_size_) {
+    return;
+  }
+  std::scoped_lock scoped_allocation_latch(allocation_latch_);
+  size_t allocated_size = allocated_size_;
+  if (end <= allocated_size) {
+    return;
+  }
+  size_t new_size = (end + EXTENT_SIZE - 1) / EXTENT_SIZE * EXTENT_SIZE;
+  if (!can_preallocate_ || posix_fallocate(db_fd_, allocated_size, new_size - allocated_size) != 0) {
+    // Not every file system can preallocate; the write itself still extends the file.
+    can_preallocate_ = false;
+    new_size = end;
+  }
+  allocated_size_ = new_size;
+}
+
 /**
  * Private helper function to get disk file size
  */
@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// io_uring.cpp
+//
+// Identification: src/storage/disk/io_uring.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#ifdef BUSTUB_USE_IO_URING
+
+#include "storage/disk/io_uring.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+/** @return the address of a field at offset bytes into a mapped ring */
+template <typename T>
+T *RingField(void *ring, uint32_t offset) {
+  return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+}
+
+int IoUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+/** Fail on an error of io_uring_enter other than being interrupted or asked to retry. */
+void CheckTransientError() {
+  if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+    // Only a broken ring fails otherwise, and nothing in flight could be trusted to complete anymore.
+    UNREACHABLE("io_uring_enter failed");
+  }
+}
+
+}  // namespace
+
+IoUring::~IoUring() {
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+  }
+}
+
+bool IoUring::Init(unsigned entries) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (ring_fd_ < 0) {
+    return false;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  // Newer kernels map both rings with a single mmap.
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  void *sq_ring =
+      mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ring == MAP_FAILED) {
+    return false;
+  }
+  sq_ring_ = sq_ring;
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    void *cq_ring =
+        mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ring == MAP_FAILED) {
+      return false;
+    }
+    cq_ring_ = cq_ring;
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+  sq_head_ = RingField<unsigned>(sq_ring_, params.sq_off.head);
+  sq_tail_ = RingField<unsigned>(sq_ring_, params.sq_off.tail);
+  sq_array_ = RingField<unsigned>(sq_ring_, params.sq_off.array);
+  sq_mask_ = *RingField<unsigned>(sq_ring_, params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+  cq_head_ = RingField<unsigned>(cq_ring_, params.cq_off.head);
+  cq_tail_ = RingField<unsigned>(cq_ring_, params.cq_off.tail);
+  cqes_ = RingField<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+  cq_mask_ = *RingField<unsigned>(cq_ring_, params.cq_off.ring_mask);
+  cq_entries_ = params.cq_entries;
+  return true;
+}
+
+io_uring_sqe *IoUring::NextSubmission() {
+  // Only we move the tail; the kernel moves the head as it consumes entries.
+  unsigned tail = *sq_tail_;
+  if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) == sq_entries_) {
+    return nullptr;
+  }
+  unsigned index = tail & sq_mask_;
+  io_uring_sqe *sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  return sqe;
+}
+
+bool IoUring::PrepareReadWrite(bool is_write, int fd, char *data, unsigned size, uint64_t offset,
+                               uint64_t user_data) {
+  io_uring_sqe *sqe = NextSubmission();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = is_write ? IORING_OP_WRITE : IORING_OP_READ;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(data);
+  sqe->len = size;
+  sqe->off = offset;
+  sqe->user_data = user_data;
+  // The entry must be complete before the kernel can see the new tail.
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+  num_prepared_++;
+  return true;
+}
+
+bool IoUring::PrepareNop(uint64_t user_data) {
+  io_uring_sqe *sqe = NextSubmission();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_NOP;
+  sqe->user_data = user_data;
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+  num_prepared_++;
+  return true;
+}
+
+void IoUring::Submit() {
+  while (num_prepared_ > 0) {
+    int submitted = IoUringEnter(ring_fd_, num_prepared_, 0, 0);
+    if (submitted < 0) {
+      CheckTransientError();
+      continue;
+    }
+    num_prepared_ -= submitted;
+  }
+}
+
+int IoUring::WaitCompletion(uint64_t *user_data) {
+  // Only we move the head; the kernel moves the tail as it posts completions.
+  unsigned head = *cq_head_;
+  while (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+    if (IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0) {
+      CheckTransientError();
+    }
+  }
+  const io_uring_cqe &cqe = cqes_[head & cq_mask_];
+  *user_data = cqe.user_data;
+  int result = cqe.res;
+  // The entry has been read before the kernel may reuse it.
+  __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+  return result;
+}
+
+}  // namespace bustub
+
+#endif
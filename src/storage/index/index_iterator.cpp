@@ -7,24 +7,84 @@
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator() = default;
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, PendingPageDeletes *deletes, Page *page, int index,
+                                  const KeyComparator &comparator)
+    : bpm_(bpm), deletes_(deletes), page_(page), index_(index), comparator_(comparator) {
+  if (page_ != nullptr) {
+    page_->RLatch();
+    SettleOnEntry();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::~IndexIterator() {
+  if (page_ != nullptr) {
+    deletes_->Unpin(page_->GetPageId(), false);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : bpm_(other.bpm_),
+      deletes_(other.deletes_),
+      page_(other.page_),
+      index_(other.index_),
+      item_(other.item_),
+      comparator_(other.comparator_) {
+  other.page_ = nullptr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEXITERATOR_TYPE::IsEnd() { return page_ == nullptr; }
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;
+const MappingType &INDEXITERATOR_TYPE::operator*() {
+  assert(page_ != nullptr);
+  return item_;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-bool INDEXITERATOR_TYPE::IsEnd() { throw std::runtime_error("unimplemented"); }
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
+  assert(page_ != nullptr);
+  page_->RLatch();
+  auto *leaf = reinterpret_cast<LeafPage *>(page_->GetData());
+  // A writer may have shifted the entries since the last step; find the first key after the one returned last.
+  index_ = leaf->KeyIndex(item_.first, comparator_);
+  if (index_ < leaf->GetSize() && comparator_(leaf->KeyAt(index_), item_.first) == 0) {
+    index_++;
+  }
+  SettleOnEntry();
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-const MappingType &INDEXITERATOR_TYPE::operator*() { throw std::runtime_error("unimplemented"); }
+void INDEXITERATOR_TYPE::SettleOnEntry() {
+  while (page_ != nullptr) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page_->GetData());
+    if (index_ < leaf->GetSize()) {
+      item_ = leaf->GetItem(index_);
+      page_->RUnlatch();
+      return;
+    }
+    MoveToNextLeaf();
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() { throw std::runtime_error("unimplemented"); }
+void INDEXITERATOR_TYPE::MoveToNextLeaf() {
+  page_id_t next_page_id = reinterpret_cast<LeafPage *>(page_->GetData())->GetNextPageId();
+  Page *next_page = next_page_id == INVALID_PAGE_ID ? nullptr : bpm_->FetchPage(next_page_id);
+  // A remove latches a leaf and then its left sibling, so the next leaf must not be latched while holding this one.
+  // The pin keeps the next leaf from being reused even if a merge empties it in between.
+  page_->RUnlatch();
+  deletes_->Unpin(page_->GetPageId(), false);
+  page_ = next_page;
+  index_ = 0;
+  if (page_ != nullptr) {
+    page_->RLatch();
+  }
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
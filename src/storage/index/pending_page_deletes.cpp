@@ -0,0 +1,36 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pending_page_deletes.cpp
+//
+// Identification: src/storage/index/pending_page_deletes.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/pending_page_deletes.h"
+
+namespace bustub {
+
+void PendingPageDeletes::Delete(page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  if (!bpm_->DeletePage(page_id)) {
+    pending_.insert(page_id);
+  }
+}
+
+void PendingPageDeletes::Unpin(page_id_t page_id, bool is_dirty) {
+  bpm_->UnpinPage(page_id, is_dirty);
+  std::scoped_lock lock(latch_);
+  // another pin may still hold the page, in which case its unpin deletes it
+  if (pending_.count(page_id) != 0 && bpm_->DeletePage(page_id)) {
+    pending_.erase(page_id);
+  }
+}
+
+size_t PendingPageDeletes::NumPending() {
+  std::scoped_lock lock(latch_);
+  return pending_.size();
+}
+
+}  // namespace bustub
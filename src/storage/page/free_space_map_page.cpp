@@ -0,0 +1,36 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.cpp
+//
+// Identification: src/storage/page/free_space_map_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/free_space_map_page.h"
+
+namespace bustub {
+
+int FreeSpaceMapPage::Append(page_id_t page_id, uint32_t free_space) {
+  uint32_t slot_num = GetEntryCount();
+  if (slot_num == CAPACITY) {
+    return -1;
+  }
+  memcpy(GetData() + OFFSET_ENTRIES + SIZE_ENTRY * slot_num, &page_id, sizeof(page_id_t));
+  SetFreeSpaceAt(slot_num, free_space);
+  SetEntryCount(slot_num + 1);
+  return static_cast<int>(slot_num);
+}
+
+int FreeSpaceMapPage::FindFreeSpace(uint32_t free_space, uint32_t start_slot) {
+  uint32_t entry_count = GetEntryCount();
+  for (uint32_t i = start_slot; i < entry_count; i++) {
+    if (GetFreeSpaceAt(i) >= free_space) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+}  // namespace bustub
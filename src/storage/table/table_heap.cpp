@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 
 #include "common/logger.h"
@@ -22,7 +23,36 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id) {
+  auto first_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  BUSTUB_ASSERT(first_page != nullptr, "Couldn't fetch a page of the table heap.");
+  first_page->RLatch();
+  // A first page that never made it to disk reads as zeros, and so does its map page id.
+  page_id_t map_page_id =
+      first_page->GetTablePageId() == first_page_id_ ? first_page->GetFreeSpaceMapPageId() : INVALID_PAGE_ID;
+  first_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(first_page_id_, false);
+  if (map_page_id != INVALID_PAGE_ID && map_page_id != first_page_id_ && LoadFreeSpaceMap(map_page_id)) {
+    return;
+  }
+  // Rebuild the free space map from the table pages, and record the new one in the first page.
+  fsm_page_ids_.clear();
+  fsm_slots_.clear();
+  page_directory_.clear();
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the table heap.");
+    page->RLatch();
+    uint32_t free_space = page->GetFreeSpaceRemaining();
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    AppendToFreeSpaceMap(page_id, free_space);
+    last_page_id_ = page_id;
+    page_id = next_page_id;
+  }
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
                      Transaction *txn)
@@ -32,61 +62,232 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
   BUSTUB_ASSERT(first_page != nullptr, "Couldn't create a page for the table heap.");
   first_page->WLatch();
   first_page->Init(first_page_id_, PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  uint32_t free_space = first_page->GetFreeSpaceRemaining();
   first_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  AppendToFreeSpaceMap(first_page_id_, free_space);
+  last_page_id_ = first_page_id_;
 }
 
 bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
-  if (tuple.size_ + 32 > PAGE_SIZE) {  // larger than one page size
+  if (tuple.size_ + TablePage::SIZE_TABLE_PAGE_HEADER + TablePage::SIZE_TUPLE > PAGE_SIZE) {  // larger than one page
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  if (cur_page == nullptr) {
+  // Insert into the page the last insert went to if it still has room, else into the first page the free space map
+  // knows to have enough space. If no such page exists, create a new page and insert into that.
+  // Every failed attempt corrects the map, so no page is tried twice. A page that cannot be fetched aborts the
+  // transaction.
+  const uint32_t free_space = tuple.size_ + TablePage::SIZE_TUPLE;
+  page_id_t page_id = last_insert_page_id_;
+  bool inserted = page_id != INVALID_PAGE_ID && InsertIntoPage(page_id, tuple, rid, txn);
+  while (!inserted && txn->GetState() != TransactionState::ABORTED &&
+         (page_id = FindPageWithFreeSpace(free_space)) != INVALID_PAGE_ID) {
+    inserted = InsertIntoPage(page_id, tuple, rid, txn);
+  }
+  if (!inserted && (txn->GetState() == TransactionState::ABORTED || !InsertIntoNewPage(tuple, rid, txn))) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
+  // Update the transaction's write set.
+  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+  return true;
+}
 
+bool TableHeap::InsertIntoPage(page_id_t page_id, const Tuple &tuple, RID *rid, Transaction *txn) {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  page->WLatch();
+  bool inserted = page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_);
+  uint32_t free_space = page->GetFreeSpaceRemaining();
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, inserted);
+  if (inserted) {
+    // The map is left alone while a page fills up; it learns of the page's state once an insert fails on it.
+    last_insert_page_id_ = page_id;
+  } else {
+    RecordFreeSpace(page_id, free_space);
+  }
+  return inserted;
+}
+
+bool TableHeap::InsertIntoNewPage(const Tuple &tuple, RID *rid, Transaction *txn) {
+  std::scoped_lock extend_lock(extend_latch_);
+  // Another insert may have added a page while this one was waiting.
+  if (InsertIntoPage(last_page_id_, tuple, rid, txn)) {
+    return true;
+  }
+  if (txn->GetState() == TransactionState::ABORTED) {
+    return false;
+  }
+
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id_));
+  if (cur_page == nullptr) {
+    return false;
+  }
+  page_id_t next_page_id;
+  auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
+  // If we could not create a new page,
+  if (new_page == nullptr) {
+    // Then life sucks and we abort the transaction.
+    buffer_pool_manager_->UnpinPage(last_page_id_, false);
+    return false;
+  }
+  // Otherwise we were able to create a new page. We initialize it now.
+  new_page->WLatch();
   cur_page->WLatch();
-  // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
-  // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
-    auto next_page_id = cur_page->GetNextPageId();
-    // If the next page is a valid page,
-    if (next_page_id != INVALID_PAGE_ID) {
-      // Unlatch and unpin the current page.
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-      // And repeat the process with the next page.
-      cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-      cur_page->WLatch();
+  cur_page->SetNextPageId(next_page_id);
+  new_page->Init(next_page_id, PAGE_SIZE, last_page_id_, log_manager_, txn);
+  cur_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id_, true);
+  bool inserted = new_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_);
+  uint32_t free_space = new_page->GetFreeSpaceRemaining();
+  new_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(next_page_id, true);
+
+  AppendToFreeSpaceMap(next_page_id, free_space);
+  last_page_id_ = next_page_id;
+  last_insert_page_id_ = next_page_id;
+  return inserted;
+}
+
+page_id_t TableHeap::FindPageWithFreeSpace(uint32_t free_space) {
+  size_t start;
+  std::vector<page_id_t> map_page_ids;
+  {
+    std::scoped_lock lock(fsm_latch_);
+    start = search_start_;
+    map_page_ids = fsm_page_ids_;
+  }
+  page_id_t page_id = INVALID_PAGE_ID;
+  size_t slot = start;
+  for (size_t i = start / FreeSpaceMapPage::CAPACITY; i < map_page_ids.size(); i++) {
+    auto map_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(map_page_ids[i]));
+    if (map_page == nullptr) {
+      break;
+    }
+    map_page->RLatch();
+    size_t base = i * FreeSpaceMapPage::CAPACITY;
+    int found = map_page->FindFreeSpace(free_space, slot - base);
+    if (found >= 0) {
+      slot = base + found;
+      page_id = map_page->GetPageIdAt(found);
     } else {
-      // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
-      // If we could not create a new page,
-      if (new_page == nullptr) {
-        // Then life sucks and we abort the transaction.
-        cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-        txn->SetState(TransactionState::ABORTED);
-        return false;
-      }
-      // Otherwise we were able to create a new page. We initialize it now.
-      new_page->WLatch();
-      cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-      cur_page = new_page;
+      slot = base + map_page->GetEntryCount();
+    }
+    map_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(map_page_ids[i], false);
+    if (page_id != INVALID_PAGE_ID) {
+      break;
     }
   }
-  // This line has caused most of us to double-take and "whoa double unlatch".
-  // We are not, in fact, double unlatching. See the invariant above.
-  cur_page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-  // Update the transaction's write set.
-  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+  std::scoped_lock lock(fsm_latch_);
+  // Unless a delete has made room further ahead meanwhile, the next search can skip the pages seen to be full.
+  if (search_start_ == start) {
+    search_start_ = slot;
+  }
+  return page_id;
+}
+
+void TableHeap::RecordFreeSpace(page_id_t page_id, uint32_t free_space) {
+  size_t slot;
+  page_id_t map_page_id;
+  {
+    std::scoped_lock lock(fsm_latch_);
+    auto entry = fsm_slots_.find(page_id);
+    if (entry == fsm_slots_.end()) {
+      return;
+    }
+    slot = entry->second;
+    map_page_id = fsm_page_ids_[slot / FreeSpaceMapPage::CAPACITY];
+  }
+  auto map_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(map_page_id));
+  if (map_page == nullptr) {
+    // the map is only a hint
+    return;
+  }
+  map_page->WLatch();
+  uint32_t old_free_space = map_page->GetFreeSpaceAt(slot % FreeSpaceMapPage::CAPACITY);
+  map_page->SetFreeSpaceAt(slot % FreeSpaceMapPage::CAPACITY, free_space);
+  map_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(map_page_id, true);
+  if (free_space > old_free_space) {
+    std::scoped_lock lock(fsm_latch_);
+    search_start_ = std::min(search_start_, slot);
+  }
+}
+
+void TableHeap::AppendToFreeSpaceMap(page_id_t page_id, uint32_t free_space) {
+  std::scoped_lock lock(fsm_latch_);
+  size_t slot = fsm_slots_.size();
+  if (slot == fsm_page_ids_.size() * FreeSpaceMapPage::CAPACITY) {
+    // The last map page is full, or there is none yet.
+    page_id_t map_page_id;
+    auto map_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->NewPage(&map_page_id));
+    BUSTUB_ASSERT(map_page != nullptr, "Couldn't create a page for the free space map.");
+    map_page->Init();
+    buffer_pool_manager_->UnpinPage(map_page_id, true);
+    if (!fsm_page_ids_.empty()) {
+      auto last_map_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(fsm_page_ids_.back()));
+      BUSTUB_ASSERT(last_map_page != nullptr, "Couldn't fetch a page of the free space map.");
+      last_map_page->WLatch();
+      last_map_page->SetNextPageId(map_page_id);
+      last_map_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(fsm_page_ids_.back(), true);
+    } else {
+      // The first page of the table points a reopened heap at its map.
+      auto first_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+      BUSTUB_ASSERT(first_page != nullptr, "Couldn't fetch a page of the table heap.");
+      first_page->WLatch();
+      first_page->SetFreeSpaceMapPageId(map_page_id);
+      first_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(first_page_id_, true);
+    }
+    fsm_page_ids_.push_back(map_page_id);
+  }
+  auto map_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(fsm_page_ids_.back()));
+  BUSTUB_ASSERT(map_page != nullptr, "Couldn't fetch a page of the free space map.");
+  map_page->WLatch();
+  int map_slot = map_page->Append(page_id, free_space);
+  map_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(fsm_page_ids_.back(), true);
+  BUSTUB_ASSERT(static_cast<size_t>(map_slot) == slot % FreeSpaceMapPage::CAPACITY, "Broken free space map.");
+  fsm_slots_.emplace(page_id, slot);
+  page_directory_.push_back(page_id);
+}
+
+bool TableHeap::LoadFreeSpaceMap(page_id_t free_space_map_page_id) {
+  page_id_t map_page_id = free_space_map_page_id;
+  while (map_page_id != INVALID_PAGE_ID) {
+    auto map_page = reinterpret_cast<FreeSpaceMapPage *>(buffer_pool_manager_->FetchPage(map_page_id));
+    BUSTUB_ASSERT(map_page != nullptr, "Couldn't fetch a page of the free space map.");
+    map_page->RLatch();
+    // Every map page holds at least one entry, and the first one starts with the first page of the table. A map page
+    // that never made it to disk reads as zeros and is caught here.
+    uint32_t entry_count = map_page->GetEntryCount();
+    if (entry_count == 0 || entry_count > FreeSpaceMapPage::CAPACITY ||
+        (fsm_page_ids_.empty() && map_page->GetPageIdAt(0) != first_page_id_)) {
+      map_page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(map_page_id, false);
+      return false;
+    }
+    size_t base = fsm_page_ids_.size() * FreeSpaceMapPage::CAPACITY;
+    for (uint32_t i = 0; i < map_page->GetEntryCount(); i++) {
+      fsm_slots_.emplace(map_page->GetPageIdAt(i), base + i);
+      page_directory_.push_back(map_page->GetPageIdAt(i));
+      // Pages are added to the map in the order of the table's page list.
+      last_page_id_ = map_page->GetPageIdAt(i);
+    }
+    page_id_t next_page_id = map_page->GetNextPageId();
+    map_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(map_page_id, false);
+    fsm_page_ids_.push_back(map_page_id);
+    map_page_id = next_page_id;
+  }
   return true;
 }
 
@@ -138,8 +339,11 @@ void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   page->WLatch();
   page->ApplyDelete(rid, txn, log_manager_);
   lock_manager_->Unlock(txn, rid);
+  uint32_t free_space = page->GetFreeSpaceRemaining();
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  // Let later inserts reuse the space.
+  RecordFreeSpace(rid.GetPageId(), free_space);
 }
 
 void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
@@ -11,56 +11,58 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <cstring>
 
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
 TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
-    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
+    : table_heap_(table_heap), tuple_(rid), txn_(txn) {
   if (rid.GetPageId() != INVALID_PAGE_ID) {
-    table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
+    LoadPage(rid.GetPageId());
+    SetTuple(rid);
   }
 }
 
+TableIterator::TableIterator(const TableIterator &other)
+    : table_heap_(other.table_heap_), tuple_(other.tuple_.rid_), txn_(other.txn_) {
+  if (other.page_ != nullptr) {
+    page_ = std::make_unique<TablePage>();
+    memcpy(page_->GetData(), other.page_->GetData(), PAGE_SIZE);
+    SetTuple(other.tuple_.rid_);
+  }
+}
+
+TableIterator &TableIterator::operator=(const TableIterator &other) {
+  if (this != &other) {
+    *this = TableIterator(other);
+  }
+  return *this;
+}
+
 const Tuple &TableIterator::operator*() {
   assert(*this != table_heap_->End());
-  return *tuple_;
+  return tuple_;
 }
 
 Tuple *TableIterator::operator->() {
   assert(*this != table_heap_->End());
-  return tuple_;
+  return &tuple_;
 }
 
 TableIterator &TableIterator::operator++() {
-  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
-  cur_page->RLatch();
-  assert(cur_page != nullptr);  // all pages are pinned
-
+  assert(page_ != nullptr);
   RID next_tuple_rid;
-  if (!cur_page->GetNextTupleRid(tuple_->rid_,
-                                 &next_tuple_rid)) {  // end of this page
-    while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
-      cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-      cur_page->RLatch();
-      if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
+  if (!page_->GetNextTupleRid(tuple_.rid_, &next_tuple_rid)) {  // end of this page
+    while (page_->GetNextPageId() != INVALID_PAGE_ID) {
+      LoadPage(page_->GetNextPageId());
+      if (page_->GetFirstTupleRid(&next_tuple_rid)) {
         break;
       }
     }
   }
-  tuple_->rid_ = next_tuple_rid;
-
-  if (*this != table_heap_->End()) {
-    table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
-  }
-  // release until copy the tuple
-  cur_page->RUnlatch();
-  buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+  SetTuple(next_tuple_rid);
   return *this;
 }
 
@@ -70,4 +72,33 @@ TableIterator TableIterator::operator++(int) {
   return clone;
 }
 
+void TableIterator::LoadPage(page_id_t page_id) {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  auto page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(page_id));
+  assert(page != nullptr);  // all pages are pinned
+  if (page_ == nullptr) {
+    page_ = std::make_unique<TablePage>();
+  }
+  page->RLatch();
+  memcpy(page_->GetData(), page->GetData(), PAGE_SIZE);
+  page->RUnlatch();
+  buffer_pool_manager->UnpinPage(page_id, false);
+  // A chain that follows page ids is read ahead by the buffer pool's own sequential detection, as far as its window
+  // goes. The chain need not follow them though, so where it jumps, tell the buffer pool which page comes next; unless
+  // it does not read ahead at all, in which case the prefetch would only block the scan on the read.
+  page_id_t next_page_id = page_->GetNextPageId();
+  if (next_page_id != INVALID_PAGE_ID && next_page_id != page_id + 1 &&
+      buffer_pool_manager->GetReadAheadWindow() > 0) {
+    buffer_pool_manager->PrefetchPages({next_page_id});
+  }
+}
+
+void TableIterator::SetTuple(const RID &rid) {
+  if (rid.GetPageId() == INVALID_PAGE_ID || !page_->GetTupleView(rid, &tuple_)) {
+    // the end iterator
+    tuple_ = Tuple(RID(INVALID_PAGE_ID, 0));
+    page_.reset();
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_file.cpp
+//
+// Identification: src/storage/table/tmp_tuple_file.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_tuple_file.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+TmpTupleFile::~TmpTupleFile() {
+  FinishPage();
+  for (page_id_t page_id : page_ids_) {
+    bpm_->DeletePage(page_id);
+  }
+}
+
+void TmpTupleFile::Append(const Tuple &tuple) {
+  if (tuple.GetLength() > TmpTuplePage::MaxTupleSize(PAGE_SIZE)) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Tuple too large to spill.");
+  }
+  TmpTuple location(INVALID_PAGE_ID, 0);
+  if (write_page_ == nullptr || !write_page_->Insert(tuple, &location)) {
+    FinishPage();
+    page_id_t page_id;
+    write_page_ = reinterpret_cast<TmpTuplePage *>(bpm_->NewPage(&page_id));
+    if (write_page_ == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "No buffer pool frame to spill to.");
+    }
+    write_page_->Init(page_id, PAGE_SIZE);
+    page_ids_.push_back(page_id);
+    write_page_->Insert(tuple, &location);
+  }
+  num_tuples_++;
+}
+
+void TmpTupleFile::Rewind() {
+  FinishPage();
+  read_tuples_.clear();
+  read_idx_ = 0;
+  read_page_idx_ = 0;
+}
+
+bool TmpTupleFile::Next(Tuple *tuple) {
+  while (read_idx_ >= read_tuples_.size()) {
+    if (read_page_idx_ >= page_ids_.size()) {
+      return false;
+    }
+    page_id_t page_id = page_ids_[read_page_idx_++];
+    auto *page = reinterpret_cast<TmpTuplePage *>(bpm_->FetchPage(page_id));
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "No buffer pool frame to read a spilled page into.");
+    }
+    read_tuples_.clear();
+    read_idx_ = 0;
+    for (size_t offset = page->GetFreeSpacePointer(); offset < PAGE_SIZE;) {
+      read_tuples_.emplace_back();
+      offset = page->Get(offset, &read_tuples_.back());
+    }
+    bpm_->UnpinPage(page_id, false);
+    // a page holds its tuples newest first
+    std::reverse(read_tuples_.begin(), read_tuples_.end());
+  }
+  *tuple = read_tuples_[read_idx_++];
+  return true;
+}
+
+void TmpTupleFile::FinishPage() {
+  if (write_page_ != nullptr) {
+    bpm_->UnpinPage(write_page_->GetTablePageId(), true);
+    write_page_ = nullptr;
+  }
+}
+
+}  // namespace bustub
@@ -54,16 +54,12 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true)
 }
 
 Tuple::Tuple(const Tuple &other) : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_) {
-  if (allocated_) {
-    delete[] data_;
-  }
-  if (allocated_) {
+  // A view into a page (see TablePage::GetTupleView) is materialized, as the page may change under the copy.
+  if (other.data_ != nullptr) {
     // Deep copy.
+    allocated_ = true;
     data_ = new char[size_];
     memcpy(data_, other.data_, size_);
-  } else {
-    // Shallow copy.
-    data_ = other.data_;
   }
 }
 
@@ -74,14 +70,14 @@ Tuple &Tuple::operator=(const Tuple &other) {
   allocated_ = other.allocated_;
   rid_ = other.rid_;
   size_ = other.size_;
+  data_ = nullptr;
 
-  if (allocated_) {
+  // A view into a page (see TablePage::GetTupleView) is materialized, as the page may change under the copy.
+  if (other.data_ != nullptr) {
     // Deep copy.
+    allocated_ = true;
     data_ = new char[size_];
     memcpy(data_, other.data_, size_);
-  } else {
-    // Shallow copy.
-    data_ = other.data_;
   }
 
   return *this;
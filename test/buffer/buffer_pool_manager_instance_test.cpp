@@ -11,14 +11,59 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <functional>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "buffer/background_writer.h"
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
+#include "storage/disk/async_disk_manager.h"
 
 namespace bustub {
 
+namespace {
+
+/**
+ * Fill a pool of three frames with dirty pages and evict one of them, so that the clock hand has swept past every
+ * frame, then call between and evict again.
+ * @return the page evicted the second time
+ */
+page_id_t SecondVictim(ReplacerType replacer_type,
+                       const std::function<void(BufferPoolManagerInstance *, DiskManager *)> &between) {
+  const size_t buffer_pool_size = 3;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, nullptr, replacer_type);
+  page_id_t page_id_temp;
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  between(bpm, disk_manager);
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  std::vector<bool> resident(page_id_temp);
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    if (bpm->GetPages()[i].GetPageId() < page_id_temp) {
+      resident[bpm->GetPages()[i].GetPageId()] = true;
+    }
+  }
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove("test.db");
+  for (page_id_t page_id = 1; page_id < page_id_temp; ++page_id) {
+    if (!resident[page_id]) {
+      return page_id;
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+}  // namespace
+
 // NOLINTNEXTLINE
 // Check whether pages containing terminal characters can be recovered
 TEST(BufferPoolManagerInstanceTest, BinaryDataTest) {
@@ -143,4 +188,365 @@ TEST(BufferPoolManagerInstanceTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+// Many threads fetch and modify more pages than fit in the pool, so evictions and reads overlap with hits
+TEST(BufferPoolManagerInstanceTest, ConcurrentEvictionTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 8;
+  const int num_pages = 32;
+  const int num_threads = 8;
+  const int rounds = 200;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(i, page_id_temp);
+    *reinterpret_cast<int *>(page->GetData()) = 0;
+    ASSERT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([bpm, tid] {
+      for (int round = 0; round < rounds; ++round) {
+        page_id_t page_id = (tid * 7 + round * 3) % num_pages;
+        Page *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        EXPECT_EQ(page_id, page->GetPageId());
+        page->WLatch();
+        ++*reinterpret_cast<int *>(page->GetData());
+        page->WUnlatch();
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Every successful increment must have survived eviction and reload.
+  int total = 0;
+  for (int i = 0; i < num_pages; ++i) {
+    Page *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    total += *reinterpret_cast<int *>(page->GetData());
+    ASSERT_TRUE(bpm->UnpinPage(i, false));
+  }
+  EXPECT_EQ(num_threads * rounds, total);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+// Prefetched pages are read in the background in one batch, evicting (and writing back) dirty pages on the way
+TEST(BufferPoolManagerInstanceTest, PrefetchTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  const int num_pages = 64;
+
+  auto *disk_manager = new AsyncDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", i);
+    ASSERT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: pages 0-15 were evicted long ago; prefetch them and read them back.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 16; ++i) {
+    page_ids.push_back(i);
+  }
+  bpm->PrefetchPages(page_ids);
+  for (int i = 0; i < 16; ++i) {
+    Page *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+    ASSERT_TRUE(bpm->UnpinPage(i, false));
+  }
+  // Only the dirty pages 48-63 had to be written back to make room.
+  EXPECT_EQ(16, disk_manager->GetNumWrites() - (num_pages - 16));
+
+  // Scenario: prefetching pages that are resident or pinned is a no-op, and stops when every frame is pinned.
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i));
+  }
+  bpm->PrefetchPages({0, 1, 16, 17});
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_TRUE(bpm->UnpinPage(i, false));
+  }
+
+  // Scenario: prefetches racing with fetches of the same pages.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < 4; ++tid) {
+    threads.emplace_back([bpm, tid] {
+      for (int round = 0; round < 50; ++round) {
+        int first = (round * 5 + tid * 16) % num_pages;
+        bpm->PrefetchPages({first, (first + 1) % num_pages, (first + 2) % num_pages});
+        Page *page = bpm->FetchPage((first + 1) % num_pages);
+        if (page == nullptr) {
+          continue;
+        }
+        EXPECT_EQ("page " + std::to_string((first + 1) % num_pages), std::string(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage((first + 1) % num_pages, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // the buffer pool waits for outstanding prefetches before it goes away
+  delete bpm;
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+// Fetching consecutive pages makes the buffer pool read the following pages ahead of the reader
+TEST(BufferPoolManagerInstanceTest, ReadAheadTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 64;
+  const int num_pages = 256;
+
+  auto *disk_manager = new AsyncDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    *reinterpret_cast<int *>(bpm->FetchPage(i)->GetData()) = i;
+    ASSERT_TRUE(bpm->UnpinPage(i, true));
+    ASSERT_TRUE(bpm->UnpinPage(i, true));
+  }
+  auto is_resident = [bpm](page_id_t page_id) {
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      if (bpm->GetPages()[i].GetPageId() == page_id) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  // Scenario: read-ahead is enabled on top of an asynchronous disk manager only.
+  EXPECT_EQ(READ_AHEAD_WINDOW, bpm->GetReadAheadWindow());
+  {
+    DiskManager sync_disk_manager("sync_test.db");
+    BufferPoolManagerInstance sync_bpm(buffer_pool_size, &sync_disk_manager);
+    EXPECT_EQ(0, sync_bpm.GetReadAheadWindow());
+    sync_disk_manager.ShutDown();
+    remove("sync_test.db");
+    remove("sync_test.log");
+  }
+
+  // Scenario: scattered fetches do not trigger read-ahead.
+  for (page_id_t page_id : {0, 10, 20, 30}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_FALSE(is_resident(11));
+  EXPECT_FALSE(is_resident(31));
+
+  // Scenario: READ_AHEAD_TRIGGER consecutive fetches prefetch the next READ_AHEAD_WINDOW pages.
+  for (page_id_t page_id = 100; page_id < 100 + READ_AHEAD_TRIGGER; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  page_id_t last_fetched = 100 + READ_AHEAD_TRIGGER - 1;
+  for (page_id_t page_id = last_fetched + 1; page_id <= last_fetched + READ_AHEAD_WINDOW; ++page_id) {
+    EXPECT_TRUE(is_resident(page_id));
+  }
+  EXPECT_FALSE(is_resident(last_fetched + READ_AHEAD_WINDOW + 1));
+
+  // Scenario: the window moves along with the reader, and prefetched pages hold the right contents.
+  for (page_id_t page_id = last_fetched + 1; page_id < num_pages; ++page_id) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(page_id, *reinterpret_cast<int *>(page->GetData()));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: an explicit hint works the same way, whatever the access pattern.
+  EXPECT_FALSE(is_resident(3));
+  bpm->PrefetchPages({3});
+  EXPECT_TRUE(is_resident(3));
+
+  delete bpm;
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+// A scan that is read ahead stays cold to LRU-K: the prefetch of a page is not an access to it
+TEST(BufferPoolManagerInstanceTest, ReadAheadScanResistanceTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 64;
+  const int num_pages = 512;
+  const page_id_t working_set = 16;
+
+  auto *disk_manager = new AsyncDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, nullptr, ReplacerType::LRU_K);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    ASSERT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  auto is_resident = [bpm](page_id_t page_id) {
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      if (bpm->GetPages()[i].GetPageId() == page_id) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  // Scenario: the working set is accessed twice, backwards so that it is not read ahead.
+  for (int round = 0; round < 2; ++round) {
+    for (page_id_t page_id = working_set - 1; page_id >= 0; --page_id) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+      ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+  }
+
+  // The only pins the test does not hold are those of prefetches in flight.
+  auto wait_for_prefetch = [bpm](page_id_t page_id) {
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      Page *page = &bpm->GetPages()[i];
+      while (page->GetPageId() == page_id && page->GetPinCount() > 0) {
+        std::this_thread::yield();
+      }
+    }
+  };
+
+  // Scenario: a scan of many times the pool that prefetches each page before reading it, as a table iterator does,
+  // leaves the working set alone. Each page is fetched once its prefetch has landed, so that the fetch is the first
+  // pin of the page.
+  for (page_id_t page_id = num_pages - 1; page_id >= working_set; --page_id) {
+    bpm->PrefetchPages({page_id});
+    wait_for_prefetch(page_id);
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  for (page_id_t page_id = 0; page_id < working_set; ++page_id) {
+    EXPECT_TRUE(is_resident(page_id)) << page_id;
+  }
+
+  delete bpm;
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+// Flushing a page is not a use of it: under every policy, a flushed cold page is still the next victim
+TEST(BufferPoolManagerInstanceTest, FlushKeepsEvictionOrderTest) {
+  for (ReplacerType replacer_type : {ReplacerType::LRU, ReplacerType::CLOCK, ReplacerType::LRU_K}) {
+    page_id_t victim = SecondVictim(replacer_type, [](BufferPoolManagerInstance *bpm, DiskManager *disk_manager) {});
+    ASSERT_NE(INVALID_PAGE_ID, victim);
+    EXPECT_EQ(victim, SecondVictim(replacer_type, [victim](BufferPoolManagerInstance *bpm, DiskManager *disk_manager) {
+                EXPECT_TRUE(bpm->FlushPage(victim));
+              }));
+  }
+}
+
+// NOLINTNEXTLINE
+// Neither is writing a page back in the background: a cold page the writer cleaned is still the next victim
+TEST(BufferPoolManagerInstanceTest, BackgroundWriterKeepsEvictionOrderTest) {
+  for (ReplacerType replacer_type : {ReplacerType::LRU, ReplacerType::CLOCK, ReplacerType::LRU_K}) {
+    page_id_t victim = SecondVictim(replacer_type, [](BufferPoolManagerInstance *bpm, DiskManager *disk_manager) {});
+    ASSERT_NE(INVALID_PAGE_ID, victim);
+    EXPECT_EQ(victim, SecondVictim(replacer_type, [](BufferPoolManagerInstance *bpm, DiskManager *disk_manager) {
+                BackgroundWriter writer({bpm}, disk_manager, 2);
+                EXPECT_EQ(2, writer.FlushRound());
+              }));
+  }
+}
+
+// NOLINTNEXTLINE
+// The background writer cleans cold dirty frames ahead of eviction and writes adjacent pages together
+TEST(BufferPoolManagerInstanceTest, BackgroundWriterTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < 16; ++i) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", i);
+  }
+  // Pages 0-5 and 10-15 become cold, 6-9 stay pinned.
+  for (int i = 0; i < 16; ++i) {
+    if (i < 6 || i >= 10) {
+      ASSERT_TRUE(bpm->UnpinPage(i, true));
+    }
+  }
+  EXPECT_EQ(0, bpm->GetCleanFrameCount());
+
+  // Scenario: a single round cleans as many frames as the target asks for, in two runs of adjacent pages.
+  BackgroundWriter writer({bpm}, disk_manager, 12);
+  EXPECT_EQ(12, writer.FlushRound());
+  EXPECT_EQ(2, writer.GetNumWrites());
+  EXPECT_EQ(12, bpm->GetCleanFrameCount());
+  EXPECT_EQ(0, writer.FlushRound());
+
+  // Scenario: the written pages can be evicted without being written again and read back intact.
+  int writes_before = disk_manager->GetNumWrites();
+  for (int i = 6; i < 10; ++i) {
+    ASSERT_TRUE(bpm->UnpinPage(i, true));
+    ASSERT_TRUE(bpm->FlushPage(i));
+  }
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    ASSERT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  // Only the four flushes write: new pages are not written on creation and the old pages were already clean.
+  EXPECT_EQ(writes_before + 4, disk_manager->GetNumWrites());
+  for (int i = 0; i < 16; ++i) {
+    Page *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+    ASSERT_TRUE(bpm->UnpinPage(i, false));
+  }
+
+  // Scenario: the writer thread keeps dirtying threads from running out of clean frames.
+  bpm->StartBackgroundWriter(8);
+  for (int i = 0; i < 16; ++i) {
+    Page *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    ASSERT_TRUE(bpm->UnpinPage(i, true));
+  }
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (bpm->GetCleanFrameCount() < 8 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_GE(bpm->GetCleanFrameCount(), 8);
+  bpm->StopBackgroundWriter();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -0,0 +1,198 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <list>
+#include <random>
+#include <unordered_map>
+
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2);
+
+  // Scenario: frames 1-6 are accessed once, then 1 and 2 a second time.
+  for (frame_id_t frame_id = 1; frame_id <= 6; ++frame_id) {
+    lru_k_replacer.Pin(frame_id);
+    lru_k_replacer.RecordAccess(frame_id);
+  }
+  lru_k_replacer.RecordAccess(1);
+  lru_k_replacer.RecordAccess(2);
+  for (frame_id_t frame_id = 1; frame_id <= 6; ++frame_id) {
+    lru_k_replacer.Unpin(frame_id);
+  }
+  EXPECT_EQ(6, lru_k_replacer.Size());
+
+  // Scenario: frames with a single access go first, oldest access first.
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(4, value);
+
+  // Scenario: pinning removes a frame; the access is recorded on its own.
+  lru_k_replacer.Pin(5);
+  EXPECT_EQ(3, lru_k_replacer.Size());
+  lru_k_replacer.RecordAccess(5);
+  lru_k_replacer.Unpin(5);
+
+  // Scenario: 6 is the only frame left with one access; then the frame whose second most recent access is oldest.
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(6, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(5, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, lru_k_replacer.Size());
+}
+
+TEST(LRUKReplacerTest, RemoveTest) {
+  LRUKReplacer lru_k_replacer(3, 2);
+
+  // Frame 0 holds a page accessed twice, frame 1 one accessed once.
+  for (frame_id_t frame_id = 0; frame_id <= 1; ++frame_id) {
+    lru_k_replacer.Pin(frame_id);
+    lru_k_replacer.RecordAccess(frame_id);
+  }
+  lru_k_replacer.RecordAccess(0);
+  lru_k_replacer.Unpin(1);
+
+  // Scenario: the page of frame 0 is deleted; the next page in the frame does not inherit its accesses.
+  lru_k_replacer.Remove(0);
+  EXPECT_EQ(1, lru_k_replacer.Size());
+  lru_k_replacer.Pin(0);
+  lru_k_replacer.RecordAccess(0);
+  lru_k_replacer.Unpin(0);
+
+  // Both frames have a single access now, so the older one goes first, then the new page.
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+
+  // Scenario: removing a frame the replacer does not hold is harmless.
+  lru_k_replacer.Remove(2);
+  EXPECT_EQ(0, lru_k_replacer.Size());
+}
+
+TEST(LRUKReplacerTest, VictimKeepsHistoryTest) {
+  LRUKReplacer lru_k_replacer(2, 2);
+
+  // Frames 1 and 0 hold pages accessed twice, frame 1 first; only frame 0 is unpinned.
+  for (frame_id_t frame_id : {1, 0}) {
+    lru_k_replacer.Pin(frame_id);
+    lru_k_replacer.RecordAccess(frame_id);
+    lru_k_replacer.RecordAccess(frame_id);
+  }
+  lru_k_replacer.Unpin(0);
+
+  // Scenario: the buffer pool picks frame 0, but its page is pinned again before it is evicted, so the frame comes
+  // back with the page still in it.
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  lru_k_replacer.RecordAccess(0);
+  lru_k_replacer.Unpin(0);
+  lru_k_replacer.Unpin(1);
+
+  // The page kept its accesses, so it does not go ahead of frame 1 as a page accessed only once would.
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+}
+
+/**
+ * A buffer pool reduced to its replacement decisions: every access pins and unpins one page, and a miss takes a free
+ * frame or a victim from the replacer.
+ */
+class CacheModel {
+ public:
+  CacheModel(Replacer *replacer, size_t num_frames) : replacer_(replacer) {
+    for (size_t i = 0; i < num_frames; ++i) {
+      free_list_.push_back(static_cast<frame_id_t>(i));
+    }
+  }
+
+  /** @return true if the access was a hit */
+  bool Access(page_id_t page_id) {
+    frame_id_t frame_id;
+    bool hit = page_table_.count(page_id) != 0;
+    if (hit) {
+      frame_id = page_table_[page_id];
+    } else {
+      if (!free_list_.empty()) {
+        frame_id = free_list_.front();
+        free_list_.pop_front();
+      } else {
+        EXPECT_TRUE(replacer_->Victim(&frame_id));
+        replacer_->Remove(frame_id);
+        page_table_.erase(frame_owner_[frame_id]);
+      }
+      page_table_[page_id] = frame_id;
+      frame_owner_[frame_id] = page_id;
+    }
+    replacer_->Pin(frame_id);
+    replacer_->RecordAccess(frame_id);
+    replacer_->Unpin(frame_id);
+    return hit;
+  }
+
+ private:
+  Replacer *replacer_;
+  std::list<frame_id_t> free_list_;
+  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  std::unordered_map<frame_id_t, page_id_t> frame_owner_;
+};
+
+// Point lookups on a small hot set interleaved with full scans of a table much larger than the pool.
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  const size_t num_frames = 64;
+  const page_id_t hot_pages = 32;
+  const page_id_t table_pages = 1000;
+  const int rounds = 20;
+  const int lookups_per_round = 100;
+
+  auto hot_hit_rate = [&](Replacer *replacer) {
+    CacheModel cache(replacer, num_frames);
+    std::mt19937 rng(15445);
+    std::uniform_int_distribution<page_id_t> dist(0, hot_pages - 1);
+    int hits = 0;
+    for (int round = 0; round < rounds; ++round) {
+      for (int i = 0; i < lookups_per_round; ++i) {
+        hits += cache.Access(dist(rng)) ? 1 : 0;
+      }
+      for (page_id_t page_id = hot_pages; page_id < hot_pages + table_pages; ++page_id) {
+        cache.Access(page_id);
+      }
+    }
+    return static_cast<double>(hits) / (rounds * lookups_per_round);
+  };
+
+  LRUReplacer lru_replacer(num_frames);
+  LRUKReplacer lru_k_replacer(num_frames, 2);
+  double lru_rate = hot_hit_rate(&lru_replacer);
+  double lru_k_rate = hot_hit_rate(&lru_k_replacer);
+
+  // Each scan flushes the whole hot set out of plain LRU; LRU-2 only misses on the very first lookups.
+  EXPECT_GT(lru_k_rate, lru_rate);
+  EXPECT_GT(lru_k_rate, 0.95);
+}
+
+}  // namespace bustub
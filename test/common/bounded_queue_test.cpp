@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bounded_queue_test.cpp
+//
+// Identification: test/common/bounded_queue_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <thread>              // NOLINT
+#include <vector>
+
+#include "common/bounded_queue.h"
+#include "common/thread_pool.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(BoundedQueueTest, SingleThreadTest) {
+  BoundedQueue<int> queue(5);
+  // the capacity is rounded up to a power of two
+  ASSERT_EQ(queue.Capacity(), 8);
+
+  int value = 0;
+  ASSERT_FALSE(queue.TryPop(&value));
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < 8; i++) {
+      value = i;
+      ASSERT_TRUE(queue.TryPush(&value));
+    }
+    value = 8;
+    ASSERT_FALSE(queue.TryPush(&value));
+    // first in, first out
+    for (int i = 0; i < 8; i++) {
+      ASSERT_TRUE(queue.TryPop(&value));
+      ASSERT_EQ(value, i);
+    }
+    ASSERT_FALSE(queue.TryPop(&value));
+  }
+}
+
+TEST(BoundedQueueTest, ConcurrentTest) {
+  const int num_threads = 4;
+  const int num_items = 50000;
+  BoundedQueue<int> queue(16);
+  std::atomic<int64_t> sum{0};
+  std::atomic<int> popped{0};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = t; i < num_threads * num_items; i += num_threads) {
+        int value = i;
+        while (!queue.TryPush(&value)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+    threads.emplace_back([&] {
+      int value;
+      while (popped < num_threads * num_items) {
+        if (queue.TryPop(&value)) {
+          sum += value;
+          popped++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // every item came out exactly once
+  int64_t n = num_threads * num_items;
+  EXPECT_EQ(popped, n);
+  EXPECT_EQ(sum, n * (n - 1) / 2);
+}
+
+TEST(ThreadPoolTest, BlockingTasksTest) {
+  std::mutex latch;
+  std::condition_variable cv;
+  int arrived = 0;
+  const int num_tasks = 8;
+  ThreadPool pool;
+
+  // every task waits for all of the others, which only works if they all run at once
+  for (int i = 0; i < num_tasks; i++) {
+    pool.Submit([&] {
+      std::unique_lock lock(latch);
+      arrived++;
+      cv.notify_all();
+      cv.wait(lock, [&] { return arrived >= num_tasks; });
+    });
+  }
+  {
+    std::unique_lock lock(latch);
+    cv.wait(lock, [&] { return arrived >= num_tasks; });
+  }
+  EXPECT_GE(pool.Size(), num_tasks);
+}
+
+}  // namespace bustub
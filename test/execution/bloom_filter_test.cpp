@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter_test.cpp
+//
+// Identification: test/execution/bloom_filter_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "execution/bloom_filter.h"
+#include "execution/join_hash_table.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+hash_t HashInteger(int32_t i) {
+  std::vector<char> key;
+  JoinHashTable::SerializeKeyColumn(ValueFactory::GetIntegerValue(i), &key);
+  return JoinHashTable::HashKey(key.data(), key.size());
+}
+
+}  // namespace
+
+TEST(BloomFilterTest, FalsePositiveRateTest) {
+  const int32_t num_keys = 100000;
+  BloomFilter filter(num_keys);
+  for (int32_t i = 0; i < num_keys; i++) {
+    filter.Insert(HashInteger(i));
+  }
+
+  // no false negatives
+  for (int32_t i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(filter.MayContain(HashInteger(i)));
+  }
+
+  // few false positives, for keys of the same kind as the ones inserted
+  size_t false_positives = 0;
+  for (int32_t i = num_keys; i < 11 * num_keys; i++) {
+    false_positives += filter.MayContain(HashInteger(i)) ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, 10 * num_keys / 100);
+  EXPECT_LE(filter.MemoryUsage(), 2 * num_keys * BloomFilter::BITS_PER_KEY / 8);
+}
+
+TEST(BloomFilterTest, ShrinkToFitTest) {
+  const int32_t num_keys = 1000;
+  BloomFilter filter(1000 * num_keys);
+  for (int32_t i = 0; i < num_keys; i++) {
+    filter.Insert(HashInteger(i));
+  }
+  filter.ShrinkToFit();
+  EXPECT_EQ(filter.MemoryUsage(), BloomFilter::MemoryUsage(num_keys));
+
+  // the shrunk filter keeps every key, and is as selective as one sized for the keys in the first place
+  for (int32_t i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(filter.MayContain(HashInteger(i)));
+  }
+  size_t false_positives = 0;
+  for (int32_t i = num_keys; i < 11 * num_keys; i++) {
+    false_positives += filter.MayContain(HashInteger(i)) ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, 10 * num_keys / 100);
+}
+
+TEST(BloomFilterTest, EmptyFilterTest) {
+  BloomFilter filter(0);
+  for (int32_t i = 0; i < 1000; i++) {
+    ASSERT_FALSE(filter.MayContain(HashInteger(i)));
+  }
+}
+
+}  // namespace bustub
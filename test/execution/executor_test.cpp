@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
 #include <string>
@@ -21,18 +22,26 @@
 #include "concurrency/transaction_manager.h"
 #include "execution/execution_engine.h"
 #include "execution/executor_context.h"
+#include "execution/executor_factory.h"
 #include "execution/executors/aggregation_executor.h"
+#include "execution/executors/distinct_executor.h"
+#include "execution/executors/hash_join_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/executors/sort_executor.h"
 #include "execution/expressions/aggregate_value_expression.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
+#include "execution/plans/exchange_plan.h"
+#include "execution/plans/gather_plan.h"
 #include "execution/expressions/constant_value_expression.h"
 #include "execution/plans/delete_plan.h"
 #include "execution/plans/distinct_plan.h"
 #include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
 #include "execution/plans/limit_plan.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
 #include "execution/plans/update_plan.h"
 #include "executor_test_util.h"  // NOLINT
 #include "gtest/gtest.h"
@@ -55,6 +64,7 @@
  * - Aggregation
  * - Limit
  * - Distinct
+ * - Sort
  *
  * Each of the tests demonstrates how to construct a query plan for
  * a particular executors. Students should be able to learn from and
@@ -115,6 +125,43 @@ TEST_F(ExecutorTest, SimpleSeqScanTest) {
   }
 }
 
+// SELECT col_a, col_b FROM test_1 WHERE col_a >= 990, WHERE col_a < 50 and WHERE col_a = 500, through a B+ tree index
+TEST_F(ExecutorTest, SimpleIndexScanTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto key_schema = ParseCreateStatement("a bigint");
+  auto *index_info = GetExecutorContext()->GetCatalog()->CreateBPlusTreeIndex<KeyType, ValueType, ComparatorType>(
+      GetTxn(), "index1", "test_1", schema, *key_schema, {0}, 8);
+  ASSERT_NE(index_info, Catalog::NULL_INDEX_INFO);
+
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  auto scan = [&](ComparisonType comp_type, const Value &constant) {
+    auto *predicate = MakeComparisonExpression(col_a, MakeConstantValueExpression(constant), comp_type);
+    IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_};
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<int32_t> keys;
+    for (const auto &tuple : result_set) {
+      keys.push_back(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+    }
+    return keys;
+  };
+
+  // Verify: the index returns tuples in key order
+  std::vector<int32_t> expected(10);
+  std::iota(expected.begin(), expected.end(), 990);
+  ASSERT_EQ(scan(ComparisonType::GreaterThanOrEqual, ValueFactory::GetIntegerValue(990)), expected);
+  // the keys are the INTEGERs of colA, whatever the declared key schema; a BIGINT bound is not narrowed to them
+  ASSERT_EQ(scan(ComparisonType::GreaterThanOrEqual, ValueFactory::GetBigIntValue(990)), expected);
+  expected.resize(50);
+  std::iota(expected.begin(), expected.end(), 0);
+  ASSERT_EQ(scan(ComparisonType::LessThan, ValueFactory::GetIntegerValue(50)), expected);
+  ASSERT_EQ(scan(ComparisonType::Equal, ValueFactory::GetIntegerValue(500)), std::vector<int32_t>{500});
+  ASSERT_EQ(scan(ComparisonType::NotEqual, ValueFactory::GetIntegerValue(500)).size(), TEST1_SIZE - 1);
+}
+
 // INSERT INTO empty_table2 VALUES (100, 10), (101, 11), (102, 12)
 TEST_F(ExecutorTest, SimpleRawInsertTest) {
   // Create Values to insert
@@ -491,6 +538,152 @@ TEST_F(ExecutorTest, SimpleHashJoinTest) {
   }
 }
 
+// SELECT t1.colA, t2.colC FROM test_1 t1 JOIN test_1 t2 ON t1.colA = t2.colA AND t1.colB = t2.colB
+TEST_F(ExecutorTest, MultiColumnHashJoinTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *col_c = MakeColumnValueExpression(schema, 0, "colC");
+  auto *scan_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}, {"colC", col_c}});
+  SeqScanPlanNode left_scan{scan_schema, nullptr, table_info->oid_};
+  SeqScanPlanNode right_scan{scan_schema, nullptr, table_info->oid_};
+
+  auto *left_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *left_b = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  auto *right_a = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto *right_b = MakeColumnValueExpression(*scan_schema, 1, "colB");
+  auto *right_c = MakeColumnValueExpression(*scan_schema, 1, "colC");
+  auto *out_schema = MakeOutputSchema({{"colA", left_a}, {"colC", right_c}});
+  HashJoinPlanNode join_plan{out_schema, std::vector<const AbstractPlanNode *>{&left_scan, &right_scan},
+                             std::vector<const AbstractExpression *>{left_a, left_b},
+                             std::vector<const AbstractExpression *>{right_a, right_b}};
+
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+
+  // colA is unique, so every tuple joins with itself only
+  ASSERT_EQ(result_set.size(), TEST1_SIZE);
+  std::unordered_set<int32_t> seen;
+  for (const auto &tuple : result_set) {
+    ASSERT_TRUE(seen.insert(tuple.GetValue(out_schema, 0).GetAs<int32_t>()).second);
+  }
+}
+
+TEST_F(ExecutorTest, SpillingHashJoinTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *scan_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  SeqScanPlanNode left_scan{scan_schema, nullptr, table_info->oid_};
+  SeqScanPlanNode right_scan{scan_schema, nullptr, table_info->oid_};
+  auto *left_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *right_a = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto *out_schema = MakeOutputSchema({{"left_colA", left_a}, {"right_colA", right_a}});
+
+  // join on the unique colA, which spills partitions and splits them again, and on colB, which has ten values only
+  for (uint32_t key_idx : {0, 1}) {
+    auto *left_key = MakeColumnValueExpression(*scan_schema, 0, key_idx == 0 ? "colA" : "colB");
+    auto *right_key = MakeColumnValueExpression(*scan_schema, 1, key_idx == 0 ? "colA" : "colB");
+    HashJoinPlanNode join_plan{out_schema, std::vector<const AbstractPlanNode *>{&left_scan, &right_scan}, left_key,
+                               right_key};
+
+    std::vector<Tuple> in_memory;
+    GetExecutionEngine()->Execute(&join_plan, &in_memory, GetTxn(), GetExecutorContext());
+
+    MemoryBudget *budget = GetExecutorContext()->GetMemoryBudget();
+    size_t limit = budget->GetLimit();
+    budget->SetLimit(16 * 1024);
+    std::vector<Tuple> spilled;
+    {
+      auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+      executor->Init();
+      Tuple tuple;
+      RID rid;
+      while (executor->Next(&tuple, &rid)) {
+        spilled.push_back(tuple);
+      }
+      ASSERT_GT(dynamic_cast<HashJoinExecutor *>(executor.get())->NumSpilledPartitions(), 0);
+    }
+    budget->SetLimit(limit);
+    ASSERT_EQ(budget->GetReserved(), 0);
+
+    auto pairs = [out_schema](const std::vector<Tuple> &tuples) {
+      std::vector<std::pair<int32_t, int32_t>> result;
+      for (const auto &tuple : tuples) {
+        result.emplace_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>(),
+                            tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+      }
+      std::sort(result.begin(), result.end());
+      return result;
+    };
+    if (key_idx == 0) {
+      ASSERT_EQ(in_memory.size(), TEST1_SIZE);
+    }
+    ASSERT_EQ(pairs(spilled), pairs(in_memory));
+  }
+}
+
+// SELECT l.colA, r.colA FROM test_1 l JOIN test_1 r ON l.colA = r.colA WHERE r.colA < 10
+TEST_F(ExecutorTest, BloomFilterPushdownTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *scan_schema = MakeOutputSchema({{"colA", col_a}});
+  auto *const10 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(10));
+  auto *predicate = MakeComparisonExpression(col_a, const10, ComparisonType::LessThan);
+  SeqScanPlanNode left_scan{scan_schema, nullptr, table_info->oid_};
+  SeqScanPlanNode right_scan{scan_schema, predicate, table_info->oid_};
+  auto *left_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *right_a = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto *out_schema = MakeOutputSchema({{"left_colA", left_a}, {"right_colA", right_a}});
+  HashJoinPlanNode join_plan{out_schema, std::vector<const AbstractPlanNode *>{&left_scan, &right_scan}, left_a,
+                             right_a};
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+  executor->Init();
+  std::vector<int32_t> result;
+  Tuple tuple;
+  RID rid;
+  while (executor->Next(&tuple, &rid)) {
+    ASSERT_EQ(tuple.GetValue(out_schema, 0).GetAs<int32_t>(), tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+    result.push_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>());
+  }
+  std::sort(result.begin(), result.end());
+  std::vector<int32_t> expected(10);
+  std::iota(expected.begin(), expected.end(), 0);
+  ASSERT_EQ(result, expected);
+
+  // the scan dropped nearly all rows that could not join before projecting them
+  const RuntimeFilter *filter = dynamic_cast<HashJoinExecutor *>(executor.get())->GetRuntimeFilter();
+  ASSERT_NE(filter, nullptr);
+  ASSERT_EQ(filter->NumRowsChecked(), TEST1_SIZE);
+  ASSERT_GE(filter->NumRowsEliminated(), TEST1_SIZE - 10 - 50);
+
+  // the filter was shrunk to the build keys, and its memory is reserved from the budget until the join is done
+  MemoryBudget *budget = GetExecutorContext()->GetMemoryBudget();
+  ASSERT_EQ(filter->MemoryUsage(), BloomFilter::MemoryUsage(10));
+  ASSERT_EQ(budget->GetReserved(), filter->MemoryUsage());
+  executor.reset();
+  ASSERT_EQ(budget->GetReserved(), 0);
+
+  // without room in the budget, the join goes without a filter and joins the same rows
+  size_t limit = budget->GetLimit();
+  budget->SetLimit(0);
+  executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+  executor->Init();
+  ASSERT_EQ(dynamic_cast<HashJoinExecutor *>(executor.get())->GetRuntimeFilter(), nullptr);
+  result.clear();
+  while (executor->Next(&tuple, &rid)) {
+    result.push_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>());
+  }
+  std::sort(result.begin(), result.end());
+  ASSERT_EQ(result, expected);
+  executor.reset();
+  budget->SetLimit(limit);
+}
+
 // SELECT COUNT(col_a), SUM(col_a), min(col_a), max(col_a) from test_1;
 TEST_F(ExecutorTest, SimpleAggregationTest) {
   const Schema *scan_schema;
@@ -594,6 +787,104 @@ TEST_F(ExecutorTest, SimpleGroupByAggregation) {
   }
 }
 
+// SELECT colA, COUNT(colB), MIN(colB) FROM big_table GROUP BY colA and SELECT DISTINCT colA FROM big_table in 16KB
+TEST_F(ExecutorTest, SpillingAggregationTest) {
+  const int32_t num_tuples = 20000;
+  const int32_t num_keys = 5000;
+  Schema schema({Column{"colA", TypeId::INTEGER}, Column{"colB", TypeId::INTEGER}});
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->CreateTable(GetTxn(), "big_table", schema);
+  for (int32_t i = 0; i < num_tuples; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i % num_keys), ValueFactory::GetIntegerValue(i % 7)}, &schema);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *scan_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  SeqScanPlanNode scan{scan_schema, nullptr, table_info->oid_};
+  auto *agg_schema = MakeOutputSchema({{"colA", MakeAggregateValueExpression(true, 0)},
+                                       {"countB", MakeAggregateValueExpression(false, 0)},
+                                       {"minB", MakeAggregateValueExpression(false, 1)}});
+  auto *scan_b = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  AggregationPlanNode agg_plan{agg_schema,
+                               &scan,
+                               nullptr,
+                               {MakeColumnValueExpression(*scan_schema, 0, "colA")},
+                               {scan_b, scan_b},
+                               {AggregationType::CountAggregate, AggregationType::MinAggregate}};
+  auto *distinct_schema = MakeOutputSchema({{"colA", col_a}});
+  SeqScanPlanNode distinct_scan{distinct_schema, nullptr, table_info->oid_};
+  DistinctPlanNode distinct_plan{distinct_schema, &distinct_scan};
+
+  // a batch of groups already takes more than 16KB, so the groups of most batches spill, and spill again
+  for (const AbstractPlanNode *plan : std::vector<const AbstractPlanNode *>{&agg_plan, &distinct_plan}) {
+    auto run = [&](AbstractExecutor *executor) {
+      executor->Init();
+      std::vector<std::string> rows;
+      Tuple tuple;
+      RID rid;
+      while (executor->Next(&tuple, &rid)) {
+        rows.push_back(tuple.ToString(plan->OutputSchema()));
+      }
+      std::sort(rows.begin(), rows.end());
+      return rows;
+    };
+    std::vector<std::string> in_memory = run(ExecutorFactory::CreateExecutor(GetExecutorContext(), plan).get());
+    ASSERT_EQ(in_memory.size(), num_keys);
+
+    MemoryBudget *budget = GetExecutorContext()->GetMemoryBudget();
+    size_t limit = budget->GetLimit();
+    budget->SetLimit(16 * 1024);
+    {
+      auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), plan);
+      ASSERT_EQ(run(executor.get()), in_memory);
+      auto *aggregation = dynamic_cast<AggregationExecutor *>(executor.get());
+      auto *distinct = dynamic_cast<DistinctExecutor *>(executor.get());
+      ASSERT_GT(aggregation != nullptr ? aggregation->NumSpilledPartitions() : distinct->NumSpilledPartitions(), 0);
+      ASSERT_GT(aggregation != nullptr ? aggregation->GetSpilledBytes() : distinct->GetSpilledBytes(), 0);
+    }
+    budget->SetLimit(limit);
+    ASSERT_EQ(budget->GetReserved(), 0);
+  }
+
+  // Run in parallel, the tables of the copies reserve their memory too, and the rows that do not fit spill
+  MemoryBudget *budget = GetExecutorContext()->GetMemoryBudget();
+  size_t limit = budget->GetLimit();
+  auto run = [&](const AbstractPlanNode *plan, size_t parallelism) {
+    GetExecutorContext()->SetParallelism(parallelism);
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), plan);
+    executor->Init();
+    std::vector<std::string> rows;
+    Tuple tuple;
+    RID rid;
+    while (executor->Next(&tuple, &rid)) {
+      rows.push_back(tuple.ToString(agg_schema));
+    }
+    GetExecutorContext()->SetParallelism(1);
+    std::sort(rows.begin(), rows.end());
+    auto *aggregation = dynamic_cast<AggregationExecutor *>(executor.get());
+    return std::make_pair(rows, aggregation != nullptr ? aggregation->NumSpilledPartitions() : 0);
+  };
+  std::vector<std::string> in_memory = run(&agg_plan, 1).first;
+  {
+    // whatever the limit, the groups held are reserved from the budget until they are output
+    GetExecutorContext()->SetParallelism(4);
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &agg_plan);
+    executor->Init();
+    GetExecutorContext()->SetParallelism(1);
+    ASSERT_GT(budget->GetReserved(), 0);
+  }
+  ASSERT_EQ(budget->GetReserved(), 0);
+  budget->SetLimit(16 * 1024);
+  auto [own_threads, num_spilled] = run(&agg_plan, 4);
+  ASSERT_EQ(own_threads, in_memory);
+  ASSERT_GT(num_spilled, 0);
+  GatherPlanNode gather{agg_schema, &agg_plan, 4};
+  ASSERT_EQ(run(&gather, 1).first, in_memory);
+  budget->SetLimit(limit);
+  ASSERT_EQ(budget->GetReserved(), 0);
+}
+
 // SELECT colA, colB FROM test_3 LIMIT 10
 TEST_F(ExecutorTest, SimpleLimitTest) {
   auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_3");
@@ -622,6 +913,312 @@ TEST_F(ExecutorTest, SimpleLimitTest) {
   }
 }
 
+// SELECT colA, colB FROM test_1 WHERE colA >= 100 LIMIT 250, a batch at a time
+TEST_F(ExecutorTest, BatchLimitTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const100 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(100));
+  auto *predicate = MakeComparisonExpression(col_a, const100, ComparisonType::GreaterThanOrEqual);
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  SeqScanPlanNode scan_plan{out_schema, predicate, table_info->oid_};
+  LimitPlanNode limit_plan{out_schema, &scan_plan, 250};
+
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &limit_plan);
+  executor->Init();
+  TupleBatch batch(out_schema, 64);
+  std::vector<size_t> batch_sizes;
+  int32_t expected = 100;
+  while (executor->NextBatch(&batch)) {
+    batch_sizes.push_back(batch.Size());
+    // an INTEGER column is an array of int32_t
+    const auto *col_a_data = reinterpret_cast<const int32_t *>(batch.GetColumn(0).GetData());
+    for (size_t row = 0; row < batch.Size(); row++) {
+      ASSERT_EQ(col_a_data[row], expected++);
+      ASSERT_EQ(batch.GetValue(row, 0).GetAs<int32_t>(), col_a_data[row]);
+      ASSERT_LT(batch.GetValue(row, 1).GetAs<int32_t>(), 10);
+    }
+  }
+  // the scan filters whole batches of 64 tuples, so a batch holds the tuples of its input batch that pass
+  ASSERT_EQ(expected, 350);
+  ASSERT_EQ(batch_sizes, (std::vector<size_t>{28, 64, 64, 64, 30}));
+}
+
+// SELECT colA, colB FROM big_table WHERE colB = 0, on one thread and on four
+TEST_F(ExecutorTest, ParallelSeqScanTest) {
+  const int32_t num_tuples = 20000;
+  Schema schema({Column{"colA", TypeId::INTEGER}, Column{"colB", TypeId::INTEGER}});
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->CreateTable(GetTxn(), "big_table", schema);
+  for (int32_t i = 0; i < num_tuples; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i % 7)}, &schema);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const0 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(0));
+  auto *predicate = MakeComparisonExpression(col_b, const0, ComparisonType::Equal);
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+
+  auto scan = [&](size_t parallelism) {
+    GetExecutorContext()->SetParallelism(parallelism);
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+    GetExecutorContext()->SetParallelism(1);
+    std::vector<int32_t> keys;
+    for (const auto &tuple : result_set) {
+      keys.push_back(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>());
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+  };
+
+  // Verify: the workers together see every page exactly once
+  std::vector<int32_t> sequential = scan(1);
+  ASSERT_EQ(sequential.size(), (num_tuples + 6) / 7);
+  for (size_t i = 0; i < sequential.size(); i++) {
+    ASSERT_EQ(sequential[i], static_cast<int32_t>(i * 7));
+  }
+  ASSERT_EQ(scan(4), sequential);
+}
+
+// SELECT t1.colA, t1.colB, t2.colC FROM test_1 t1 JOIN test_1 t2 ON t1.colA = t2.colA, as 4 copies of a partitioned
+// hash join
+TEST_F(ExecutorTest, ParallelHashJoinTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *col_c = MakeColumnValueExpression(schema, 0, "colC");
+  auto *scan_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}, {"colC", col_c}});
+  SeqScanPlanNode left_scan{scan_schema, nullptr, table_info->oid_};
+  SeqScanPlanNode right_scan{scan_schema, nullptr, table_info->oid_};
+
+  auto *left_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *left_b = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  auto *right_a = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto *right_c = MakeColumnValueExpression(*scan_schema, 1, "colC");
+  auto *out_schema = MakeOutputSchema({{"colA", left_a}, {"colB", left_b}, {"colC", right_c}});
+  HashJoinPlanNode serial_join{
+      out_schema, std::vector<const AbstractPlanNode *>{&left_scan, &right_scan}, left_a, right_a};
+
+  // Both inputs are partitioned on the join key, so each copy of the join sees all the matches of its keys
+  ExchangePlanNode left_exchange{scan_schema, &left_scan, {left_a}};
+  ExchangePlanNode right_exchange{scan_schema, &right_scan, {MakeColumnValueExpression(*scan_schema, 0, "colA")}};
+  HashJoinPlanNode parallel_join{
+      out_schema, std::vector<const AbstractPlanNode *>{&left_exchange, &right_exchange}, left_a, right_a};
+  GatherPlanNode gather{out_schema, &parallel_join, 4};
+
+  auto run = [&](const AbstractPlanNode *plan) {
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::string> rows;
+    for (const auto &tuple : result_set) {
+      rows.push_back(tuple.ToString(out_schema));
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  std::vector<std::string> serial = run(&serial_join);
+  ASSERT_EQ(serial.size(), TEST1_SIZE);
+  ASSERT_EQ(run(&gather), serial);
+
+  // A DECIMAL key equals the INTEGER key of the same value, so the exchanges must route both to the same copy
+  Schema decimal_schema({Column{"colA", TypeId::DECIMAL}});
+  TableInfo *decimal_table = GetExecutorContext()->GetCatalog()->CreateTable(GetTxn(), "decimal_table", decimal_schema);
+  for (size_t i = 0; i < TEST1_SIZE; i++) {
+    Tuple tuple({ValueFactory::GetDecimalValue(static_cast<double>(i))}, &decimal_schema);
+    RID rid;
+    ASSERT_TRUE(decimal_table->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+  auto *decimal_a = MakeColumnValueExpression(decimal_schema, 0, "colA");
+  auto *decimal_scan_schema = MakeOutputSchema({{"colA", decimal_a}});
+  SeqScanPlanNode decimal_scan{decimal_scan_schema, nullptr, decimal_table->oid_};
+  ExchangePlanNode decimal_exchange{
+      decimal_scan_schema, &decimal_scan, {MakeColumnValueExpression(*decimal_scan_schema, 0, "colA")}};
+  auto *right_decimal_a = MakeColumnValueExpression(*decimal_scan_schema, 1, "colA");
+  auto *mixed_schema = MakeOutputSchema({{"colA", left_a}, {"decimalA", right_decimal_a}});
+  HashJoinPlanNode mixed_join{mixed_schema, std::vector<const AbstractPlanNode *>{&left_exchange, &decimal_exchange},
+                              left_a, right_decimal_a};
+  GatherPlanNode mixed_gather{mixed_schema, &mixed_join, 4};
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&mixed_gather, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), TEST1_SIZE);
+}
+
+// SELECT key, COUNT(colA), SUM(colC) FROM test_1 GROUP BY key, for key colB or colA, aggregated on 4 threads
+TEST_F(ExecutorTest, ParallelAggregationTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *col_c = MakeColumnValueExpression(schema, 0, "colC");
+  auto *scan_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}, {"colC", col_c}});
+  SeqScanPlanNode scan{scan_schema, nullptr, table_info->oid_};
+
+  auto *scan_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *scan_b = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  auto *scan_c = MakeColumnValueExpression(*scan_schema, 0, "colC");
+  auto *agg_schema = MakeOutputSchema({{"key", MakeAggregateValueExpression(true, 0)},
+                                       {"countA", MakeAggregateValueExpression(false, 0)},
+                                       {"sumC", MakeAggregateValueExpression(false, 1)}});
+  auto make_aggregation = [&](const AbstractPlanNode *child, const AbstractExpression *group_by) {
+    return std::make_unique<AggregationPlanNode>(
+        agg_schema, child, nullptr, std::vector<const AbstractExpression *>{group_by},
+        std::vector<const AbstractExpression *>{scan_a, scan_c},
+        std::vector<AggregationType>{AggregationType::CountAggregate, AggregationType::SumAggregate});
+  };
+
+  auto run = [&](const AbstractPlanNode *plan, size_t parallelism) {
+    GetExecutorContext()->SetParallelism(parallelism);
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    GetExecutorContext()->SetParallelism(1);
+    std::vector<std::string> rows;
+    for (const auto &tuple : result_set) {
+      rows.push_back(tuple.ToString(agg_schema));
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  // few groups on colB, and as many groups as rows on colA
+  for (const AbstractExpression *group_by : {scan_b, scan_a}) {
+    auto serial_agg = make_aggregation(&scan, group_by);
+    std::vector<std::string> serial = run(serial_agg.get(), 1);
+    ASSERT_EQ(serial.size(), group_by == scan_b ? 10 : TEST1_SIZE);
+
+    // The input is partitioned on the group by column, so each group is aggregated by one copy
+    ExchangePlanNode exchange{scan_schema, &scan, {group_by}};
+    auto exchange_agg = make_aggregation(&exchange, group_by);
+    GatherPlanNode exchange_gather{agg_schema, exchange_agg.get(), 4};
+    ASSERT_EQ(run(&exchange_gather, 1), serial);
+
+    // Each copy aggregates the pages of the scan it gets, and the copies merge their groups
+    GatherPlanNode gather{agg_schema, serial_agg.get(), 4};
+    ASSERT_EQ(run(&gather, 1), serial);
+
+    // The aggregation runs copies of the scan on threads of its own
+    ASSERT_EQ(run(serial_agg.get(), 4), serial);
+  }
+}
+
+// SELECT colA FROM test_1, pulled through a cursor and pushed into a sink
+TEST_F(ExecutorTest, StreamingResultTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}});
+  SeqScanPlanNode plan{out_schema, nullptr, table_info->oid_};
+
+  // Rows come out of the cursor one at a time, or as what is left of the current batch
+  auto cursor = GetExecutionEngine()->Open(&plan, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(cursor->GetOutputSchema(), out_schema);
+  Tuple tuple;
+  ASSERT_TRUE(cursor->Next(&tuple));
+  ASSERT_EQ(tuple.GetValue(out_schema, 0).GetAs<int32_t>(), 0);
+  const TupleBatch *batch = cursor->NextBatch();
+  ASSERT_NE(batch, nullptr);
+  ASSERT_EQ(batch->GetValue(0, 0).GetAs<int32_t>(), 1);
+  size_t num_rows = 1 + batch->Size();
+  while (cursor->Next(&tuple)) {
+    ASSERT_EQ(tuple.GetValue(out_schema, 0).GetAs<int32_t>(), static_cast<int32_t>(num_rows));
+    num_rows++;
+  }
+  ASSERT_EQ(num_rows, TEST1_SIZE);
+  ASSERT_EQ(cursor->NextBatch(), nullptr);
+  ASSERT_FALSE(cursor->IsAborted());
+
+  // A sink that returns false stops the query after the batch it was given
+  size_t num_batches = 0;
+  GetExecutionEngine()->Stream(
+      &plan,
+      [&](const TupleBatch & /* batch */) {
+        num_batches++;
+        return false;
+      },
+      GetTxn(), GetExecutorContext());
+  ASSERT_EQ(num_batches, 1);
+}
+
+/** Yields the first batch of its child, then fails the way an executor that runs out of buffer pool frames does. */
+class FailingExecutor : public AbstractExecutor {
+ public:
+  FailingExecutor(ExecutorContext *exec_ctx, std::unique_ptr<AbstractExecutor> &&child_executor)
+      : AbstractExecutor(exec_ctx), child_executor_(std::move(child_executor)) {}
+
+  void Init() override {
+    child_executor_->Init();
+    failed_ = false;
+  }
+
+  bool Next(Tuple *tuple, RID *rid) override { return NextFromBatch(tuple, rid); }
+
+  bool NextBatch(TupleBatch *batch) override {
+    if (failed_) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "No buffer pool frame left.");
+    }
+    failed_ = true;
+    return child_executor_->NextBatch(batch);
+  }
+
+  const Schema *GetOutputSchema() override { return child_executor_->GetOutputSchema(); }
+
+ private:
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  bool failed_{false};
+};
+
+// A query that fails part way through ends its result early and reports the failure
+TEST_F(ExecutorTest, FailingQueryTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto *col_a = MakeColumnValueExpression(table_info->schema_, 0, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}});
+  SeqScanPlanNode scan_plan{out_schema, nullptr, table_info->oid_};
+
+  // The rows before the failure are handed out; then the cursor ends with the exception of the executor
+  ResultCursor cursor(GetExecutorContext(),
+                      std::make_unique<FailingExecutor>(
+                          GetExecutorContext(), ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan)));
+  const TupleBatch *batch = cursor.NextBatch();
+  ASSERT_NE(batch, nullptr);
+  ASSERT_EQ(batch->GetValue(0, 0).GetAs<int32_t>(), 0);
+  ASSERT_EQ(cursor.GetError(), nullptr);
+  ASSERT_EQ(cursor.NextBatch(), nullptr);
+  ASSERT_NE(cursor.GetError(), nullptr);
+  ASSERT_EQ(cursor.GetError()->GetType(), ExceptionType::OUT_OF_MEMORY);
+  ASSERT_FALSE(cursor.IsAborted());
+  Tuple tuple;
+  ASSERT_FALSE(cursor.Next(&tuple));
+
+  // SELECT SUM(colA) FROM big_table, which overflows: Execute() fails
+  Schema schema({Column{"colA", TypeId::BIGINT}});
+  TableInfo *big_table = GetExecutorContext()->GetCatalog()->CreateTable(GetTxn(), "big_table", schema);
+  for (int i = 0; i < 3; i++) {
+    Tuple row({ValueFactory::GetBigIntValue(BUSTUB_INT64_MAX / 2)}, &schema);
+    RID rid;
+    ASSERT_TRUE(big_table->table_->InsertTuple(row, &rid, GetTxn()));
+  }
+  auto *big_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(schema, 0, "colA")}});
+  SeqScanPlanNode big_scan{big_schema, nullptr, big_table->oid_};
+  auto *sum_schema = MakeOutputSchema({{"sumA", MakeAggregateValueExpression(false, 0)}});
+  AggregationPlanNode sum_plan{sum_schema,
+                               &big_scan,
+                               nullptr,
+                               {},
+                               {MakeColumnValueExpression(*big_schema, 0, "colA")},
+                               {AggregationType::SumAggregate}};
+  std::vector<Tuple> result_set;
+  ASSERT_FALSE(GetExecutionEngine()->Execute(&sum_plan, &result_set, GetTxn(), GetExecutorContext()));
+  ASSERT_TRUE(result_set.empty());
+  ASSERT_TRUE(GetExecutionEngine()->Execute(&scan_plan, &result_set, GetTxn(), GetExecutorContext()));
+  ASSERT_EQ(result_set.size(), TEST1_SIZE);
+}
+
 // SELECT DISTINCT colC FROM test_7
 TEST_F(ExecutorTest, SimpleDistinctTest) {
   auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_7");
@@ -657,6 +1254,185 @@ TEST_F(ExecutorTest, SimpleDistinctTest) {
 
   ASSERT_TRUE(std::equal(results.cbegin(), results.cend(), expected.cbegin()));
 }
+
+// SELECT DISTINCT colB FROM test_1 LIMIT 3, and SELECT DISTINCT colA FROM big_table a batch at a time
+TEST_F(ExecutorTest, StreamingDistinctTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto *col_b = MakeColumnValueExpression(table_info->schema_, 0, "colB");
+  auto *out_schema = MakeOutputSchema({{"colB", col_b}});
+  SeqScanPlanNode scan_plan{out_schema, nullptr, table_info->oid_};
+  DistinctPlanNode distinct_plan{out_schema, &scan_plan};
+  LimitPlanNode limit_plan{out_schema, &distinct_plan, 3};
+
+  // Rows come out in the order their keys are first seen
+  std::vector<Tuple> scanned{};
+  GetExecutionEngine()->Execute(&scan_plan, &scanned, GetTxn(), GetExecutorContext());
+  std::vector<int32_t> expected;
+  for (const auto &tuple : scanned) {
+    int32_t value = tuple.GetValue(out_schema, 0).GetAs<int32_t>();
+    if (expected.size() < 3 && std::find(expected.begin(), expected.end(), value) == expected.end()) {
+      expected.push_back(value);
+    }
+  }
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&limit_plan, &result_set, GetTxn(), GetExecutorContext());
+  std::vector<int32_t> results;
+  for (const auto &tuple : result_set) {
+    results.push_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>());
+  }
+  ASSERT_EQ(results, expected);
+
+  // The distinct outputs the keys of each batch before it reads the next one, so its table grows as it is pulled
+  const int32_t num_tuples = 20000;
+  Schema schema({Column{"colA", TypeId::INTEGER}});
+  TableInfo *big_table = GetExecutorContext()->GetCatalog()->CreateTable(GetTxn(), "big_table", schema);
+  for (int32_t i = 0; i < num_tuples; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i / 2)}, &schema);
+    RID rid;
+    ASSERT_TRUE(big_table->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+  auto *big_schema = MakeOutputSchema({{"colA", MakeColumnValueExpression(schema, 0, "colA")}});
+  SeqScanPlanNode big_scan{big_schema, nullptr, big_table->oid_};
+  DistinctPlanNode big_distinct{big_schema, &big_scan};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &big_distinct);
+  executor->Init();
+  MemoryBudget *budget = GetExecutorContext()->GetMemoryBudget();
+  TupleBatch batch(big_schema);
+  int32_t next_value = 0;
+  std::vector<size_t> reserved;
+  while (executor->NextBatch(&batch)) {
+    for (size_t row = 0; row < batch.Size(); row++) {
+      ASSERT_EQ(batch.GetValue(row, 0).GetAs<int32_t>(), next_value++);
+    }
+    reserved.push_back(budget->GetReserved());
+  }
+  ASSERT_EQ(next_value, num_tuples / 2);
+  ASSERT_GT(reserved.size(), 2);
+  ASSERT_LT(reserved.front(), reserved[reserved.size() - 2]);
+}
+
+// SELECT colA, colB, colC, colD FROM sort_table ORDER BY ..., over keys of several types and directions
+TEST_F(ExecutorTest, SimpleSortTest) {
+  Schema schema({Column{"colA", TypeId::INTEGER}, Column{"colB", TypeId::DECIMAL}, Column{"colC", TypeId::VARCHAR, 8},
+                 Column{"colD", TypeId::INTEGER}});
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->CreateTable(GetTxn(), "sort_table", schema);
+  const std::vector<double> decimals{-1.5, -0.0, 0.0, 2.25, -1e10, 1e-3, 7};
+  const std::vector<std::string> strings{"", "a", "ab", "b", std::string("a\0b", 3), "B", "\xff"};
+  const int32_t num_tuples = 100;
+  for (int32_t i = 0; i < num_tuples; i++) {
+    Value col_a = i % 11 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                              : ValueFactory::GetIntegerValue((i * 37) % 23 - 11);
+    Tuple tuple({col_a, ValueFactory::GetDecimalValue(decimals[i % decimals.size()]),
+                 ValueFactory::GetVarcharValue(strings[(i / 3) % strings.size()]), ValueFactory::GetIntegerValue(i)},
+                &schema);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+  std::vector<const AbstractExpression *> columns;
+  std::vector<std::pair<std::string, const AbstractExpression *>> out_columns;
+  for (const auto &column : schema.GetColumns()) {
+    columns.push_back(MakeColumnValueExpression(schema, 0, column.GetName()));
+    out_columns.emplace_back(column.GetName(), columns.back());
+  }
+  auto *out_schema = MakeOutputSchema(out_columns);
+  SeqScanPlanNode scan_plan{out_schema, nullptr, table_info->oid_};
+
+  // -1, 0 or 1 as the first value orders before, with or after the second in ascending order, NULLs first
+  auto compare = [](const Value &left, const Value &right) {
+    if (left.IsNull() || right.IsNull()) {
+      return static_cast<int>(!left.IsNull()) - static_cast<int>(!right.IsNull());
+    }
+    if (left.CompareLessThan(right) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    return left.CompareGreaterThan(right) == CmpBool::CmpTrue ? 1 : 0;
+  };
+  const std::vector<std::vector<std::pair<uint32_t, OrderByType>>> sorts{
+      {{0, OrderByType::ASC}},  {{0, OrderByType::DESC}},
+      {{1, OrderByType::ASC}},  {{1, OrderByType::DESC}},
+      {{2, OrderByType::ASC}},  {{2, OrderByType::DESC}},
+      {{2, OrderByType::ASC}, {0, OrderByType::DESC}, {1, OrderByType::ASC}}};
+  for (const auto &sort : sorts) {
+    std::vector<std::pair<const AbstractExpression *, OrderByType>> order_bys;
+    for (const auto &[col_idx, order_by_type] : sort) {
+      order_bys.emplace_back(columns[col_idx], order_by_type);
+    }
+    SortPlanNode sort_plan{out_schema, &scan_plan, std::move(order_bys)};
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&sort_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), num_tuples);
+
+    // Each row orders after the one before it, or ties with it and comes after it in the table
+    for (size_t i = 1; i < result_set.size(); i++) {
+      int cmp = 0;
+      for (const auto &[col_idx, order_by_type] : sort) {
+        cmp = compare(result_set[i - 1].GetValue(out_schema, col_idx), result_set[i].GetValue(out_schema, col_idx));
+        cmp = order_by_type == OrderByType::DESC ? -cmp : cmp;
+        if (cmp != 0) {
+          break;
+        }
+      }
+      ASSERT_LE(cmp, 0);
+      if (cmp == 0) {
+        ASSERT_LT(result_set[i - 1].GetValue(out_schema, 3).GetAs<int32_t>(),
+                  result_set[i].GetValue(out_schema, 3).GetAs<int32_t>());
+      }
+    }
+  }
+}
+
+// SELECT colA, colB FROM big_table ORDER BY colB, colA DESC, within 16KB of memory
+TEST_F(ExecutorTest, ExternalSortTest) {
+  const int32_t num_tuples = 20000;
+  Schema schema({Column{"colA", TypeId::INTEGER}, Column{"colB", TypeId::INTEGER}});
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->CreateTable(GetTxn(), "big_table", schema);
+  for (int32_t i = 0; i < num_tuples; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue((i * 7919) % num_tuples), ValueFactory::GetIntegerValue(i % 7)},
+                &schema);
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  SeqScanPlanNode scan_plan{out_schema, nullptr, table_info->oid_};
+  SortPlanNode sort_plan{out_schema, &scan_plan, {{col_b, OrderByType::ASC}, {col_a, OrderByType::DESC}}};
+
+  std::vector<std::pair<int32_t, int32_t>> expected;
+  for (int32_t i = 0; i < num_tuples; i++) {
+    expected.emplace_back(i % 7, -((i * 7919) % num_tuples));
+  }
+  std::sort(expected.begin(), expected.end());
+
+  // Every batch of the scan outgrows the budget, so that there are more runs than fit into one merge
+  MemoryBudget *budget = GetExecutorContext()->GetMemoryBudget();
+  size_t limit = budget->GetLimit();
+  for (size_t budget_limit : {limit, static_cast<size_t>(16 * 1024)}) {
+    budget->SetLimit(budget_limit);
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &sort_plan);
+    executor->Init();
+    TupleBatch batch(out_schema);
+    size_t next = 0;
+    while (executor->NextBatch(&batch)) {
+      for (size_t row = 0; row < batch.Size(); row++, next++) {
+        ASSERT_EQ(batch.GetValue(row, 1).GetAs<int32_t>(), expected[next].first);
+        ASSERT_EQ(batch.GetValue(row, 0).GetAs<int32_t>(), -expected[next].second);
+      }
+    }
+    ASSERT_EQ(next, num_tuples);
+    auto *sort = dynamic_cast<SortExecutor *>(executor.get());
+    if (budget_limit == limit) {
+      ASSERT_EQ(sort->NumRuns(), 0);
+    } else {
+      ASSERT_GT(sort->NumMergePasses(), 0);
+      ASSERT_GT(sort->NumRuns(), num_tuples / BATCH_SIZE);
+      ASSERT_GT(sort->GetSpilledBytes(), 0);
+    }
+    ASSERT_EQ(budget->GetReserved(), 0);
+  }
+  budget->SetLimit(limit);
+}
+
 TEST_F(ExecutorTest, DeleteEntireTable) {
   // Construct a sequential scan of the table
   const Schema *out_schema{};
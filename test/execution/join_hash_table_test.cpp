@@ -0,0 +1,193 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table_test.cpp
+//
+// Identification: test/execution/join_hash_table_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "execution/join_hash_table.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+std::vector<char> MakeKey(const std::vector<Value> &values) {
+  std::vector<char> key;
+  for (const Value &value : values) {
+    EXPECT_TRUE(JoinHashTable::SerializeKeyColumn(value, &key));
+  }
+  return key;
+}
+
+std::vector<uint32_t> FindRows(const JoinHashTable &table, const std::vector<Value> &values) {
+  std::vector<char> key = MakeKey(values);
+  std::vector<uint32_t> rows;
+  auto *entry = table.Find(key.data(), key.size(), JoinHashTable::HashKey(key.data(), key.size()));
+  for (; entry != nullptr; entry = entry->next_) {
+    rows.push_back(entry->row_);
+  }
+  return rows;
+}
+
+}  // namespace
+
+TEST(JoinHashTableTest, KeyTypesTest) {
+  JoinHashTable table;
+  std::vector<std::vector<Value>> keys = {
+      {ValueFactory::GetIntegerValue(7)},
+      {ValueFactory::GetVarcharValue("seven")},
+      {ValueFactory::GetIntegerValue(7), ValueFactory::GetVarcharValue("seven")},
+      {ValueFactory::GetVarcharValue("seven"), ValueFactory::GetIntegerValue(7)},
+      {ValueFactory::GetDecimalValue(7.5)},
+      {ValueFactory::GetBigIntValue(int64_t{1} << 40)},
+  };
+  for (uint32_t i = 0; i < keys.size(); i++) {
+    std::vector<char> key = MakeKey(keys[i]);
+    table.Insert(key.data(), key.size(), JoinHashTable::HashKey(key.data(), key.size()), 0, i);
+  }
+  ASSERT_EQ(table.NumKeys(), keys.size());
+  for (uint32_t i = 0; i < keys.size(); i++) {
+    ASSERT_EQ(FindRows(table, keys[i]), std::vector<uint32_t>{i});
+  }
+
+  // numeric keys match across types by value, other keys only by value
+  ASSERT_EQ(FindRows(table, {ValueFactory::GetBigIntValue(7)}), std::vector<uint32_t>{0});
+  ASSERT_EQ(FindRows(table, {ValueFactory::GetSmallIntValue(7)}), std::vector<uint32_t>{0});
+  ASSERT_EQ(FindRows(table, {ValueFactory::GetDecimalValue(7.0)}), std::vector<uint32_t>{0});
+  ASSERT_EQ(FindRows(table, {ValueFactory::GetDecimalValue(1099511627776.0)}), std::vector<uint32_t>{5});
+  ASSERT_TRUE(FindRows(table, {ValueFactory::GetDecimalValue(7.25)}).empty());
+  double fraction = 7.5;
+  int64_t fraction_bits;
+  memcpy(&fraction_bits, &fraction, sizeof(fraction_bits));
+  ASSERT_TRUE(FindRows(table, {ValueFactory::GetBigIntValue(fraction_bits)}).empty());
+  ASSERT_TRUE(FindRows(table, {ValueFactory::GetIntegerValue(8)}).empty());
+  ASSERT_TRUE(FindRows(table, {ValueFactory::GetVarcharValue("seve")}).empty());
+  ASSERT_TRUE(FindRows(table, {ValueFactory::GetIntegerValue(1 << 20)}).empty());
+
+  // NULL keys are never stored or found
+  std::vector<char> key;
+  ASSERT_FALSE(JoinHashTable::SerializeKeyColumn(ValueFactory::GetNullValueByType(TypeId::INTEGER), &key));
+}
+
+TEST(JoinHashTableTest, DuplicatesAndGrowthTest) {
+  const uint32_t num_keys = 10000;
+  const uint32_t num_duplicates = 3;
+  JoinHashTable table;
+  for (uint32_t dup = 0; dup < num_duplicates; dup++) {
+    for (uint32_t i = 0; i < num_keys; i++) {
+      std::vector<char> key = MakeKey({ValueFactory::GetIntegerValue(static_cast<int32_t>(i))});
+      table.Insert(key.data(), key.size(), JoinHashTable::HashKey(key.data(), key.size()), dup, i);
+    }
+  }
+  ASSERT_EQ(table.NumKeys(), num_keys);
+  ASSERT_EQ(table.NumRows(), num_keys * num_duplicates);
+
+  for (uint32_t i = 0; i < num_keys; i++) {
+    std::vector<char> key = MakeKey({ValueFactory::GetIntegerValue(static_cast<int32_t>(i))});
+    // rows with the same key come back in the order they were added
+    uint32_t dup = 0;
+    auto *entry = table.Find(key.data(), key.size(), JoinHashTable::HashKey(key.data(), key.size()));
+    for (; entry != nullptr; entry = entry->next_) {
+      ASSERT_EQ(entry->batch_idx_, dup++);
+      ASSERT_EQ(entry->row_, i);
+    }
+    ASSERT_EQ(dup, num_duplicates);
+  }
+
+  table.Clear();
+  ASSERT_EQ(table.NumKeys(), 0);
+  ASSERT_TRUE(FindRows(table, {ValueFactory::GetIntegerValue(1)}).empty());
+}
+
+// Measures building and probing against the unordered_map the hash join used before. Only runs with
+// --gtest_also_run_disabled_tests; the rates are recorded as properties of the test in the --gtest_output report.
+TEST(JoinHashTableTest, DISABLED_ProbeBenchmark) {
+  const int num_keys = 100000;
+  const int num_probes = 1000000;
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<int32_t> dist(0, 4 * num_keys);
+  std::vector<Value> build_keys;
+  for (int i = 0; i < num_keys; i++) {
+    build_keys.push_back(ValueFactory::GetIntegerValue(dist(gen)));
+  }
+  std::vector<Value> probes;
+  for (int i = 0; i < num_probes; i++) {
+    probes.push_back(ValueFactory::GetIntegerValue(dist(gen)));
+  }
+
+  // the map the hash join used before, keyed on the key as an int32_t
+  auto start = std::chrono::steady_clock::now();
+  std::unordered_map<int32_t, std::vector<std::pair<uint32_t, uint32_t>>> map;
+  for (uint32_t i = 0; i < build_keys.size(); i++) {
+    map[build_keys[i].GetAs<int32_t>()].emplace_back(0, i);
+  }
+  std::chrono::duration<double> map_build = std::chrono::steady_clock::now() - start;
+  size_t map_matches = 0;
+  start = std::chrono::steady_clock::now();
+  for (const Value &probe : probes) {
+    auto iter = map.find(probe.GetAs<int32_t>());
+    if (iter != map.end()) {
+      map_matches += iter->second.size();
+    }
+  }
+  std::chrono::duration<double> map_probe = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  JoinHashTable table;
+  std::vector<char> key;
+  for (uint32_t i = 0; i < build_keys.size(); i++) {
+    key.clear();
+    JoinHashTable::SerializeKeyColumn(build_keys[i], &key);
+    table.Insert(key.data(), key.size(), JoinHashTable::HashKey(key.data(), key.size()), 0, i);
+  }
+  std::chrono::duration<double> table_build = std::chrono::steady_clock::now() - start;
+
+  // probe a batch at a time, as the hash join does: serialize and hash the keys, prefetch, then look them up
+  size_t table_matches = 0;
+  std::vector<char> keys;
+  std::vector<size_t> offsets;
+  std::vector<hash_t> hashes;
+  start = std::chrono::steady_clock::now();
+  for (size_t begin = 0; begin < probes.size(); begin += static_cast<size_t>(BATCH_SIZE)) {
+    size_t end = std::min(probes.size(), begin + static_cast<size_t>(BATCH_SIZE));
+    keys.clear();
+    offsets.assign(1, 0);
+    hashes.clear();
+    for (size_t i = begin; i < end; i++) {
+      JoinHashTable::SerializeKeyColumn(probes[i], &keys);
+      offsets.push_back(keys.size());
+      hashes.push_back(JoinHashTable::HashKey(keys.data() + offsets[i - begin], keys.size() - offsets[i - begin]));
+      table.Prefetch(hashes.back());
+    }
+    for (size_t i = 0; i < end - begin; i++) {
+      auto *entry = table.Find(keys.data() + offsets[i], offsets[i + 1] - offsets[i], hashes[i]);
+      for (; entry != nullptr; entry = entry->next_) {
+        table_matches++;
+      }
+    }
+  }
+  std::chrono::duration<double> table_probe = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(map_matches, table_matches);
+  RecordProperty("table_build_k_rows_per_second", static_cast<int>(num_keys / 1e3 / table_build.count()));
+  RecordProperty("map_build_k_rows_per_second", static_cast<int>(num_keys / 1e3 / map_build.count()));
+  RecordProperty("table_probe_k_probes_per_second", static_cast<int>(num_probes / 1e3 / table_probe.count()));
+  RecordProperty("map_probe_k_probes_per_second", static_cast<int>(num_probes / 1e3 / map_probe.count()));
+}
+
+}  // namespace bustub
@@ -19,11 +19,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
-  // There are many ways to do this assignment, and this is only one of them.
-  // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
-  // You will get full credit as long as you are correctly using a linear probe hash table.
-
+TEST(TmpTuplePageTest, BasicTest) {
   TmpTuplePage page{};
   page_id_t page_id = 15445;
   page.Init(page_id, PAGE_SIZE);
@@ -46,6 +42,22 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), PAGE_SIZE - 8);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 8), 4);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 4), 123);
+  ASSERT_EQ(tmp_tuple.GetPageId(), page_id);
+  ASSERT_EQ(tmp_tuple.GetOffset(), PAGE_SIZE - 8);
+
+  // fill the page, then read the tuples back, newest first
+  int32_t inserted = 1;
+  while (page.Insert(Tuple({ValueFactory::GetIntegerValue(inserted)}, &schema), &tmp_tuple)) {
+    inserted++;
+  }
+  ASSERT_EQ(inserted, (PAGE_SIZE - 12) / 8);
+  Tuple read;
+  size_t offset = page.GetFreeSpacePointer();
+  for (int32_t i = inserted - 1; i >= 0; i--) {
+    offset = page.Get(offset, &read);
+    ASSERT_EQ(read.GetValue(&schema, 0).GetAs<int32_t>(), i == 0 ? 123 : i);
+  }
+  ASSERT_EQ(offset, PAGE_SIZE);
 }
 
 }  // namespace bustub
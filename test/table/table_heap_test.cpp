@@ -0,0 +1,293 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test.cpp
+//
+// Identification: test/table/table_heap_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/lock_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/async_disk_manager.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+Schema MakeScanSchema() {
+  Column col1{"id", TypeId::INTEGER};
+  Column col2{"payload", TypeId::VARCHAR, 1000};
+  return Schema({col1, col2});
+}
+
+/** Fill a new table heap with num_tuples tuples of roughly a quarter page each. */
+std::unique_ptr<TableHeap> BuildTable(BufferPoolManager *bpm, const Schema &schema, int num_tuples) {
+  Transaction txn(0);
+  auto table = std::make_unique<TableHeap>(bpm, nullptr, nullptr, &txn);
+  const std::string payload(900, 'x');
+  for (int i = 0; i < num_tuples; ++i) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(payload)}, &schema);
+    RID rid;
+    EXPECT_TRUE(table->InsertTuple(tuple, &rid, &txn));
+  }
+  return table;
+}
+
+/** Make the first page of a table record no free space map, as if it was written before the map existed. */
+void ForgetFreeSpaceMap(BufferPoolManager *bpm, page_id_t first_page_id) {
+  auto *first_page = static_cast<TablePage *>(bpm->FetchPage(first_page_id));
+  ASSERT_NE(nullptr, first_page);
+  first_page->SetFreeSpaceMapPageId(INVALID_PAGE_ID);
+  bpm->UnpinPage(first_page_id, true);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+// A scan over more pages than fit in the pool sees every tuple, in insertion order, with read-ahead going on
+TEST(TableHeapTest, ReadAheadScanTest) {
+  remove("test.db");
+  const int num_tuples = 400;
+  Schema schema = MakeScanSchema();
+  auto *disk_manager = new AsyncDiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(16, disk_manager);
+  auto table = BuildTable(bpm, schema, num_tuples);
+
+  for (int round = 0; round < 2; ++round) {
+    Transaction txn(0);
+    int expected = 0;
+    for (auto iter = table->Begin(&txn); iter != table->End(); ++iter) {
+      EXPECT_EQ(expected, iter->GetValue(&schema, 0).GetAs<int32_t>());
+      ++expected;
+    }
+    EXPECT_EQ(num_tuples, expected);
+  }
+
+  table.reset();
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+// The iterator skips empty pages and deleted tuples, and tuples copied from it outlive the page it was on
+TEST(TableHeapTest, IteratorTest) {
+  remove("test.db");
+  Schema schema = MakeScanSchema();
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(16, disk_manager);
+  LockManager lock_manager;
+  auto table = BuildTable(bpm, schema, 40);
+  TableHeap deleting_table(bpm, &lock_manager, nullptr, table->GetFirstPageId());
+
+  // empty the second page, and delete every other tuple of the rest; unlocking does not end the growing phase
+  Transaction txn(1, IsolationLevel::READ_COMMITTED);
+  std::vector<Tuple> copies;
+  for (auto iter = table->Begin(&txn); iter != table->End(); ++iter) {
+    int32_t id = iter->GetValue(&schema, 0).GetAs<int32_t>();
+    if ((id >= 4 && id < 8) || id % 2 == 0) {
+      ASSERT_TRUE(lock_manager.LockExclusive(&txn, iter->GetRid()));
+      ASSERT_TRUE(deleting_table.MarkDelete(iter->GetRid(), &txn));
+      deleting_table.ApplyDelete(iter->GetRid(), &txn);
+    } else {
+      copies.push_back(*iter);
+    }
+  }
+
+  Transaction scan_txn(2);
+  auto copy = copies.begin();
+  for (auto iter = table->Begin(&scan_txn); iter != table->End(); iter++) {
+    ASSERT_NE(copy, copies.end());
+    EXPECT_EQ(copy->GetRid(), iter->GetRid());
+    EXPECT_EQ(copy->GetValue(&schema, 0).GetAs<int32_t>(), iter->GetValue(&schema, 0).GetAs<int32_t>());
+    ++copy;
+  }
+  EXPECT_EQ(copy, copies.end());
+
+  table.reset();
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+// Measures full scan throughput with synchronous reads against asynchronous read-ahead. Only runs with
+// --gtest_also_run_disabled_tests; the rates are recorded as properties of the test in the --gtest_output report.
+TEST(TableHeapTest, DISABLED_ScanBenchmark) {
+  const int num_tuples = 1024;
+  const size_t buffer_pool_size = 64;
+  Schema schema = MakeScanSchema();
+
+  auto run = [&](DiskManager *disk_manager) {
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+    auto table = BuildTable(bpm, schema, num_tuples);
+    bpm->FlushAllPages();
+
+    Transaction txn(0);
+    int num_seen = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (auto iter = table->Begin(&txn); iter != table->End(); ++iter) {
+      ++num_seen;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(num_tuples, num_seen);
+    table.reset();
+    delete bpm;
+    // every tuple takes about a quarter of a page
+    return num_tuples / 4.0 * PAGE_SIZE / 1024 / elapsed.count();
+  };
+
+  remove("test.db");
+  auto *sync_disk_manager = new DiskManager("test.db", true);
+  double sync_rate = run(sync_disk_manager);
+  sync_disk_manager->ShutDown();
+  delete sync_disk_manager;
+  remove("test.db");
+
+  auto *async_disk_manager = new AsyncDiskManager("test.db", true);
+  double async_rate = run(async_disk_manager);
+  async_disk_manager->ShutDown();
+  delete async_disk_manager;
+  remove("test.db");
+  remove("test.log");
+
+  RecordProperty("synchronous_kb_per_second", static_cast<int>(sync_rate));
+  RecordProperty("read_ahead_kb_per_second", static_cast<int>(async_rate));
+}
+
+// NOLINTNEXTLINE
+// Inserts reuse the space that deletes free up in earlier pages, also after the table is reopened
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  remove("test.db");
+  Schema schema = MakeScanSchema();
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(16, disk_manager);
+  LockManager lock_manager;
+  // four tuples fill a page
+  auto table = BuildTable(bpm, schema, 40);
+  const std::string payload(900, 'x');
+  Tuple tuple({ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue(payload)}, &schema);
+
+  // empty the first page
+  Transaction txn(1);
+  for (uint32_t slot = 0; slot < 4; slot++) {
+    RID rid(table->GetFirstPageId(), slot);
+    ASSERT_TRUE(lock_manager.LockExclusive(&txn, rid));
+    ASSERT_TRUE(table->MarkDelete(rid, &txn));
+  }
+  TableHeap deleting_table(bpm, &lock_manager, nullptr, table->GetFirstPageId());
+  for (uint32_t slot = 0; slot < 3; slot++) {
+    deleting_table.ApplyDelete(RID(table->GetFirstPageId(), slot), &txn);
+  }
+
+  RID rid;
+  ASSERT_TRUE(deleting_table.InsertTuple(tuple, &rid, &txn));
+  EXPECT_EQ(table->GetFirstPageId(), rid.GetPageId());
+
+  // a reopened table finds the remaining space through the persistent map, or by rebuilding it
+  TableHeap reopened_table(bpm, &lock_manager, nullptr, table->GetFirstPageId());
+  EXPECT_EQ(table->GetFreeSpaceMapPageId(), reopened_table.GetFreeSpaceMapPageId());
+  ASSERT_TRUE(reopened_table.InsertTuple(tuple, &rid, &txn));
+  EXPECT_EQ(table->GetFirstPageId(), rid.GetPageId());
+  ForgetFreeSpaceMap(bpm, table->GetFirstPageId());
+  TableHeap rebuilt_table(bpm, &lock_manager, nullptr, table->GetFirstPageId());
+  EXPECT_NE(table->GetFreeSpaceMapPageId(), rebuilt_table.GetFreeSpaceMapPageId());
+  ASSERT_TRUE(rebuilt_table.InsertTuple(tuple, &rid, &txn));
+  EXPECT_EQ(table->GetFirstPageId(), rid.GetPageId());
+  // the rebuilt map is the one the next reopen finds
+  TableHeap rereopened_table(bpm, &lock_manager, nullptr, table->GetFirstPageId());
+  EXPECT_EQ(rebuilt_table.GetFreeSpaceMapPageId(), rereopened_table.GetFreeSpaceMapPageId());
+  // now the first page is full again
+  ASSERT_TRUE(rebuilt_table.InsertTuple(tuple, &rid, &txn));
+  EXPECT_NE(table->GetFirstPageId(), rid.GetPageId());
+
+  table.reset();
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+// The page directory lists the pages in list order, also after the table is reopened
+TEST(TableHeapTest, PageDirectoryTest) {
+  remove("test.db");
+  Schema schema = MakeScanSchema();
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(16, disk_manager);
+  auto table = BuildTable(bpm, schema, 40);
+
+  std::vector<page_id_t> expected;
+  Transaction txn(0);
+  for (auto iter = table->Begin(&txn); iter != table->End(); ++iter) {
+    if (expected.empty() || expected.back() != iter->GetRid().GetPageId()) {
+      expected.push_back(iter->GetRid().GetPageId());
+    }
+  }
+  // four tuples fill a page
+  EXPECT_EQ(10, expected.size());
+  EXPECT_EQ(expected, table->GetPageDirectory());
+  TableHeap reopened_table(bpm, nullptr, nullptr, table->GetFirstPageId());
+  EXPECT_EQ(expected, reopened_table.GetPageDirectory());
+  ForgetFreeSpaceMap(bpm, table->GetFirstPageId());
+  TableHeap rebuilt_table(bpm, nullptr, nullptr, table->GetFirstPageId());
+  EXPECT_EQ(expected, rebuilt_table.GetPageDirectory());
+
+  table.reset();
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+// Measures the cost per row of bulk inserts as the table grows, which should stay flat. Only runs with
+// --gtest_also_run_disabled_tests; the costs are recorded as properties of the test in the --gtest_output report.
+TEST(TableHeapTest, DISABLED_BulkInsertBenchmark) {
+  remove("test.db");
+  const int num_batches = 8;
+  const int batch_size = 25000;
+  Column col1{"id", TypeId::INTEGER};
+  Column col2{"payload", TypeId::VARCHAR, 100};
+  Schema schema({col1, col2});
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  Transaction txn(0);
+  auto table = std::make_unique<TableHeap>(bpm, nullptr, nullptr, &txn);
+  const std::string payload(80, 'x');
+
+  for (int batch = 0; batch < num_batches; batch++) {
+    Transaction batch_txn(0);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < batch_size; ++i) {
+      Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(payload)}, &schema);
+      RID rid;
+      ASSERT_TRUE(table->InsertTuple(tuple, &rid, &batch_txn));
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    RecordProperty("batch_" + std::to_string(batch) + "_ns_per_row", static_cast<int>(elapsed.count() / batch_size));
+  }
+
+  table.reset();
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub